@@ -0,0 +1,127 @@
+"""
+Heap soak test of the ESP controller's JSON endpoints.
+
+Reads GET /api/status, sends a steady mix of JSON requests:
+
+- POST /api/batch with one range per grid cell in random colors (a full
+  board in one request)
+- POST /api/led with one random cell
+- POST /api/effect with a pulse on one random cell
+
+then waits for the closed connections to be freed and reads /api/status
+again. Free heap and the largest free block are reported before, at their
+lowest during the run and after; with the fixed body buffer and document
+they should come back to where they started.
+
+    python esp_controller/scripts/heap_soak.py [host] [--requests N]
+
+The host defaults to the access point address, 192.168.4.1.
+"""
+
+import argparse
+import http.client
+import json
+import random
+import sys
+import time
+
+GRID_SIZE = 6
+LEDS_PER_CELL = 2
+NUM_CELLS = GRID_SIZE * GRID_SIZE
+
+# Free heap may differ by a few bytes from one reading to the next (WiFi
+# buffers); a larger loss is reported as a leak
+TOLERANCE = 256
+
+
+def request(host, port, method, path, body=None):
+    connection = http.client.HTTPConnection(host, port, timeout=10)
+    try:
+        headers = {"Content-Type": "application/json"} if body is not None else {}
+        connection.request(method, path, body, headers)
+        response = connection.getresponse()
+        reply = response.read()
+        if response.status != 200:
+            raise RuntimeError("%s: HTTP %d %s" % (path, response.status, reply.decode(errors="replace")))
+        return reply
+    finally:
+        connection.close()
+
+
+def status(host, port):
+    return json.loads(request(host, port, "GET", "/api/status"))
+
+
+def random_color():
+    return {"r": random.randrange(256), "g": random.randrange(256), "b": random.randrange(256)}
+
+
+def cell_range(cell):
+    start = cell * LEDS_PER_CELL
+    return {"start": start, "end": start + LEDS_PER_CELL - 1, "color": random_color()}
+
+
+def send_batch(host, port):
+    ops = [cell_range(cell) for cell in range(NUM_CELLS)]
+    reply = json.loads(request(host, port, "POST", "/api/batch", json.dumps(ops)))
+    if reply.get("applied") != NUM_CELLS:
+        raise RuntimeError("/api/batch: applied %r of %d ranges" % (reply.get("applied"), NUM_CELLS))
+
+
+def send_led(host, port):
+    request(host, port, "POST", "/api/led", json.dumps(cell_range(random.randrange(NUM_CELLS))))
+
+
+def send_effect(host, port):
+    command = {"row": random.randrange(GRID_SIZE), "col": random.randrange(GRID_SIZE),
+               "effect": "pulse", "color": random_color(), "param": 1}
+    request(host, port, "POST", "/api/effect", json.dumps(command))
+
+
+def report(name, reading):
+    print("  %-8s %7d bytes free %7d bytes largest block %4d%% fragmented"
+          % (name, reading["freeHeap"], reading["maxFreeBlock"], reading["fragmentation"]))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.strip().splitlines()[0])
+    parser.add_argument("host", nargs="?", default="192.168.4.1")
+    parser.add_argument("--port", type=int, default=80)
+    parser.add_argument("--requests", type=int, default=3000)
+    parser.add_argument("--settle", type=float, default=5.0,
+                        help="seconds to wait for closed connections to be freed")
+    args = parser.parse_args()
+
+    senders = [send_batch, send_led, send_effect]
+
+    before = status(args.host, args.port)
+    lowest = dict(before)
+    start = time.perf_counter()
+    for i in range(args.requests):
+        senders[i % len(senders)](args.host, args.port)
+        if (i + 1) % 100 == 0:
+            reading = status(args.host, args.port)
+            lowest["freeHeap"] = min(lowest["freeHeap"], reading["freeHeap"])
+            lowest["maxFreeBlock"] = min(lowest["maxFreeBlock"], reading["maxFreeBlock"])
+            lowest["fragmentation"] = max(lowest["fragmentation"], reading["fragmentation"])
+    elapsed = time.perf_counter() - start
+
+    time.sleep(args.settle)
+    after = status(args.host, args.port)
+
+    print("%d requests in %.1f s (%.0f per second):" % (args.requests, elapsed, args.requests / elapsed))
+    report("before", before)
+    report("lowest", lowest)
+    report("after", after)
+
+    lost = before["freeHeap"] - after["freeHeap"]
+    shrunk = before["maxFreeBlock"] - after["maxFreeBlock"]
+    if lost > TOLERANCE or shrunk > TOLERANCE:
+        print("heap not recovered: %d bytes lost, largest block %d bytes smaller" % (lost, shrunk))
+        return 1
+    print("heap recovered")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
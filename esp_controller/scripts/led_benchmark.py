@@ -0,0 +1,147 @@
+"""
+LED update cost on the ESP controller: the JSON range API against the
+binary endpoints.
+
+Two kinds of update, each timed and counted in bytes sent (request line,
+headers and body):
+
+- a full-board redraw with random colors: 36 POST /api/led requests, one
+  JSON range per cell of GRID_TO_LED_MAPPING (the way the web application
+  used to do it), against one POST /api/frame with the 216 bytes of RGB
+- a typical change of one or two cells: one POST /api/led per changed
+  cell, against one POST /api/delta carrying the changed runs with a
+  sequence number
+
+    python esp_controller/scripts/led_benchmark.py [host] [--rounds N]
+
+The host defaults to the access point address, 192.168.4.1. Requests are
+sent one after the other, as the ESP8266 web server handles one client at
+a time.
+"""
+
+import argparse
+import http.client
+import json
+import random
+import statistics
+import struct
+import time
+
+GRID_SIZE = 6
+LEDS_PER_CELL = 2
+NUM_CELLS = GRID_SIZE * GRID_SIZE
+NUM_LEDS = NUM_CELLS * LEDS_PER_CELL
+
+
+class CountingConnection(http.client.HTTPConnection):
+    """An HTTP connection that counts the bytes it sends."""
+
+    sent = 0
+
+    def send(self, data):
+        CountingConnection.sent += len(data)
+        super().send(data)
+
+
+def post(host, port, path, body, content_type):
+    connection = CountingConnection(host, port, timeout=10)
+    try:
+        connection.request("POST", path, body, {"Content-Type": content_type})
+        response = connection.getresponse()
+        reply = response.read()
+        if response.status != 200:
+            raise RuntimeError("%s: HTTP %d" % (path, response.status))
+        return reply
+    finally:
+        connection.close()
+
+
+def random_color():
+    return (random.randrange(256), random.randrange(256), random.randrange(256))
+
+
+def post_range(host, port, cell, color):
+    start = cell * LEDS_PER_CELL
+    body = json.dumps({"start": start, "end": start + LEDS_PER_CELL - 1,
+                       "color": {"r": color[0], "g": color[1], "b": color[2]}})
+    post(host, port, "/api/led", body, "application/json")
+
+
+class Client:
+    """Sends one kind of update and keeps the sequence of /api/delta."""
+
+    def __init__(self, host, port):
+        self.host = host
+        self.port = port
+        self.sequence = 0
+
+    def board_by_ranges(self, board):
+        for cell, color in enumerate(board):
+            post_range(self.host, self.port, cell, color)
+
+    def board_by_frame(self, board):
+        frame = bytearray()
+        for color in board:
+            frame += bytes(color) * LEDS_PER_CELL
+        post(self.host, self.port, "/api/frame", bytes(frame), "application/octet-stream")
+
+    def cells_by_ranges(self, changes):
+        for cell, color in changes:
+            post_range(self.host, self.port, cell, color)
+
+    def cells_by_delta(self, changes):
+        self.sequence = (self.sequence + 1) & 0xFFFF
+        body = struct.pack("<H", self.sequence)
+        for cell, color in changes:
+            body += bytes([cell * LEDS_PER_CELL, LEDS_PER_CELL]) + bytes(color)
+        reply = json.loads(post(self.host, self.port, "/api/delta", body, "application/octet-stream"))
+        if reply.get("resync"):
+            raise RuntimeError("/api/delta: updates were lost")
+
+
+def measure(update, make_update, rounds):
+    times = []
+    CountingConnection.sent = 0
+    for _ in range(rounds):
+        data = make_update()
+        start = time.perf_counter()
+        update(data)
+        times.append((time.perf_counter() - start) * 1000)
+    return times, CountingConnection.sent / rounds
+
+
+def report(name, result):
+    times, sent = result
+    print("  %-16s %7.0f bytes %8.1f ms avg %8.1f ms median %8.1f ms max"
+          % (name, sent, statistics.mean(times), statistics.median(times), max(times)))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.strip().splitlines()[0])
+    parser.add_argument("host", nargs="?", default="192.168.4.1")
+    parser.add_argument("--port", type=int, default=80)
+    parser.add_argument("--rounds", type=int, default=20)
+    args = parser.parse_args()
+
+    client = Client(args.host, args.port)
+
+    def random_board():
+        return [random_color() for _ in range(NUM_CELLS)]
+
+    print("full-board redraw of %d LEDs, %d rounds:" % (NUM_LEDS, args.rounds))
+    ranges = measure(client.board_by_ranges, random_board, args.rounds)
+    frames = measure(client.board_by_frame, random_board, args.rounds)
+    report("36 x /api/led", ranges)
+    report("1 x /api/frame", frames)
+
+    for count in (1, 2):
+        def random_changes():
+            return [(cell, random_color()) for cell in random.sample(range(NUM_CELLS), count)]
+
+        print("%d changed cell%s, %d rounds:" % (count, "s" if count > 1 else "", args.rounds))
+        report("%d x /api/led" % count, measure(client.cells_by_ranges, random_changes, args.rounds))
+        report("1 x /api/delta", measure(client.cells_by_delta, random_changes, args.rounds))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,166 @@
+#include "CellEffects.h"
+#include <string.h>
+
+#define NO_FRAME 0xFFFF
+#define RAINBOW_DEFAULT_FRAMES 64
+
+// Frame styles
+enum EffectStyle {
+  STYLE_PULSE,        // 100% down to 20% and back up
+  STYLE_RAMP,         // 20%, 40% ... 100%
+  STYLE_RAINBOW       // rainbow across the cell, rotated by one per frame
+};
+
+// How an effect is played: 'frames' frames of 'frameTicks' ticks each,
+// with 'pauseTicks' of the last frame after every cycle. The cycles come
+// from the command for the pulse.
+struct EffectDef {
+  uint8_t frameTicks;
+  uint8_t frames;
+  uint8_t pauseTicks;
+  uint8_t style;
+};
+
+// Timings of the firmware's effects (5 ms ticks)
+static const EffectDef effectTable[NUM_CELL_EFFECTS] = {
+  // CELL_EFFECT_NONE
+  {1, 1, 0, STYLE_PULSE},
+  // CELL_EFFECT_PULSE - 18 frames of 20 ms, 100 ms between repeats
+  {4, 18, 20, STYLE_PULSE},
+  // CELL_EFFECT_GROWTH - five steps of 100 ms
+  {20, 5, 0, STYLE_RAMP},
+  // CELL_EFFECT_RAINBOW - 15 ms per frame
+  {3, 0, 0, STYLE_RAINBOW}
+};
+
+static void loadEffect(const CellAnimation& anim, EffectDef* def, uint8_t* cycles) {
+  *def = effectTable[anim.effect];
+  *cycles = 1;
+  if (anim.effect == CELL_EFFECT_PULSE && anim.param > 1) *cycles = anim.param;
+  if (def->style == STYLE_RAINBOW) def->frames = anim.param ? anim.param : RAINBOW_DEFAULT_FRAMES;
+}
+
+// Hue (0-255) at full saturation and value to RGB, in six linear sectors
+static void hueToRgb(uint8_t hue, uint8_t* out) {
+  uint8_t sector = hue / 43;
+  uint8_t rise = (hue - sector * 43) * 6;
+  uint8_t fall = 255 - rise;
+  switch (sector) {
+    case 0:  out[0] = 255;  out[1] = rise; out[2] = 0;    break;
+    case 1:  out[0] = fall; out[1] = 255;  out[2] = 0;    break;
+    case 2:  out[0] = 0;    out[1] = 255;  out[2] = rise; break;
+    case 3:  out[0] = 0;    out[1] = fall; out[2] = 255;  break;
+    case 4:  out[0] = rise; out[1] = 0;    out[2] = 255;  break;
+    default: out[0] = 255;  out[1] = 0;    out[2] = fall; break;
+  }
+}
+
+CellEffects::CellEffects(uint8_t* rgb, uint16_t numLeds)
+  : _rgb(rgb), _numLeds(numLeds), _lastTick(0), _started(false) {
+  memset(_cells, 0, sizeof(_cells));
+}
+
+bool CellEffects::play(uint8_t row, uint8_t col, uint8_t effect, uint8_t r, uint8_t g, uint8_t b, uint8_t param) {
+  if (row >= GRID_ROWS || col >= GRID_COLS || effect >= NUM_CELL_EFFECTS) return false;
+  uint8_t cell = row * GRID_COLS + col;
+  if ((cell + 1) * LEDS_PER_CELL > _numLeds) return false;
+
+  CellAnimation& anim = _cells[cell];
+  anim.effect = effect;
+  anim.r = r;
+  anim.g = g;
+  anim.b = b;
+  anim.param = param;
+  anim.ticks = 0;
+  anim.frame = NO_FRAME;
+  return true;
+}
+
+bool CellEffects::handleCommand(const uint8_t* data, size_t length) {
+  if (length != CELL_COMMAND_SIZE) return false;
+  return play(data[0], data[1], data[2], data[3], data[4], data[5], data[6]);
+}
+
+void CellEffects::stopAll() {
+  for (uint8_t i = 0; i < GRID_ROWS * GRID_COLS; i++) {
+    _cells[i].effect = CELL_EFFECT_NONE;
+  }
+}
+
+bool CellEffects::isActive(uint8_t row, uint8_t col) const {
+  if (row >= GRID_ROWS || col >= GRID_COLS) return false;
+  return _cells[row * GRID_COLS + col].effect != CELL_EFFECT_NONE;
+}
+
+bool CellEffects::update(unsigned long nowMs) {
+  if (!_started) {
+    _lastTick = nowMs;
+    _started = true;
+  }
+  unsigned long elapsed = (nowMs - _lastTick) / EFFECT_TICK_MS;
+  _lastTick += elapsed * EFFECT_TICK_MS;
+  if (elapsed > 0xFFFF) elapsed = 0xFFFF;  // Far behind - just skip ahead
+
+  bool changed = false;
+  for (uint8_t i = 0; i < GRID_ROWS * GRID_COLS; i++) {
+    if (_cells[i].effect != CELL_EFFECT_NONE && advance(i, elapsed)) changed = true;
+  }
+  return changed;
+}
+
+bool CellEffects::advance(uint8_t cell, uint16_t ticks) {
+  CellAnimation& anim = _cells[cell];
+  EffectDef def;
+  uint8_t cycles;
+  loadEffect(anim, &def, &cycles);
+  uint16_t cycleTicks = def.frames * def.frameTicks + def.pauseTicks;
+  uint32_t totalTicks = (uint32_t)cycleTicks * cycles;
+
+  // The first frame shows on the tick the effect starts
+  uint32_t now = (uint32_t)anim.ticks + ticks;
+  if (now >= totalTicks) {
+    // Finished: hold the last frame
+    render(cell, def.frames - 1);
+    anim.effect = CELL_EFFECT_NONE;
+    return true;
+  }
+  anim.ticks = now;
+
+  // Frame within the cycle; the pause holds the last frame
+  uint16_t cycle = anim.ticks / cycleTicks;
+  uint16_t frame = (anim.ticks % cycleTicks) / def.frameTicks;
+  if (frame >= def.frames) frame = def.frames - 1;
+
+  uint16_t absoluteFrame = cycle * def.frames + frame;
+  if (absoluteFrame == anim.frame) return false;
+  render(cell, frame);
+  anim.frame = absoluteFrame;
+  return true;
+}
+
+void CellEffects::render(uint8_t cell, uint16_t frame) {
+  const CellAnimation& anim = _cells[cell];
+  uint8_t* out = _rgb + cell * LEDS_PER_CELL * 3;
+  uint8_t style = effectTable[anim.effect].style;
+
+  if (style == STYLE_RAINBOW) {
+    for (uint8_t i = 0; i < LEDS_PER_CELL; i++) {
+      hueToRgb((i * 256 / LEDS_PER_CELL) + frame, out + i * 3);
+    }
+    return;
+  }
+
+  uint8_t brightness;
+  if (style == STYLE_PULSE) {
+    // Frames 0-8 dim from 100% to 20%, frames 9-17 come back up
+    brightness = frame < 9 ? (10 - frame) * 10 : (frame - 7) * 10;
+  } else {
+    brightness = 20 * (frame + 1);
+  }
+
+  for (uint8_t i = 0; i < LEDS_PER_CELL; i++) {
+    out[i * 3] = (anim.r * brightness) / 100;
+    out[i * 3 + 1] = (anim.g * brightness) / 100;
+    out[i * 3 + 2] = (anim.b * brightness) / 100;
+  }
+}
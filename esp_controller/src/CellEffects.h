@@ -0,0 +1,74 @@
+#ifndef CELL_EFFECTS_H
+#define CELL_EFFECTS_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// The board: a 6x6 grid, each cell a run of LEDS_PER_CELL LEDs on the
+// strip in row order (the web app's GRID_TO_LED_MAPPING)
+#define GRID_ROWS 6
+#define GRID_COLS 6
+#define LEDS_PER_CELL 2
+
+// Base tick of the effect engine; every frame time is a multiple of it
+#define EFFECT_TICK_MS 5
+
+// Effects a cell can play
+enum CellEffect {
+  CELL_EFFECT_NONE = 0,   // stop; the LEDs keep their last frame
+  CELL_EFFECT_PULSE,      // dim down and back up, param = repeats (1 if 0)
+  CELL_EFFECT_GROWTH,     // ramp up from dim to full in five steps
+  CELL_EFFECT_RAINBOW,    // rotating rainbow, param = frames (64 if 0)
+  NUM_CELL_EFFECTS
+};
+
+// An effect command, as sent over the stream or to /api/effect:
+//   row | col | effect | r | g | b | param
+#define CELL_COMMAND_SIZE 7
+
+// Animation state of one cell
+struct CellAnimation {
+  uint8_t effect;
+  uint8_t r, g, b;
+  uint8_t param;
+  uint16_t ticks;     // ticks since the effect started
+  uint16_t frame;     // last frame rendered
+};
+
+// Renders the firmware's ring effects (lib/RingEffects.cpp: same frame
+// times, brightness steps and rainbow) on the cells of the board, so a
+// client sends one small command per interaction instead of a stream of
+// frames. A new command replaces whatever the cell is playing. Plain C++
+// without Arduino, so it also runs in a host build.
+class CellEffects {
+public:
+  // rgb: the LED buffer, 3 bytes (r, g, b) per LED
+  CellEffects(uint8_t* rgb, uint16_t numLeds);
+
+  // Start an effect on a cell; false if the cell or effect is unknown
+  bool play(uint8_t row, uint8_t col, uint8_t effect, uint8_t r, uint8_t g, uint8_t b, uint8_t param = 0);
+
+  // Decode and play a CELL_COMMAND_SIZE command
+  bool handleCommand(const uint8_t* data, size_t length);
+
+  // Stop every cell; the LEDs keep their last frame
+  void stopAll();
+
+  bool isActive(uint8_t row, uint8_t col) const;
+
+  // Advance all cells to the current time; true if an LED changed and
+  // the caller should show them
+  bool update(unsigned long nowMs);
+
+private:
+  uint8_t* _rgb;
+  uint16_t _numLeds;
+  CellAnimation _cells[GRID_ROWS * GRID_COLS];
+  unsigned long _lastTick;
+  bool _started;
+
+  bool advance(uint8_t cell, uint16_t ticks);
+  void render(uint8_t cell, uint16_t frame);
+};
+
+#endif // CELL_EFFECTS_H
@@ -0,0 +1,156 @@
+#include "LedStream.h"
+#include <string.h>
+
+LedStream::LedStream(uint8_t* rgb, uint16_t numLeds)
+  : _rgb(rgb), _numLeds(numLeds), _lastShow(0), _shown(false), _dirty(false),
+    _lastChanged(0), _nextSequence(0), _sequenced(false), _resync(false), _resyncSequence(0) {
+  memset(&_stats, 0, sizeof(_stats));
+  setMaxFps(STREAM_MAX_FPS);
+}
+
+void LedStream::setMaxFps(uint8_t fps) {
+  if (fps == 0) fps = 1;
+  _maxFps = fps;
+  _intervalUs = 1000000UL / fps;
+}
+
+bool LedStream::handleMessage(const uint8_t* data, size_t length) {
+  _lastChanged = 0;
+  if (length < 2) {
+    _stats.rejected++;
+    return false;
+  }
+
+  switch (data[0]) {
+    case STREAM_MSG_FRAME: {
+      uint16_t first = data[1];
+      size_t bytes = length - 2;
+      if (bytes == 0 || bytes % 3 != 0 || first + bytes / 3 > _numLeds) {
+        _stats.rejected++;
+        return false;
+      }
+      _lastChanged = writeLeds(first, data + 2, bytes / 3);
+      restartSequence();
+      break;
+    }
+
+    case STREAM_MSG_DELTA: {
+      size_t bytes = length - 1;
+      if (bytes % 4 != 0) {
+        _stats.rejected++;
+        return false;
+      }
+      // Check every LED number first, so a bad message writes nothing
+      for (size_t i = 1; i < length; i += 4) {
+        if (data[i] >= _numLeds) {
+          _stats.rejected++;
+          return false;
+        }
+      }
+      for (size_t i = 1; i < length; i += 4) {
+        _lastChanged += writeLeds(data[i], data + i + 1, 1);
+      }
+      break;
+    }
+
+    case STREAM_MSG_RUNS: {
+      if (length < STREAM_RUNS_HEADER || (length - STREAM_RUNS_HEADER) % STREAM_RUN_SIZE != 0) {
+        _stats.rejected++;
+        return false;
+      }
+      for (size_t i = STREAM_RUNS_HEADER; i < length; i += STREAM_RUN_SIZE) {
+        if (data[i + 1] == 0 || data[i] + data[i + 1] > _numLeds) {
+          _stats.rejected++;
+          return false;
+        }
+      }
+      if (!checkSequence(data[1] | (data[2] << 8))) return false;
+      for (size_t i = STREAM_RUNS_HEADER; i < length; i += STREAM_RUN_SIZE) {
+        for (uint8_t led = 0; led < data[i + 1]; led++) {
+          _lastChanged += writeLeds(data[i] + led, data + i + 2, 1);
+        }
+      }
+      break;
+    }
+
+    case STREAM_MSG_SET_FPS:
+      if (length != 2 || data[1] == 0) {
+        _stats.rejected++;
+        return false;
+      }
+      setMaxFps(data[1]);
+      return true;
+
+    default:
+      _stats.rejected++;
+      return false;
+  }
+
+  if (_lastChanged == 0) {
+    _stats.unchanged++;
+    return true;
+  }
+
+  // The frame waiting for its show is overwritten
+  if (_dirty) _stats.superseded++;
+  _dirty = true;
+  _stats.messages++;
+  return true;
+}
+
+bool LedStream::takeResync(uint16_t* sequence) {
+  if (!_resync) return false;
+  _resync = false;
+  *sequence = _resyncSequence;
+  return true;
+}
+
+void LedStream::restartSequence() {
+  _sequenced = false;
+  _resync = false;
+}
+
+// Copy 'count' LEDs into the buffer; the number that changed
+uint16_t LedStream::writeLeds(uint16_t first, const uint8_t* rgb, uint16_t count) {
+  uint16_t changed = 0;
+  uint8_t* out = _rgb + first * 3;
+  for (uint16_t i = 0; i < count; i++, out += 3, rgb += 3) {
+    if (out[0] != rgb[0] || out[1] != rgb[1] || out[2] != rgb[2]) {
+      out[0] = rgb[0];
+      out[1] = rgb[1];
+      out[2] = rgb[2];
+      changed++;
+    }
+  }
+  return changed;
+}
+
+// Follow the RUNS sequence; false if the message is older than the last one
+bool LedStream::checkSequence(uint16_t sequence) {
+  if (_sequenced) {
+    uint16_t ahead = sequence - _nextSequence;
+    if (ahead >= 0x8000) {
+      _stats.stale++;
+      return false;
+    }
+    if (ahead > 0) {
+      _stats.lost += ahead;
+      _resync = true;
+      _resyncSequence = sequence;
+    }
+  }
+  _sequenced = true;
+  _nextSequence = sequence + 1;
+  return true;
+}
+
+bool LedStream::service(unsigned long nowUs) {
+  if (!_dirty) return false;
+  if (_shown && nowUs - _lastShow < _intervalUs) return false;
+
+  _dirty = false;
+  _shown = true;
+  _lastShow = nowUs;
+  _stats.shows++;
+  return true;
+}
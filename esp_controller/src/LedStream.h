@@ -0,0 +1,113 @@
+#ifndef LED_STREAM_H
+#define LED_STREAM_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Maximum shows per second of the stream; a client can lower or raise it
+// with a SET_FPS message
+#ifndef STREAM_MAX_FPS
+  #define STREAM_MAX_FPS 60
+#endif
+
+// Binary WebSocket messages, first byte is the type:
+//   FRAME    0x01 | first LED | r g b per LED ...
+//   DELTA    0x02 | (LED, r, g, b) per changed LED ...
+//   SET_FPS  0x03 | frames per second (1-255)
+//   EFFECT   0x04 | effect command (CellEffects.h), not handled here
+//   RUNS     0x05 | sequence (2 bytes, low first) | (first LED, count, r, g, b) per run ...
+// and from the controller to the client:
+//   RESYNC   0x06 | sequence of the RUNS message that came after a gap
+// LED numbers are one byte, so a stream covers up to 256 LEDs.
+#define STREAM_MSG_FRAME   0x01
+#define STREAM_MSG_DELTA   0x02
+#define STREAM_MSG_SET_FPS 0x03
+#define STREAM_MSG_EFFECT  0x04
+#define STREAM_MSG_RUNS    0x05
+#define STREAM_MSG_RESYNC  0x06
+
+#define STREAM_RUNS_HEADER 3
+#define STREAM_RUN_SIZE    5
+
+struct LedStreamStats {
+  unsigned long messages;     // messages applied to the LED buffer
+  unsigned long rejected;     // malformed messages, ignored
+  unsigned long superseded;   // messages that came while a frame waited for its show
+                              // (a full frame drops it, a delta is merged into it)
+  unsigned long shows;        // frames handed to FastLED.show()
+  unsigned long unchanged;    // messages that left every LED as it was (no show)
+  unsigned long lost;         // RUNS messages missing from the sequence
+  unsigned long stale;        // RUNS messages older than the last one, dropped
+};
+
+// Decodes the stream messages straight into the LED buffer and paces the
+// shows. A message only marks the buffer dirty; service() says when to
+// show it, at most once per frame interval. Messages that arrive in the
+// meantime overwrite the buffer, so a client sending faster than the LEDs
+// are shown loses the superseded frames instead of building a queue.
+// A message that changes no LED does not mark the buffer at all, so it
+// costs no show. Other writers of the buffer mark it with markChanged(),
+// so every show on the strip goes through the same pacing.
+//
+// RUNS messages carry a sequence number. A gap means updates were lost
+// and the LEDs they set may be stale; takeResync() reports it once, and
+// the client answers with a full FRAME. A RUNS message older than the
+// last one is dropped, so a late update never overwrites a newer one.
+// A FRAME sets every LED it covers, so it starts the sequence over: a
+// client that restarts its count (a reloaded page) sends a full frame
+// first, and its RUNS are taken from there.
+// Plain C++ without Arduino, so it also runs in a host build.
+class LedStream {
+public:
+  // rgb: the LED buffer, 3 bytes (r, g, b) per LED
+  LedStream(uint8_t* rgb, uint16_t numLeds);
+
+  // Apply one message; false if it is malformed or stale (nothing is
+  // written then)
+  bool handleMessage(const uint8_t* data, size_t length);
+
+  // LEDs the last message changed
+  uint16_t lastChanged() const { return _lastChanged; }
+
+  // True once after a gap in the RUNS sequence, with the sequence number
+  // of the message after the gap
+  bool takeResync(uint16_t* sequence);
+
+  // Forget the RUNS sequence, and any resync it asked for; the next RUNS
+  // message starts it again. Done by every FRAME message, and by the
+  // caller when it sets the LEDs with a full frame of its own
+  void restartSequence();
+
+  // True when the buffer changed and the frame interval since the last
+  // show is over; the caller shows the LEDs then. nowUs: micros()
+  bool service(unsigned long nowUs);
+
+  // The buffer was changed outside the stream (the cell effects); its
+  // show is paced like a message's
+  void markChanged() { _dirty = true; }
+
+  void setMaxFps(uint8_t fps);
+  uint8_t maxFps() const { return _maxFps; }
+  bool pending() const { return _dirty; }
+  const LedStreamStats& stats() const { return _stats; }
+
+private:
+  uint8_t* _rgb;
+  uint16_t _numLeds;
+  uint8_t _maxFps;
+  unsigned long _intervalUs;
+  unsigned long _lastShow;    // micros() of the last show
+  bool _shown;                // a frame was shown since start
+  bool _dirty;
+  uint16_t _lastChanged;
+  uint16_t _nextSequence;
+  bool _sequenced;            // a RUNS message came since start
+  bool _resync;
+  uint16_t _resyncSequence;
+  LedStreamStats _stats;
+
+  uint16_t writeLeds(uint16_t first, const uint8_t* rgb, uint16_t count);
+  bool checkSequence(uint16_t sequence);
+};
+
+#endif // LED_STREAM_H
@@ -3,6 +3,9 @@
 #include <ESP8266WebServer.h>
 #include <ArduinoJson.h>
 #include <FastLED.h>
+#include <WebSocketsServer.h>
+#include "LedStream.h"
+#include "CellEffects.h"
 
 // FastLED configuration
 #define LED_TYPE    WS2812B
@@ -17,6 +20,14 @@
   #define NUM_LEDS    72 // For 6x6 grid (72 LEDs)
 #endif
 
+#ifndef STREAM_PORT
+  #define STREAM_PORT 81 // WebSocket LED stream
+#endif
+
+#if NUM_LEDS > 256
+  #error "The LED stream addresses LEDs with one byte"
+#endif
+
 #ifndef WIFI_SSID
   #define WIFI_SSID "InteractiveGarden"
 #endif
@@ -29,6 +40,39 @@
 ESP8266WebServer server(80);
 CRGB leds[NUM_LEDS];
 
+// WebSocket LED stream, written straight into leds[] (CRGB is r, g, b)
+WebSocketsServer streamServer(STREAM_PORT);
+LedStream ledStream((uint8_t*)leds, NUM_LEDS);
+
+// Pulse, growth and rainbow effects rendered on the ESP, per grid cell
+CellEffects cellEffects((uint8_t*)leds, NUM_LEDS);
+
+// Frame upload in progress: the first LED it writes, the bytes received
+// so far, and whether it is still valid. The bytes are staged here and
+// only reach leds[] once the whole frame is known to be valid.
+int frameOffset = 0;
+uint8_t frameUpload[NUM_LEDS * sizeof(CRGB)];
+size_t frameBytes = 0;
+bool frameOk = false;
+
+// Delta upload in progress: a RUNS message, the type byte in front of the
+// body, and how much of it came
+uint8_t deltaMessage[STREAM_RUNS_HEADER + NUM_LEDS * STREAM_RUN_SIZE];
+size_t deltaBytes = 0;
+bool deltaOk = false;
+
+// JSON bodies (/api/led, /api/batch, /api/effect) are read into a fixed
+// buffer and parsed in place into a fixed document, both allocated once,
+// so a request does not grow or fragment the heap
+#ifndef JSON_BODY_SIZE
+  #define JSON_BODY_SIZE 3072
+#endif
+#define BATCH_MAX_OPS 36 // One range per grid cell
+char jsonBody[JSON_BODY_SIZE];
+size_t jsonBodyBytes = 0;
+bool jsonBodyOk = true;
+StaticJsonDocument<JSON_ARRAY_SIZE(BATCH_MAX_OPS) + BATCH_MAX_OPS * 2 * JSON_OBJECT_SIZE(3)> jsonDoc;
+
 // CORS headers for web browser access
 void setCorsHeaders() {
   server.sendHeader("Access-Control-Allow-Origin", "*");
@@ -41,59 +85,290 @@ void handleOptions() {
   server.send(200);
 }
 
+// Receive a JSON body into jsonBody
+void handleJsonBody() {
+  HTTPRaw& raw = server.raw();
+  
+  if (raw.status == RAW_START) {
+    jsonBodyBytes = 0;
+    jsonBodyOk = true;
+  } else if (raw.status == RAW_WRITE && jsonBodyOk) {
+    if (raw.currentSize > sizeof(jsonBody) - jsonBodyBytes) {
+      jsonBodyOk = false;
+      return;
+    }
+    memcpy(jsonBody + jsonBodyBytes, raw.buf, raw.currentSize);
+    jsonBodyBytes += raw.currentSize;
+  } else if (raw.status == RAW_ABORTED) {
+    jsonBodyOk = false;
+  }
+}
+
+// Parse what handleJsonBody() received into jsonDoc; on an error the
+// response is sent and false returned
+bool parseJsonBody() {
+  // Ready for the next body, also if it is empty and never starts
+  size_t length = jsonBodyBytes;
+  bool ok = jsonBodyOk;
+  jsonBodyBytes = 0;
+  jsonBodyOk = true;
+  
+  if (ok && length == 0) {
+    server.send(400, "text/plain", "Bad Request: Missing body");
+    return false;
+  }
+  if (!ok) {
+    server.send(413, "text/plain", "Payload Too Large: Body too long");
+    return false;
+  }
+  
+  // A writable buffer: strings are not copied into the document
+  DeserializationError error = deserializeJson(jsonDoc, jsonBody, length);
+  if (error == DeserializationError::NoMemory) {
+    server.send(413, "text/plain", "Payload Too Large: Too many operations");
+    return false;
+  }
+  if (error) {
+    server.send(400, "text/plain", "Bad Request: Invalid JSON");
+    return false;
+  }
+  return true;
+}
+
+// Check a range operation ({"start", "end", "color": {"r", "g", "b"}})
+// and, if 'apply', set its LEDs; false if the range is not on the strip
+bool setRange(JsonVariantConst op, bool apply) {
+  int start = op["start"];
+  int end = op["end"];
+  if (start < 0 || start >= NUM_LEDS || end < 0 || end >= NUM_LEDS || start > end) {
+    return false;
+  }
+  
+  if (apply) {
+    int r = op["color"]["r"];
+    int g = op["color"]["g"];
+    int b = op["color"]["b"];
+    for (int i = start; i <= end; i++) {
+      leds[i] = CRGB(r, g, b);
+    }
+  }
+  return true;
+}
+
 // Handle LED control endpoint
 void handleLedControl() {
   setCorsHeaders();
   
-  // Check if the request has a body
-  if (server.hasArg("plain") == false) {
-    server.send(400, "text/plain", "Bad Request: Missing body");
+  if (!parseJsonBody()) return;
+  
+  if (!setRange(jsonDoc.as<JsonVariantConst>(), true)) {
+    server.send(400, "text/plain", "Bad Request: Invalid LED range");
     return;
   }
+  ledStream.markChanged();
   
-  // Parse the JSON request
-  String body = server.arg("plain");
-  DynamicJsonDocument doc(1024);
-  DeserializationError error = deserializeJson(doc, body);
+  // Send success response
+  server.send(200, "application/json", "{\"success\":true,\"message\":\"LEDs updated\"}");
+}
+
+// Handle a batch: an array of range operations, all checked before any
+// is applied, and shown once by loop()
+void handleBatch() {
+  setCorsHeaders();
   
-  if (error) {
-    server.send(400, "text/plain", "Bad Request: Invalid JSON");
+  if (!parseJsonBody()) return;
+  
+  JsonArrayConst ops = jsonDoc.as<JsonArrayConst>();
+  if (ops.isNull() || ops.size() == 0) {
+    server.send(400, "text/plain", "Bad Request: Expected an array of LED ranges");
     return;
   }
   
-  // Extract parameters
-  int start = doc["start"];
-  int end = doc["end"];
-  int r = doc["color"]["r"];
-  int g = doc["color"]["g"];
-  int b = doc["color"]["b"];
+  char response[80];
+  unsigned int index = 0;
+  for (JsonVariantConst op : ops) {
+    if (!setRange(op, false)) {
+      snprintf(response, sizeof(response), "Bad Request: Invalid LED range in operation %u", index);
+      server.send(400, "text/plain", response);
+      return;
+    }
+    index++;
+  }
   
-  // Validate parameters
-  if (start < 0 || start >= NUM_LEDS || end < 0 || end >= NUM_LEDS || start > end) {
-    server.send(400, "text/plain", "Bad Request: Invalid LED range");
+  for (JsonVariantConst op : ops) {
+    setRange(op, true);
+  }
+  ledStream.markChanged();
+  
+  snprintf(response, sizeof(response), "{\"success\":true,\"applied\":%u}", index);
+  server.send(200, "application/json", response);
+}
+
+// Receive the body of a frame upload: raw RGB bytes, 3 per LED (CRGB is
+// laid out as r, g, b), into frameUpload
+void handleFrameBody() {
+  HTTPRaw& raw = server.raw();
+  
+  if (raw.status == RAW_START) {
+    frameOffset = server.hasArg("offset") ? server.arg("offset").toInt() : 0;
+    frameBytes = 0;
+    frameOk = frameOffset >= 0 && frameOffset < NUM_LEDS;
+  } else if (raw.status == RAW_WRITE && frameOk) {
+    size_t room = (NUM_LEDS - frameOffset) * sizeof(CRGB) - frameBytes;
+    if (raw.currentSize > room) {
+      frameOk = false;
+      return;
+    }
+    memcpy(frameUpload + frameBytes, raw.buf, raw.currentSize);
+    frameBytes += raw.currentSize;
+  } else if (raw.status == RAW_ABORTED) {
+    frameOk = false;
+  }
+}
+
+// Handle a full frame: copy what handleFrameBody() received into leds[];
+// loop() shows it
+void handleFrame() {
+  setCorsHeaders();
+  
+  // A frame that was cut short or too long leaves the LEDs as they are
+  if (!frameOk || frameBytes == 0 || frameBytes % sizeof(CRGB) != 0) {
+    frameOk = false;
+    server.send(400, "text/plain", "Bad Request: Invalid frame");
     return;
   }
+  frameOk = false;
+  memcpy((uint8_t*)&leds[frameOffset], frameUpload, frameBytes);
+  ledStream.markChanged();
+  
+  // The frame is what /api/delta's runs build on; a client that restarted
+  // its sequence numbers starts them from here
+  ledStream.restartSequence();
   
-  // Set LED colors
-  for (int i = start; i <= end; i++) {
-    leds[i] = CRGB(r, g, b);
+  server.send(200, "application/json", "{\"success\":true,\"message\":\"Frame shown\"}");
+}
+
+// Handle a WebSocket stream event; binary messages go to the LED stream
+void handleStreamEvent(uint8_t client, WStype_t type, uint8_t* payload, size_t length) {
+  switch (type) {
+    case WStype_CONNECTED:
+      Serial.printf("Stream client %u connected\n", client);
+      break;
+    case WStype_DISCONNECTED:
+      Serial.printf("Stream client %u disconnected\n", client);
+      break;
+    case WStype_BIN: {
+      if (length > 0 && payload[0] == STREAM_MSG_EFFECT) {
+        cellEffects.handleCommand(payload + 1, length - 1);
+        break;
+      }
+      ledStream.handleMessage(payload, length);
+      // Updates went missing: the client sends a full frame
+      uint16_t sequence;
+      if (ledStream.takeResync(&sequence)) {
+        uint8_t resync[3] = {STREAM_MSG_RESYNC, (uint8_t)(sequence & 0xFF), (uint8_t)(sequence >> 8)};
+        streamServer.sendBIN(client, resync, sizeof(resync));
+      }
+      break;
+    }
+    default:
+      break;
   }
-  FastLED.show();
+}
+
+// Effect names of /api/effect, in CellEffect order
+const char* const effectNames[NUM_CELL_EFFECTS] = {"stop", "pulse", "growth", "rainbow"};
+
+// Handle an effect command: play an effect on one grid cell
+void handleEffect() {
+  setCorsHeaders();
   
-  // Send success response
-  server.send(200, "application/json", "{\"success\":true,\"message\":\"LEDs updated\"}");
+  if (!parseJsonBody()) return;
+  JsonVariantConst doc = jsonDoc.as<JsonVariantConst>();
+  
+  const char* name = doc["effect"] | "";
+  int effect = -1;
+  for (int i = 0; i < NUM_CELL_EFFECTS; i++) {
+    if (strcmp(name, effectNames[i]) == 0) effect = i;
+  }
+  
+  int row = doc["row"] | -1;
+  int col = doc["col"] | -1;
+  if (effect < 0 || row < 0 || row >= GRID_ROWS || col < 0 || col >= GRID_COLS ||
+      !cellEffects.play(row, col, effect, doc["color"]["r"], doc["color"]["g"], doc["color"]["b"], doc["param"] | 0)) {
+    server.send(400, "text/plain", "Bad Request: Invalid effect");
+    return;
+  }
+  
+  server.send(200, "application/json", "{\"success\":true,\"message\":\"Effect started\"}");
+}
+
+// Receive the body of a delta: the RUNS message without its type byte
+void handleDeltaBody() {
+  HTTPRaw& raw = server.raw();
+  
+  if (raw.status == RAW_START) {
+    deltaMessage[0] = STREAM_MSG_RUNS;
+    deltaBytes = 1;
+    deltaOk = true;
+  } else if (raw.status == RAW_WRITE && deltaOk) {
+    if (raw.currentSize > sizeof(deltaMessage) - deltaBytes) {
+      deltaOk = false;
+      return;
+    }
+    memcpy(deltaMessage + deltaBytes, raw.buf, raw.currentSize);
+    deltaBytes += raw.currentSize;
+  } else if (raw.status == RAW_ABORTED) {
+    deltaOk = false;
+  }
+}
+
+// Handle a delta: apply the runs that changed, show only if an LED changed
+void handleDelta() {
+  setCorsHeaders();
+  
+  bool ok = deltaOk && ledStream.handleMessage(deltaMessage, deltaBytes);
+  deltaOk = false;
+  if (!ok) {
+    server.send(400, "text/plain", "Bad Request: Invalid or late delta");
+    return;
+  }
+  
+  // A delta that changed an LED marked the buffer; loop() shows it
+  uint16_t changed = ledStream.lastChanged();
+  
+  // A gap in the sequence: the client sends a full /api/frame
+  uint16_t sequence;
+  bool resync = ledStream.takeResync(&sequence);
+  char response[80];
+  snprintf(response, sizeof(response), "{\"success\":true,\"changed\":%u,\"resync\":%s}",
+           changed, resync ? "true" : "false");
+  server.send(200, "application/json", response);
 }
 
 // Handle clearing all LEDs
 void handleClearLeds() {
   setCorsHeaders();
   
+  cellEffects.stopAll();
   FastLED.clear();
-  FastLED.show();
+  ledStream.markChanged();
   
   server.send(200, "application/json", "{\"success\":true,\"message\":\"All LEDs cleared\"}");
 }
 
+// Handle a status request: uptime and heap, to check the heap stays whole
+// under load
+void handleStatus() {
+  setCorsHeaders();
+  
+  char response[120];
+  snprintf(response, sizeof(response), "{\"uptime\":%lu,\"freeHeap\":%lu,\"maxFreeBlock\":%lu,\"fragmentation\":%u}",
+           millis(), (unsigned long)ESP.getFreeHeap(), (unsigned long)ESP.getMaxFreeBlockSize(),
+           (unsigned int)ESP.getHeapFragmentation());
+  server.send(200, "application/json", response);
+}
+
 // Handle home page
 void handleRoot() {
   setCorsHeaders();
@@ -141,15 +416,29 @@ void setup() {
   
   // Define API routes
   server.on("/", HTTP_GET, handleRoot);
-  server.on("/api/led", HTTP_POST, handleLedControl);
+  server.on("/api/status", HTTP_GET, handleStatus);
+  server.on("/api/led", HTTP_POST, handleLedControl, handleJsonBody);
+  server.on("/api/batch", HTTP_POST, handleBatch, handleJsonBody);
   server.on("/api/clear", HTTP_POST, handleClearLeds);
+  server.on("/api/frame", HTTP_POST, handleFrame, handleFrameBody);
+  server.on("/api/effect", HTTP_POST, handleEffect, handleJsonBody);
+  server.on("/api/delta", HTTP_POST, handleDelta, handleDeltaBody);
   server.on("/api/led", HTTP_OPTIONS, handleOptions);
+  server.on("/api/batch", HTTP_OPTIONS, handleOptions);
   server.on("/api/clear", HTTP_OPTIONS, handleOptions);
+  server.on("/api/frame", HTTP_OPTIONS, handleOptions);
+  server.on("/api/effect", HTTP_OPTIONS, handleOptions);
+  server.on("/api/delta", HTTP_OPTIONS, handleOptions);
   
   // Start server
   server.begin();
   Serial.println("HTTP server started");
   
+  // Start the LED stream
+  streamServer.begin();
+  streamServer.onEvent(handleStreamEvent);
+  Serial.printf("LED stream on port %d, up to %d fps\n", STREAM_PORT, ledStream.maxFps());
+  
   // Show startup animation on LEDs
   for (int i = 0; i < NUM_LEDS; i++) {
     leds[i] = CRGB::Green;
@@ -164,4 +453,15 @@ void setup() {
 void loop() {
   // Handle client requests
   server.handleClient();
+  streamServer.loop();
+  
+  // Every writer of leds[] (the stream, the HTTP handlers and the effects,
+  // which tick every 5 ms) only marks it changed; the shows happen here,
+  // paced to the stream's frame rate
+  if (cellEffects.update(millis())) {
+    ledStream.markChanged();
+  }
+  if (ledStream.service(micros())) {
+    FastLED.show();
+  }
 }
\ No newline at end of file
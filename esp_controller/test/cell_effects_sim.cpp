@@ -0,0 +1,181 @@
+/**
+ * Cell Effect Engine Test (host)
+ *
+ * Runs the CellEffects engine of the ESP controller on a virtual clock
+ * with a 1 ms loop and checks the effects against the firmware's ring
+ * effects (lib/RingEffects.cpp):
+ * - pulse: 18 frames of 20 ms from 100% down to 20% and back, repeats
+ *   100 ms apart, then the color holds at full brightness
+ * - growth: 20%, 40% ... 100% in steps of 100 ms
+ * - rainbow: one frame every 15 ms for the given number of frames
+ * - a new command replaces the running effect, other cells are left alone
+ * - malformed commands are refused
+ * - 36 staggered pulses shown through the LED stream's pacer, as in
+ *   loop(): at most STREAM_MAX_FPS shows a second, and the last frame
+ *   is not lost
+ * It also compares what a 3x pulse costs on the network: one command on
+ * the WebSocket stream against streaming the frames as deltas.
+ *
+ * Build and run with: pio run -e cell_effects_sim && .pio/build/cell_effects_sim/program
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "CellEffects.h"
+#include "LedStream.h"
+
+#define NUM_LEDS (GRID_ROWS * GRID_COLS * LEDS_PER_CELL)
+// A client's WebSocket frame header: 2 bytes and the 4-byte mask
+#define WS_HEADER 6
+
+static uint8_t leds[NUM_LEDS * 3];
+static CellEffects effects(leds, NUM_LEDS);
+static unsigned long now = 0;
+static unsigned long updates = 0;    // update() calls that changed LEDs
+static int failures = 0;
+
+static void check(bool ok, const char *what) {
+  if (!ok) {
+    printf("  FAIL %s\n", what);
+    failures++;
+  }
+}
+
+static void runTo(unsigned long ms) {
+  while (now < ms) {
+    now++;
+    if (effects.update(now)) updates++;
+  }
+}
+
+static const uint8_t *cell(uint8_t row, uint8_t col) {
+  return leds + (row * GRID_COLS + col) * LEDS_PER_CELL * 3;
+}
+
+// Run the effects with their frames shown through the stream's pacer,
+// like loop()
+static LedStream pacer(leds, NUM_LEDS);
+static unsigned long pacedFrames = 0;  // update() calls that changed LEDs
+static unsigned long pacedShows = 0;
+
+static void runPacedTo(unsigned long ms) {
+  while (now < ms) {
+    now++;
+    if (effects.update(now)) {
+      pacer.markChanged();
+      pacedFrames++;
+    }
+    if (pacer.service(now * 1000)) pacedShows++;
+  }
+}
+
+// Brightness of a single-color cell in percent of 'full'
+static int percent(uint8_t row, uint8_t col, uint8_t channel, uint8_t full) {
+  return cell(row, col)[channel] * 100 / full;
+}
+
+int main() {
+  effects.update(now);
+
+  // Pulse, three times, in green
+  unsigned long start = now;
+  unsigned long updatesBefore = updates;
+  check(effects.play(2, 3, CELL_EFFECT_PULSE, 0, 255, 0, 3), "pulse starts");
+  runTo(start + 1);
+  check(percent(2, 3, 1, 255) == 100, "pulse starts at full brightness");
+  runTo(start + 165);
+  check(percent(2, 3, 1, 255) == 20, "pulse dims to 20% after 8 frames");
+  runTo(start + 345);
+  check(percent(2, 3, 1, 255) == 100, "pulse is back up after 18 frames");
+  runTo(start + 3 * (360 + 100) - 2);
+  check(effects.isActive(2, 3), "third pulse still playing");
+  runTo(start + 3 * (360 + 100) + 5);
+  check(!effects.isActive(2, 3), "pulse over after three repeats");
+  check(cell(2, 3)[0] == 0 && cell(2, 3)[1] == 255 && cell(2, 3)[2] == 0, "pulse ends in the full color");
+  unsigned long pulseFrames = updates - updatesBefore;
+  bool othersDark = true;
+  for (size_t i = 0; i < sizeof(leds); i++) {
+    if (leds + i < cell(2, 3) || leds + i >= cell(2, 3) + LEDS_PER_CELL * 3) {
+      if (leds[i]) othersDark = false;
+    }
+  }
+  check(othersDark, "pulse touched other cells");
+
+  // One command against a delta per frame (both LEDs of the cell)
+  unsigned long commandBytes = WS_HEADER + 1 + CELL_COMMAND_SIZE;
+  unsigned long streamBytes = pulseFrames * (WS_HEADER + 1 + LEDS_PER_CELL * 4);
+  printf("pulse x3: %lu frames on the ESP; %lu bytes as one command, %lu bytes streamed as deltas\n",
+         pulseFrames, commandBytes, streamBytes);
+
+  // Growth
+  start = now;
+  check(effects.play(0, 0, CELL_EFFECT_GROWTH, 200, 100, 0), "growth starts");
+  runTo(start + 1);
+  check(percent(0, 0, 0, 200) == 20, "growth starts at 20%");
+  runTo(start + 250);
+  check(percent(0, 0, 0, 200) == 60, "growth at 60% after 200 ms");
+  runTo(start + 505);
+  check(!effects.isActive(0, 0) && percent(0, 0, 0, 200) == 100, "growth ends at full brightness after 500 ms");
+
+  // Rainbow of 20 frames: 300 ms, a new color every frame
+  start = now;
+  check(effects.play(5, 5, CELL_EFFECT_RAINBOW, 0, 0, 0, 20), "rainbow starts");
+  runTo(start + 1);
+  uint8_t first[3];
+  memcpy(first, cell(5, 5), 3);
+  runTo(start + 16);
+  check(memcmp(first, cell(5, 5), 3) != 0, "rainbow moves on after 15 ms");
+  check(cell(5, 5)[3] != cell(5, 5)[0] || cell(5, 5)[4] != cell(5, 5)[1], "rainbow spreads over the cell");
+  runTo(start + 295);
+  check(effects.isActive(5, 5), "rainbow still playing");
+  runTo(start + 305);
+  check(!effects.isActive(5, 5), "rainbow over after 20 frames");
+
+  // A new command replaces the running one
+  start = now;
+  effects.play(1, 1, CELL_EFFECT_PULSE, 255, 0, 0, 5);
+  runTo(start + 100);
+  effects.play(1, 1, CELL_EFFECT_GROWTH, 255, 0, 0);
+  runTo(start + 101);
+  check(percent(1, 1, 0, 255) == 20, "growth replaces the pulse");
+  runTo(start + 700);
+  check(!effects.isActive(1, 1), "replaced pulse does not come back");
+
+  // Commands from the stream
+  const uint8_t command[CELL_COMMAND_SIZE] = {4, 2, CELL_EFFECT_PULSE, 0, 0, 255, 1};
+  const uint8_t badRow[CELL_COMMAND_SIZE] = {GRID_ROWS, 0, CELL_EFFECT_PULSE, 0, 0, 255, 1};
+  const uint8_t badEffect[CELL_COMMAND_SIZE] = {0, 0, NUM_CELL_EFFECTS, 0, 0, 255, 1};
+  check(effects.handleCommand(command, sizeof(command)) && effects.isActive(4, 2), "command plays its effect");
+  check(!effects.handleCommand(command, sizeof(command) - 1), "short command accepted");
+  check(!effects.handleCommand(badRow, sizeof(badRow)) && !effects.handleCommand(badEffect, sizeof(badEffect)),
+        "command for an unknown cell or effect accepted");
+  effects.stopAll();
+  check(!effects.isActive(4, 2), "stopAll stops the cells");
+
+  // A pulse on every cell, started 5 ms apart: the frames come on every
+  // 5 ms ticks, the shows stay within the stream's frame rate
+  start = now;
+  for (uint8_t i = 0; i < GRID_ROWS * GRID_COLS; i++) {
+    runPacedTo(start + i * 5);
+    effects.play(i / GRID_COLS, i % GRID_COLS, CELL_EFFECT_PULSE, 0, 0, 255, 5);
+  }
+  runPacedTo(start + 500);
+  unsigned long framesBefore = pacedFrames;
+  unsigned long showsBefore = pacedShows;
+  runPacedTo(start + 1500);
+  unsigned long framesPerSecond = pacedFrames - framesBefore;
+  unsigned long showsPerSecond = pacedShows - showsBefore;
+  printf("36 staggered pulses: %lu effect frames/s, %lu shows/s (limit %d fps)\n",
+         framesPerSecond, showsPerSecond, STREAM_MAX_FPS);
+  check(showsPerSecond <= STREAM_MAX_FPS, "effect frames shown past the stream's frame rate");
+  runPacedTo(start + 3000);
+  bool allBlue = true;
+  for (uint8_t i = 0; i < GRID_ROWS * GRID_COLS; i++) {
+    const uint8_t *c = cell(i / GRID_COLS, i % GRID_COLS);
+    if (c[0] != 0 || c[1] != 0 || c[2] != 255) allBlue = false;
+  }
+  check(allBlue && !pacer.pending(), "last effect frame not shown");
+
+  printf(failures ? "FAILED (%d)\n" : "OK\n", failures);
+  return failures ? 1 : 0;
+}
@@ -0,0 +1,295 @@
+/**
+ * LED Stream Load Generator (host)
+ *
+ * Runs the LedStream handler of the ESP controller on a virtual clock and
+ * drives it the way a WebSocket client would: frames or deltas at a given
+ * rate, each delayed by 2-8 ms of WiFi. The controller loop is modelled
+ * with 100 us per pass and FastLED.show() with the WS2812B wire time of
+ * 72 LEDs (30 us each plus the reset). For each client rate it reports:
+ * - the sustained frame rate on the LEDs, and the messages superseded
+ *   before they were shown
+ * - the end-to-end latency, from the client sending a message to the end
+ *   of the show that put it on the LEDs
+ * and checks that the shows never exceed the frame rate limit, that the
+ * last message always reaches the LEDs and that malformed messages write
+ * nothing.
+ *
+ * For the sequenced RUNS updates it checks that an update changing no LED
+ * costs no show, that a gap asks for a resync once, that a late update
+ * is dropped and that a client restarting its count after a full frame
+ * is followed again, and compares the bytes of a one- and a two-cell update with
+ * the JSON range requests of /api/led.
+ *
+ * Build and run with: pio run -e led_stream_load && .pio/build/led_stream_load/program
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "LedStream.h"
+
+#define NUM_LEDS 72
+#define LOOP_US 100
+#define SHOW_US (NUM_LEDS * 30 + 50)
+#define NET_MIN_US 2000
+#define NET_MAX_US 8000
+#define RUN_US 10000000UL
+#define DELTA_LEDS 4
+#define LEDS_PER_CELL 2
+
+static int failures = 0;
+static uint32_t seed = 4242;
+
+static void check(bool ok, const char *what) {
+  if (!ok) {
+    printf("  FAIL %s\n", what);
+    failures++;
+  }
+}
+
+static uint32_t nextRandom() {
+  seed = seed * 1103515245 + 12345;
+  return seed >> 8;
+}
+
+struct Result {
+  double fps;
+  unsigned long sent;
+  unsigned long superseded;
+  double latencyAvgMs;
+  double latencyMaxMs;
+  bool lastShown;
+};
+
+// A client sending 'rate' messages per second for RUN_US: full frames, or
+// deltas of DELTA_LEDS LEDs
+static Result run(unsigned int rate, bool deltas, uint8_t maxFps) {
+  uint8_t leds[NUM_LEDS * 3];
+  uint8_t model[NUM_LEDS * 3];      // what the client last sent
+  memset(leds, 0, sizeof(leds));
+  memset(model, 0, sizeof(model));
+  LedStream stream(leds, NUM_LEDS);
+  stream.setMaxFps(maxFps);
+
+  unsigned long now = 0;
+  unsigned long nextSend = 0;
+  unsigned long sent = 0;
+  // Messages on the way: send and arrival times; arrivals come in order
+  // (TCP), so a later message never overtakes an earlier one
+  static unsigned long sendTimes[4096], arrivals[4096];
+  static uint8_t messages[4096][2 + NUM_LEDS * 3];
+  static size_t lengths[4096];
+  unsigned int head = 0, tail = 0;
+  unsigned long lastArrival = 0;
+
+  unsigned long appliedSend = 0;    // send time of the newest message applied
+  double latencySum = 0, latencyMax = 0;
+  unsigned long shows = 0;
+
+  while (now < RUN_US + 100000) {
+    // The client
+    while (now < RUN_US && nextSend <= now) {
+      uint8_t *msg = messages[tail % 4096];
+      size_t length;
+      if (deltas) {
+        msg[0] = STREAM_MSG_DELTA;
+        length = 1;
+        for (uint8_t i = 0; i < DELTA_LEDS; i++) {
+          uint8_t led = nextRandom() % NUM_LEDS;
+          msg[length++] = led;
+          for (uint8_t c = 0; c < 3; c++) {
+            model[led * 3 + c] = msg[length++] = nextRandom();
+          }
+        }
+      } else {
+        msg[0] = STREAM_MSG_FRAME;
+        msg[1] = 0;
+        for (size_t i = 0; i < sizeof(model); i++) model[i] = msg[2 + i] = nextRandom();
+        length = 2 + sizeof(model);
+      }
+      unsigned long arrival = nextSend + NET_MIN_US + nextRandom() % (NET_MAX_US - NET_MIN_US);
+      if (arrival < lastArrival) arrival = lastArrival;
+      lastArrival = arrival;
+      lengths[tail % 4096] = length;
+      sendTimes[tail % 4096] = nextSend;
+      arrivals[tail % 4096] = arrival;
+      tail++;
+      sent++;
+      nextSend += 1000000UL / rate;
+    }
+
+    // The controller loop: take what has arrived, then maybe show
+    while (head != tail && arrivals[head % 4096] <= now) {
+      stream.handleMessage(messages[head % 4096], lengths[head % 4096]);
+      appliedSend = sendTimes[head % 4096];
+      head++;
+    }
+    if (stream.service(now)) {
+      now += SHOW_US;
+      double latency = (now - appliedSend) / 1000.0;
+      latencySum += latency;
+      if (latency > latencyMax) latencyMax = latency;
+      shows++;
+    }
+    now += LOOP_US;
+  }
+
+  Result result;
+  result.fps = shows * 1e6 / RUN_US;
+  result.sent = sent;
+  result.superseded = stream.stats().superseded;
+  result.latencyAvgMs = shows ? latencySum / shows : 0;
+  result.latencyMaxMs = latencyMax;
+  result.lastShown = head == tail && !stream.pending() && memcmp(leds, model, sizeof(leds)) == 0;
+  return result;
+}
+
+static void report(const char *what, unsigned int rate, uint8_t maxFps, const Result &r) {
+  printf("%-7s %4u/s, limit %3u fps: %5.1f fps shown, %5lu of %5lu superseded, "
+         "latency %5.1f ms avg %5.1f ms max\n",
+         what, rate, maxFps, r.fps, r.superseded, r.sent, r.latencyAvgMs, r.latencyMaxMs);
+  check(r.fps <= maxFps + 0.5, "more shows than the frame rate limit");
+  check(r.lastShown, "the last message did not reach the LEDs");
+  // Worst case: the network, a frame interval of waiting and the show
+  double bound = (NET_MAX_US + 1000000.0 / maxFps + SHOW_US + 2 * LOOP_US) / 1000;
+  check(r.latencyMaxMs <= bound, "latency over network + frame interval + show");
+}
+
+// A RUNS message setting 'cells' cells (LEDS_PER_CELL LEDs each) to one
+// color; its length
+static size_t makeRuns(uint8_t *msg, uint16_t sequence, const uint8_t *cells, uint8_t count,
+                       uint8_t r, uint8_t g, uint8_t b) {
+  msg[0] = STREAM_MSG_RUNS;
+  msg[1] = sequence & 0xFF;
+  msg[2] = sequence >> 8;
+  size_t length = STREAM_RUNS_HEADER;
+  for (uint8_t i = 0; i < count; i++) {
+    msg[length++] = cells[i] * LEDS_PER_CELL;
+    msg[length++] = LEDS_PER_CELL;
+    msg[length++] = r;
+    msg[length++] = g;
+    msg[length++] = b;
+  }
+  return length;
+}
+
+// The JSON body the web app sends to /api/led for one cell
+static size_t jsonRangeBytes(uint8_t cell, uint8_t r, uint8_t g, uint8_t b) {
+  char body[96];
+  return snprintf(body, sizeof(body), "{\"start\":%d,\"end\":%d,\"color\":{\"r\":%d,\"g\":%d,\"b\":%d}}",
+                  cell * LEDS_PER_CELL, cell * LEDS_PER_CELL + LEDS_PER_CELL - 1, r, g, b);
+}
+
+static void runsUpdates() {
+  uint8_t leds[NUM_LEDS * 3];
+  memset(leds, 0, sizeof(leds));
+  LedStream stream(leds, NUM_LEDS);
+  uint8_t msg[64];
+  unsigned long now = 0;
+  uint16_t resyncSequence;
+
+  // Byte counts: one and two changed cells
+  const uint8_t cells[] = {7, 20};
+  for (uint8_t count = 1; count <= 2; count++) {
+    size_t runsBytes = makeRuns(msg, count, cells, count, 0, 255, 0);
+    size_t jsonBytes = 0;
+    for (uint8_t i = 0; i < count; i++) jsonBytes += jsonRangeBytes(cells[i], 0, 255, 0);
+    printf("%u changed cell%s: RUNS %2zu bytes, JSON ranges %3zu bytes in %u request%s\n",
+           count, count > 1 ? "s" : " ", runsBytes, jsonBytes, count, count > 1 ? "s" : "");
+  }
+
+  // A run sets its LEDs and is shown
+  size_t length = makeRuns(msg, 1, cells, 1, 0, 255, 0);
+  check(stream.handleMessage(msg, length) && stream.lastChanged() == LEDS_PER_CELL, "run sets its LEDs");
+  check(leds[cells[0] * LEDS_PER_CELL * 3 + 1] == 255 && leds[(cells[0] * LEDS_PER_CELL + 1) * 3 + 1] == 255 &&
+        leds[(cells[0] * LEDS_PER_CELL + 2) * 3 + 1] == 0, "run covers exactly its LEDs");
+  check(stream.service(now), "changed LEDs shown");
+
+  // The same colors again: nothing changes, nothing is shown
+  now += 100000;
+  length = makeRuns(msg, 2, cells, 1, 0, 255, 0);
+  check(stream.handleMessage(msg, length) && stream.lastChanged() == 0, "unchanged update accepted");
+  check(!stream.service(now) && stream.stats().unchanged == 1, "unchanged update shown");
+
+  // A gap: updates 3 and 4 lost
+  length = makeRuns(msg, 5, cells + 1, 1, 255, 0, 0);
+  check(stream.handleMessage(msg, length), "update after a gap applied");
+  check(stream.stats().lost == 2, "lost updates counted");
+  check(stream.takeResync(&resyncSequence) && resyncSequence == 5, "gap asks for a resync");
+  check(!stream.takeResync(&resyncSequence), "resync asked twice");
+
+  // A late update (4 after 5) is dropped
+  length = makeRuns(msg, 4, cells + 1, 1, 0, 0, 255);
+  check(!stream.handleMessage(msg, length) && stream.stats().stale == 1, "late update applied");
+  check(leds[cells[1] * LEDS_PER_CELL * 3] == 255 && leds[cells[1] * LEDS_PER_CELL * 3 + 2] == 0,
+        "late update overwrote a newer one");
+  length = makeRuns(msg, 6, cells + 1, 1, 0, 0, 255);
+  check(stream.handleMessage(msg, length) && stream.lastChanged() == LEDS_PER_CELL, "sequence goes on after a late update");
+
+  // Malformed runs write nothing
+  const uint8_t emptyRun[] = {STREAM_MSG_RUNS, 7, 0, 0, 0, 1, 2, 3};
+  const uint8_t pastEnd[] = {STREAM_MSG_RUNS, 7, 0, NUM_LEDS - 1, 2, 1, 2, 3};
+  const uint8_t cutShort[] = {STREAM_MSG_RUNS, 7, 0, 0, 1, 1, 2};
+  check(!stream.handleMessage(emptyRun, sizeof(emptyRun)) && !stream.handleMessage(pastEnd, sizeof(pastEnd)) &&
+        !stream.handleMessage(cutShort, sizeof(cutShort)) && stream.stats().rejected == 3, "malformed run accepted");
+  check(leds[0] == 0 && leds[(NUM_LEDS - 1) * 3] == 0 && stream.stats().lost == 2, "malformed run wrote the LEDs");
+
+  // A client that starts over (a reloaded page) after 500 updates: its
+  // full frame restarts the sequence, and its count from 1 is taken
+  for (uint16_t sequence = 7; sequence <= 500; sequence++) {
+    length = makeRuns(msg, sequence, cells, 1, sequence & 0xFF, 0, 0);
+    stream.handleMessage(msg, length);
+  }
+  length = makeRuns(msg, 510, cells, 1, 1, 2, 3);
+  stream.handleMessage(msg, length);
+  uint8_t frame[2 + NUM_LEDS * 3];
+  frame[0] = STREAM_MSG_FRAME;
+  frame[1] = 0;
+  memset(frame + 2, 0x20, NUM_LEDS * 3);
+  unsigned long staleBefore = stream.stats().stale;
+  check(stream.handleMessage(frame, sizeof(frame)), "full frame after a restart applied");
+  check(!stream.takeResync(&resyncSequence), "full frame leaves the resync asked before it");
+  unsigned int taken = 0;
+  for (uint16_t sequence = 1; sequence <= 600; sequence++) {
+    length = makeRuns(msg, sequence, cells, 1, sequence & 0xFF, 1, 0);
+    if (stream.handleMessage(msg, length)) taken++;
+  }
+  printf("client restarted after 500 updates: %u of 600 updates taken after its full frame\n", taken);
+  check(taken == 600 && stream.stats().stale == staleBefore && !stream.takeResync(&resyncSequence),
+        "updates of a restarted client dropped as stale");
+}
+
+int main() {
+  static const unsigned int frameRates[] = {30, 60, 120, 500};
+  for (unsigned int rate : frameRates) {
+    Result r = run(rate, false, STREAM_MAX_FPS);
+    report("frames", rate, STREAM_MAX_FPS, r);
+    if (rate < STREAM_MAX_FPS) check(r.superseded == 0, "frames dropped below the frame rate limit");
+  }
+  report("deltas", 1000, STREAM_MAX_FPS, run(1000, true, STREAM_MAX_FPS));
+  report("frames", 120, 30, run(120, false, 30));
+
+  // Malformed messages write nothing
+  uint8_t leds[NUM_LEDS * 3];
+  memset(leds, 0x11, sizeof(leds));
+  LedStream stream(leds, NUM_LEDS);
+  const uint8_t tooLong[] = {STREAM_MSG_FRAME, NUM_LEDS - 1, 1, 2, 3, 4, 5, 6};
+  const uint8_t partial[] = {STREAM_MSG_FRAME, 0, 1, 2};
+  const uint8_t badDelta[] = {STREAM_MSG_DELTA, 0, 9, 9, 9, NUM_LEDS, 9, 9, 9};
+  const uint8_t unknown[] = {0x7F, 0};
+  check(!stream.handleMessage(tooLong, sizeof(tooLong)) && !stream.handleMessage(partial, sizeof(partial)) &&
+        !stream.handleMessage(badDelta, sizeof(badDelta)) && !stream.handleMessage(unknown, sizeof(unknown)),
+        "malformed message accepted");
+  bool untouched = true;
+  for (size_t i = 0; i < sizeof(leds); i++) {
+    if (leds[i] != 0x11) untouched = false;
+  }
+  check(untouched && !stream.pending() && stream.stats().rejected == 4, "malformed message wrote the LEDs");
+  const uint8_t setFps[] = {STREAM_MSG_SET_FPS, 25};
+  check(stream.handleMessage(setFps, sizeof(setFps)) && stream.maxFps() == 25 && !stream.pending(),
+        "SET_FPS changes the limit without a show");
+
+  runsUpdates();
+
+  printf(failures ? "FAILED (%d)\n" : "OK\n", failures);
+  return failures ? 1 : 0;
+}
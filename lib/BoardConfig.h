@@ -6,6 +6,8 @@
 // Common SPI pins for all readers
 #define COMMON_SS_PIN 10  // Shared SS pin for all readers
 #define COMMON_RST_PIN 9  // Shared Reset pin for all readers
+#define COMMON_SCK_PIN 13  // Shared soft-SPI clock for all readers
+#define COMMON_MOSI_PIN 11  // Shared soft-SPI MOSI for all readers
 
 // Individual MISO pins for each reader (instead of individual SS pins)
 #define MISO_PIN1 2  // MISO pin for first reader
@@ -15,6 +17,9 @@
 #define MISO_PIN5 A0  // MISO pin for fifth reader
 #define MISO_PIN6 A2  // MISO pin for sixth reader
 
+// Serial monitor and telemetry speed
+#define SERIAL_BAUD 115200
+
 // LED data pins
 #define LED_RING_CHAIN_PIN1 5  // LED chain 1 data pin (rings 1-4)
 #define LED_RING_CHAIN_PIN2 7  // LED chain 2 data pin (rings 5-8)
@@ -22,6 +27,7 @@
 // LED configuration
 #define NUM_LEDS_PER_RING 12
 #define NUM_RINGS 8
+#define NUM_LED_CHAINS 2
 #define LEDS_PER_CHAIN (NUM_LEDS_PER_RING * 4)
 #define TOTAL_LEDS (NUM_LEDS_PER_RING * NUM_RINGS)
 
@@ -30,6 +36,38 @@
 #define MATRIX_COLS 6
 #define NUM_READERS 6
 
+// One bit per reader (bit 0 = reader 1), sized for NUM_READERS
+#if NUM_READERS <= 8
+typedef uint8_t ReaderMask;
+#elif NUM_READERS <= 16
+typedef uint16_t ReaderMask;
+#elif NUM_READERS <= 32
+typedef uint32_t ReaderMask;
+#else
+#error "NUM_READERS does not fit in a ReaderMask"
+#endif
+
+// Reader polling: every reader is polled on its own schedule (ms).
+// Empty readers are polled often so a placed tag shows up quickly; a
+// reader whose tag just came or went gets POLL_BURST_COUNT quick polls;
+// a reader that keeps the same tag only gets a presence check now and
+// then, with its UID read again every POLL_UID_EVERY checks.
+#define POLL_EMPTY_MS 50
+#define POLL_BURST_MS 25
+#define POLL_BURST_COUNT 4
+#define POLL_STABLE_MS 200
+#define POLL_UID_EVERY 5
+// Readers due within this many ms join a scan that starts anyway
+#define POLL_JOIN_MS 25
+
+// Reader bus time allowed per second (us); scans wait for the next second
+// once it is used up
+#define RFID_BUS_BUDGET_US 200000
+// A running transaction is polled at most this often (us), and the reader
+// configuration is checked at most this often (ms)
+#define SCAN_POLL_US 2000
+#define SESSION_CHECK_MS 1000
+
 // Environment attributes as bit flags
 enum EnvironmentAttribute {
     NONE = 0,
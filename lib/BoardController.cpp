@@ -5,18 +5,40 @@ void BoardController::begin() {
     // Initialize SPI
     SPI.begin();
     
-    // We now use a different approach with MISO pins
-    // that will be initialized in checkReader() when needed
-    Serial.println(F("Readers will be initialized with separate MISO pins"));
-    
-    // Initialize FastLED for our two LED chains
-    FastLED.addLeds<WS2812B, LED_RING_CHAIN_PIN1, GRB>(leds, 0, LEDS_PER_CHAIN);
-    FastLED.addLeds<WS2812B, LED_RING_CHAIN_PIN2, GRB>(leds, LEDS_PER_CHAIN, LEDS_PER_CHAIN);
+    // Every reader has its own MISO pin on the shared soft-SPI bus
+    static const uchar misoPins[NUM_READERS] = {
+        MISO_PIN1, MISO_PIN2, MISO_PIN3, MISO_PIN4, MISO_PIN5, MISO_PIN6
+    };
+    readerBank.beginBank(COMMON_SCK_PIN, COMMON_MOSI_PIN, misoPins, NUM_READERS,
+                         COMMON_SS_PIN, COMMON_RST_PIN);
+    
+    // Reset and configure the readers once; scans only verify the config
+    readerBank.startSession();
+    Serial.println(F("Readers initialized as one bank with separate MISO pins"));
+    
+    // Initialize FastLED for our two LED chains. The controllers are kept
+    // so a chain is only pushed out when one of its rings changed.
+    ledChains[0] = &FastLED.addLeds<WS2812B, LED_RING_CHAIN_PIN1, GRB>(leds, 0, LEDS_PER_CHAIN);
+    ledChains[1] = &FastLED.addLeds<WS2812B, LED_RING_CHAIN_PIN2, GRB>(leds, LEDS_PER_CHAIN, LEDS_PER_CHAIN);
     FastLED.setBrightness(30);  // Set global brightness
     
     // Clear all LEDs
+    memset(&ledStats, 0, sizeof(ledStats));
+    statsWindowStart = millis();
+    windowShows = 0;
+    windowShowMicros = 0;
+    loopWindowStart = millis();
+    windowUpdates = 0;
+    windowMaxUpdateMicros = 0;
     FastLED.clear();
-    FastLED.show();
+    dirtyChains = (1 << NUM_LED_CHAINS) - 1;
+    flushLeds();
+    
+    // Effects are drawn straight into the ring's part of the LED buffer
+    effects.begin();
+    for (uint8_t i = 1; i <= NUM_READERS; i++) {
+        effects.attachRing(i, &leds[getRingStartLED(i)]);
+    }
     
     // Initialize reader states
     for (uint8_t i = 0; i < NUM_READERS; i++) {
@@ -27,11 +49,19 @@ void BoardController::begin() {
         // Initialize effect states
         effectStates[i].environmentHappy = false;
         effectStates[i].neighborRelationshipGood = false;
-        effectStates[i].lastEffectTime = 0;
+        effectStates[i].verdict = VERDICT_NONE;
     }
+    evaluationCount = 0;
+    occupiedReaders = 0;
     
-    // Initialize the grid
-    initializeGrid();
+    // Learn mode off, nothing captured
+    learning = false;
+    learnPlant = UNKNOWN;
+    learnCount = 0;
+    learnSaved = 0;
+    learnSaving = false;
+    lastCaptureTime = 0;
+    capturedTotal = 0;
     
     // Initialize plant database
     PlantDatabase::initialize();
@@ -39,6 +69,33 @@ void BoardController::begin() {
     // Set default game mode
     currentGameMode = ENVIRONMENT_MODE;
     
+    // No scan running yet; every reader starts out empty and due
+    scanPhase = SCAN_IDLE;
+    scanMask = 0;
+    watchMask = 0;
+    scanWakeup = false;
+    scanUidMask = 0;
+    scanStartTransactions = 0;
+    onlineReaders = 0;
+    lastSessionCheck = millis() - SESSION_CHECK_MS;
+    lastPollMicros = micros();
+    for (uint8_t i = 0; i < NUM_READERS; i++) {
+        polls[i].mode = POLL_EMPTY;
+        polls[i].burstLeft = 0;
+        polls[i].checksSinceUid = 0;
+        polls[i].nextPoll = millis();
+        polls[i].lastMiss = millis();
+    }
+    memset(pollStats, 0, sizeof(pollStats));
+    memset(&scanStats, 0, sizeof(scanStats));
+    busBudget = RFID_BUS_BUDGET_US;
+    windowScans = 0;
+    windowBusMicros = 0;
+    windowDeferred = false;
+    memset(phaseCost, 0, sizeof(phaseCost));
+    phaseBusMicros = 0;
+    sessionHeld = false;
+    
     Serial.println(F("Board controller initialized"));
     Serial.println(F("Game Mode: Environment Check"));
     
@@ -48,199 +105,166 @@ void BoardController::begin() {
 
 void BoardController::update() {
     unsigned long currentMillis = millis();
-    static unsigned long lastReadAttempts[NUM_READERS] = {0};
+    unsigned long startMicros = micros();
+    
+    // Advance the reader scan by one step - this never waits for the cards,
+    // so LED effects and serial input keep running while they answer
+    advanceScan(currentMillis);
     
-    // Check each reader at appropriate intervals
+    // Check for tag timeouts: a tag is gone once a check that ran missed
+    // it more than TAG_TIMEOUT after it last answered. Checks the bus
+    // budget holds back do not count, so a tag that stays put is never
+    // timed out for want of scans.
     for (uint8_t i = 0; i < NUM_READERS; i++) {
-        // Skip if this reader hasn't been placed on the grid
-        if (readerPositions[i] == nullptr) continue;
-        
-        // Time to check this reader?
-        if (currentMillis - lastReadAttempts[i] >= READ_INTERVAL) {
-            lastReadAttempts[i] = currentMillis;
-            
-            if (checkReader(i)) {
-                readerStates[i].lastReadTime = currentMillis;
-                
-                // If this is a new tag detection
-                if (!readerStates[i].tagPresent) {
-                    readerStates[i].tagPresent = true;
-                    Serial.print(F("Reader "));
-                    Serial.print(i + 1);
-                    Serial.println(F(" - Tag detected"));
-                    
-                    // Evaluate plant interactions whenever a new plant is placed
-                    evaluatePlantInteractions(i);
-                }
-            }
-        }
-        
-        // Check for tag timeouts
         if (readerStates[i].tagPresent && 
-            (currentMillis - readerStates[i].lastReadTime > TAG_TIMEOUT)) {
+            (long)(polls[i].lastMiss - readerStates[i].lastReadTime) > (long)TAG_TIMEOUT) {
             readerStates[i].tagPresent = false;
             readerStates[i].currentPlant = UNKNOWN;
+            occupiedReaders &= ~((ReaderMask)1 << i);
             
-            Serial.print(F("Reader "));
-            Serial.print(i + 1);
-            Serial.println(F(" - Tag removed"));
+            LOG_INFO(F("Reader "), i + 1, F(" - Tag removed"));
+            Telemetry::tagRemoved(i);
+            // Empty from now on, even if no scan saw it go (bus budget)
+            polls[i].lastMiss = currentMillis;
+            startBurst(i);
             
-            // Turn off the ring
-            clearRing(i + 1);
+            if (learning) {
+                // No game in learn mode, the ring just goes off
+                clearRing(i + 1);
+            } else {
+                // Turn off the ring and update the neighbors
+                tagChanged(i);
+            }
         }
     }
     
-    // Update continuous effects for active readers
-    updateContinuousEffects();
-}
-
-void BoardController::updateContinuousEffects() {
-    unsigned long currentMillis = millis();
+    // Write captured tags to EEPROM, a byte at a time
+    TagStore::service();
+    saveLearnedTags(currentMillis);
     
-    // Check each reader
+    // Advance the ring animations
+    uint8_t changedRings = effects.update(currentMillis);
     for (uint8_t i = 0; i < NUM_READERS; i++) {
-        // Skip if this reader hasn't been placed or has no tag
-        if (readerPositions[i] == nullptr || !readerStates[i].tagPresent) {
-            continue;
-        }
-        
-        // Time to update the effect?
-        if (currentMillis - effectStates[i].lastEffectTime >= EFFECT_INTERVAL) {
-            effectStates[i].lastEffectTime = currentMillis;
-            
-            // Apply the appropriate continuous effect
-            applyContinuousEffect(i);
-        }
-    }
+        if (changedRings & (1 << i)) markRingDirty(i + 1);
+    }
+    
+    // Push out everything that changed during this update, once
+    flushLeds();
+    
+    // Loop timing and error counters for the telemetry, once a second
+    unsigned long elapsed = micros() - startMicros;
+    windowUpdates++;
+    if (elapsed > windowMaxUpdateMicros) windowMaxUpdateMicros = elapsed;
+    if (currentMillis - loopWindowStart >= 1000) {
+        Telemetry::loopStats(windowUpdates, windowMaxUpdateMicros, ledStats.showsPerSecond);
+        Telemetry::errors(readerBank.sessionReinits(), Log.getDropped());
+        scanStats.scansPerSecond = windowScans;
+        scanStats.busMicrosPerSecond = windowBusMicros;
+        windowScans = 0;
+        windowBusMicros = 0;
+        windowDeferred = false;
+        loopWindowStart = currentMillis;
+        windowUpdates = 0;
+        windowMaxUpdateMicros = 0;
+    }
+    
+    // Hand the log to the serial port, as far as it takes it without waiting
+    Log.drain();
 }
 
-void BoardController::applyContinuousEffect(uint8_t readerNum) {
-    PlantID currentPlant = readerStates[readerNum].currentPlant;
-    if (currentPlant == UNKNOWN) return;
-    
-    GridPosition* pos = readerPositions[readerNum];
-    if (!pos) return;
+ReaderVerdict BoardController::evaluateReader(uint8_t readerNum) {
+    evaluationCount++;
     
-    bool showEffect = false;
-    bool growthCondition = false;
-    bool dislikeCondition = false;
-    
-    // Check environment conditions if in environment or combined mode
-    if (currentGameMode == ENVIRONMENT_MODE || currentGameMode == COMBINED_MODE) {
-        bool environmentHappy = PlantDatabase::plantThrives(currentPlant, pos->attributes);
-        bool environmentOkay = PlantDatabase::plantTolerates(currentPlant, pos->attributes);
-        
-        effectStates[readerNum].environmentHappy = environmentHappy;
-        
-        if (!environmentOkay) {
-            dislikeCondition = true;
-            showEffect = true;
-        } else if (environmentHappy) {
-            growthCondition = true;
-            showEffect = true;
+    PlantID currentPlant = readerStates[readerNum].currentPlant;
+    ReaderLayout pos;
+    if (!readerStates[readerNum].tagPresent || currentPlant == UNKNOWN ||
+        !BoardLayout::getReader(readerNum, &pos)) {
+        return VERDICT_NONE;
+    }
+    
+    // Environment at the reader's position
+    bool environmentHappy = PlantDatabase::plantThrives(currentPlant, pos.attributes);
+    bool environmentOkay = PlantDatabase::plantTolerates(currentPlant, pos.attributes);
+    effectStates[readerNum].environmentHappy = environmentHappy;
+    
+    // Neighboring plants, rated in one go (only neighbors with a tag count)
+    PlantRelationship neighborhood = NEUTRAL;
+    if (currentGameMode != ENVIRONMENT_MODE) {
+        ReaderMask neighbors = pos.neighbors & occupiedReaders;
+        PlantSet neighborPlants;
+        neighborPlants.clear();
+        for (uint8_t neighborReaderIndex = 0; neighbors; neighborReaderIndex++, neighbors >>= 1) {
+            if (neighbors & 1) {
+                neighborPlants.set(readerStates[neighborReaderIndex].currentPlant);
+            }
         }
+        neighborhood = PlantDatabase::getNeighborhoodRelationship(currentPlant, neighborPlants);
     }
+    effectStates[readerNum].neighborRelationshipGood = (neighborhood == LIKES);
     
-    // Check neighbor relationships if in neighbor or combined mode
-    if ((currentGameMode == NEIGHBORS_MODE || currentGameMode == COMBINED_MODE) && !dislikeCondition) {
-        effectStates[readerNum].neighborRelationshipGood = false;
-        bool hasNeighbor = false;
-        
-        // Check all possible neighbor positions
-        for (int8_t rowOffset = -1; rowOffset <= 1; rowOffset++) {
-            for (int8_t colOffset = -1; colOffset <= 1; colOffset++) {
-                // Skip the center (self)
-                if (rowOffset == 0 && colOffset == 0) continue;
-                
-                // Calculate neighbor position
-                uint8_t neighborRow = pos->row + rowOffset;
-                uint8_t neighborCol = pos->col + colOffset;
-                
-                // Skip if out of bounds
-                if (neighborRow >= MATRIX_ROWS || neighborCol >= MATRIX_COLS) continue;
-                
-                // Check if there's a reader at this position
-                int8_t neighborReaderIndex = grid[neighborRow][neighborCol].readerIndex;
-                if (neighborReaderIndex < 0) continue;
-                
-                // Skip if no tag on this reader
-                if (!readerStates[neighborReaderIndex].tagPresent) continue;
-                
-                hasNeighbor = true;
-                
-                // Check the relationship
-                PlantID neighborPlant = readerStates[neighborReaderIndex].currentPlant;
-                PlantRelationship relationship = PlantDatabase::getRelationship(currentPlant, neighborPlant);
-                
-                if (relationship == HATES) {
-                    dislikeCondition = true;
-                    showEffect = true;
-                    break;  // One bad relationship is enough for dislike
-                } else if (relationship == LIKES) {
-                    effectStates[readerNum].neighborRelationshipGood = true;
-                    growthCondition = true;
-                    showEffect = true;
-                }
-            }
-            if (dislikeCondition) break;  // Exit the outer loop too if we found a dislike
-        }
-        
-        // If no neighbors, don't show an effect for neighbor mode
-        if (!hasNeighbor && currentGameMode == NEIGHBORS_MODE) {
-            showEffect = false;
-        }
+    switch (currentGameMode) {
+        case ENVIRONMENT_MODE:
+            if (!environmentOkay) return VERDICT_DISLIKES;
+            return environmentHappy ? VERDICT_LIKES : VERDICT_NEUTRAL;
+            
+        case NEIGHBORS_MODE:
+            if (neighborhood == HATES) return VERDICT_DISLIKES;
+            return neighborhood == LIKES ? VERDICT_LIKES : VERDICT_NEUTRAL;
+            
+        case COMBINED_MODE:
+        default:
+            // Growth needs both a good spot and good neighbors
+            if (!environmentOkay || neighborhood == HATES) return VERDICT_DISLIKES;
+            return (environmentHappy && neighborhood == LIKES) ? VERDICT_LIKES : VERDICT_NEUTRAL;
     }
+}
+
+void BoardController::reevaluate(ReaderMask affected, ReaderMask forced) {
+    affected = (affected | forced) & PLACED_READERS;
     
-    // Apply the appropriate effect
-    if (showEffect) {
-        // For combined mode, we need to have both conditions good for growth
-        if (currentGameMode == COMBINED_MODE) {
-            growthCondition = effectStates[readerNum].environmentHappy && 
-                             effectStates[readerNum].neighborRelationshipGood;
-        }
+    for (uint8_t i = 0; affected; i++, affected >>= 1) {
+        if (!(affected & 1)) continue;
         
-        if (dislikeCondition) {
-            // Show dislike effect
-            showDislikesEffect(readerNum + 1);
-        } else if (growthCondition) {
-            // Show growth effect - for a single reader we'll just use green pulses
-            // For multiple readers we'll handle in the main loop with the growthEffect method
-            showLikesEffect(readerNum + 1);
-        } else {
-            // Neutral case
-            showNeutralEffect(readerNum + 1);
+        // A forced ring restarts even with the same verdict, unless it
+        // would only turn an already dark ring off again
+        ReaderVerdict verdict = evaluateReader(i);
+        bool restart = (forced & ((ReaderMask)1 << i)) &&
+                       (verdict != VERDICT_NONE || effects.isActive(i + 1));
+        if (verdict != effectStates[i].verdict || restart) {
+            effectStates[i].verdict = verdict;
+            showVerdict(i);
+            Telemetry::verdict(i, verdict, currentGameMode);
         }
     }
 }
 
-bool BoardController::placeReader(uint8_t readerNum, uint8_t row, uint8_t col, uint8_t attributes) {
-    if (readerNum < 1 || readerNum > NUM_READERS || 
-        row >= MATRIX_ROWS || col >= MATRIX_COLS) {
-        Serial.print(F("Invalid reader position: Reader "));
-        Serial.print(readerNum);
-        Serial.print(F(" at ("));
-        Serial.print(row);
-        Serial.print(F(","));
-        Serial.print(col);
-        Serial.println(F(")"));
-        return false;
+void BoardController::showVerdict(uint8_t readerNum) {
+    uint8_t ringNum = readerNum + 1;
+    
+    // The new verdict replaces whatever the ring was showing
+    effects.stop(ringNum);
+    switch (effectStates[readerNum].verdict) {
+        case VERDICT_LIKES:
+            showLikesEffect(ringNum);
+            break;
+        case VERDICT_DISLIKES:
+            showDislikesEffect(ringNum);
+            break;
+        case VERDICT_NEUTRAL:
+            showNeutralEffect(ringNum);
+            break;
+        case VERDICT_NONE:
+        default:
+            clearRing(ringNum);
+            break;
     }
-    
-    // Store reader position and attributes
-    grid[row][col].readerIndex = readerNum - 1;  // 0-based index internally
-    grid[row][col].attributes = attributes;
-    readerPositions[readerNum - 1] = &grid[row][col];
-    
-    Serial.print(F("Reader "));
-    Serial.print(readerNum);
-    Serial.print(F(" placed at ("));
-    Serial.print(row);
-    Serial.print(F(","));
-    Serial.print(col);
-    Serial.print(F(") with attributes: "));
-    Serial.println(attributes, BIN);
-    
-    return true;
+}
+
+ReaderVerdict BoardController::getReaderVerdict(uint8_t readerIndex) {
+    if (readerIndex < NUM_READERS) {
+        return effectStates[readerIndex].verdict;
+    }
+    return VERDICT_NONE;
 }
 
 bool BoardController::areNeighbors(uint8_t row1, uint8_t col1, uint8_t row2, uint8_t col2) {
@@ -259,40 +283,49 @@ bool BoardController::areNeighbors(uint8_t row1, uint8_t col1, uint8_t row2, uin
 }
 
 uint8_t BoardController::getReaderAt(uint8_t row, uint8_t col) {
-    if (row < MATRIX_ROWS && col < MATRIX_COLS && grid[row][col].readerIndex >= 0) {
-        return grid[row][col].readerIndex + 1; // Return 1-based reader number
-    }
-    return 0; // No reader at this position
+    return BoardLayout::readerAt(row, col) + 1; // 1-based reader number, 0 if none
 }
 
 uint8_t BoardController::getAttributesAt(uint8_t row, uint8_t col) {
-    if (row < MATRIX_ROWS && col < MATRIX_COLS) {
-        return grid[row][col].attributes;
+    // Only the cells with a reader have an environment
+    ReaderLayout entry;
+    int8_t readerIndex = BoardLayout::readerAt(row, col);
+    if (readerIndex >= 0 && BoardLayout::getReader(readerIndex, &entry)) {
+        return entry.attributes;
     }
     return NONE;
 }
 
-GridPosition* BoardController::getReaderPosition(uint8_t readerIndex) {
+ReaderMask BoardController::getNeighborMask(uint8_t readerIndex) {
+    return BoardLayout::getNeighbors(readerIndex);
+}
+
+bool BoardController::getReaderPosition(uint8_t readerIndex, GridPosition* pos) {
+    ReaderLayout entry;
+    if (!BoardLayout::getReader(readerIndex, &entry)) return false;
+    
+    pos->row = entry.row;
+    pos->col = entry.col;
+    pos->attributes = entry.attributes;
+    pos->readerIndex = readerIndex;
+    return true;
+}
+
+const ReaderState* BoardController::getReaderState(uint8_t readerIndex) {
     if (readerIndex < NUM_READERS) {
-        return readerPositions[readerIndex];
+        return &readerStates[readerIndex];
     }
     return nullptr;
 }
 
 void BoardController::showLikesEffect(uint8_t readerNum) {
     // Pulsing green effect for positive feedback
-    for (int i = 0; i < 3; i++) { // Pulse 3 times
-        pulseEffect(readerNum, 0, 255, 0);
-        delay(100);
-    }
+    effects.play(readerNum, EFFECT_LIKES, 0, 255, 0);
 }
 
 void BoardController::showDislikesEffect(uint8_t readerNum) {
     // Pulsing red effect for negative feedback
-    for (int i = 0; i < 3; i++) { // Pulse 3 times
-        pulseEffect(readerNum, 255, 0, 0);
-        delay(100);
-    }
+    effects.play(readerNum, EFFECT_DISLIKES, 255, 0, 0);
 }
 
 void BoardController::showNeutralEffect(uint8_t readerNum) {
@@ -305,122 +338,308 @@ void BoardController::clearRing(uint8_t readerNum) {
 }
 
 void BoardController::pulseEffect(uint8_t readerNum, uint8_t r, uint8_t g, uint8_t b) {
-    // Save current color
-    uint8_t savedR = r;
-    uint8_t savedG = g;
-    uint8_t savedB = b;
-    
-    // Pulse down and up
-    for (int i = 10; i >= 2; i--) {
-        setRingColorWithBrightness(readerNum, savedR, savedG, savedB, i * 10);
-        delay(20);
-    }
-    for (int i = 2; i <= 10; i++) {
-        setRingColorWithBrightness(readerNum, savedR, savedG, savedB, i * 10);
-        delay(20);
-    }
-    
-    // Restore full brightness
-    setRingColor(readerNum, savedR, savedG, savedB);
+    // Pulse down and up, ending at full brightness
+    effects.play(readerNum, EFFECT_PULSE, r, g, b);
 }
 
 void BoardController::growthEffect(uint8_t readerNum, uint8_t targetReaderNum) {
     // Green growing effect between two plants
-    for (int i = 0; i < 5; i++) {
-        // Start dim and grow brighter
-        setRingColorWithBrightness(readerNum, 0, 200, 0, 20 * (i+1));
-        setRingColorWithBrightness(targetReaderNum, 0, 200, 0, 20 * (i+1));
-        delay(100);
-    }
+    effects.play(readerNum, EFFECT_GROWTH, 0, 200, 0);
+    effects.play(targetReaderNum, EFFECT_GROWTH, 0, 200, 0);
 }
 
 void BoardController::rainbowEffect(uint8_t readerNum, uint8_t duration) {
-    uint16_t startLED = getRingStartLED(readerNum);
-    if (startLED == 0xFFFF) return; // Invalid ring
-    
-    for (int j = 0; j < duration; j++) {
-        for (int i = 0; i < NUM_LEDS_PER_RING; i++) {
-            // Create rainbow pattern
-            leds[startLED + i] = CHSV((i * 256 / NUM_LEDS_PER_RING) + j, 255, 255);
-        }
-        FastLED.show();
-        delay(15);
-    }
+    effects.play(readerNum, EFFECT_RAINBOW, 0, 0, 0, duration);
 }
 
-void BoardController::initializeGrid() {
-    // Initialize the grid with default values
-    for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
-        for (uint8_t col = 0; col < MATRIX_COLS; col++) {
-            grid[row][col].row = row;
-            grid[row][col].col = col;
-            grid[row][col].attributes = NONE;
-            grid[row][col].readerIndex = -1; // No reader at this position
-        }
-    }
-    
-    // Initialize reader positions array to nullptr
-    for (uint8_t i = 0; i < NUM_READERS; i++) {
-        readerPositions[i] = nullptr;
-    }
+bool BoardController::isRingAnimating(uint8_t readerNum) {
+    return effects.isActive(readerNum);
 }
 
-bool BoardController::checkReader(uint8_t readerNum) {
-    if (readerNum >= NUM_READERS) return false;
-    
-    // Initialize appropriate reader with its MISO pin
-    // Using RFID1 library syntax which is different from MFRC522
-    switch (readerNum) {
-        case 0:
-            readers[readerNum].begin(COMMON_SS_PIN, 13, 11, MISO_PIN1, COMMON_SS_PIN, COMMON_RST_PIN);
-            break;
-        case 1:
-            readers[readerNum].begin(COMMON_SS_PIN, 13, 11, MISO_PIN2, COMMON_SS_PIN, COMMON_RST_PIN);
-            break;
-        case 2:
-            readers[readerNum].begin(COMMON_SS_PIN, 13, 11, MISO_PIN3, COMMON_SS_PIN, COMMON_RST_PIN);
+void BoardController::advanceScan(unsigned long currentMillis) {
+    static unsigned int lastReinits = 0;
+    
+    uchar serNums[NUM_READERS][5];
+    ReaderMask readMask = 0;
+    unsigned long busStart = micros();
+    unsigned long sessionTime = 0;
+    ScanPhase startPhase = scanPhase;
+    
+    // Every poll reads CommIrqReg on the whole bank; polling faster than
+    // the cards answer only burns bus time
+    if (scanPhase != SCAN_IDLE) {
+        if (busStart - lastPollMicros < SCAN_POLL_US) return;
+        lastPollMicros = busStart;
+    }
+    
+    switch (scanPhase) {
+        case SCAN_IDLE: {
+            ReaderMask due = dueReaders(currentMillis);
+            if (!due) return;
+            
+            // A scan only starts when its request and the HALT after it fit
+            // in what is left of the budget, at their worst; the UIDs are
+            // only read if that fits too (below). So the bus time stays
+            // under the budget, instead of a scan started just under it
+            // running past it.
+            // When the session check does not fit along with the scan, the
+            // scan goes first and the check takes its turn next time, so a
+            // small budget does neither of them forever.
+            unsigned long scanCost = phaseCost[SCAN_REQUEST] + phaseCost[SCAN_HALT];
+            bool sessionDue = currentMillis - lastSessionCheck >= SESSION_CHECK_MS;
+            bool withSession = sessionDue && fitsBudget(phaseCost[SCAN_IDLE] + scanCost);
+            bool sessionOnly = sessionDue && !withSession && fitsBudget(phaseCost[SCAN_IDLE]) &&
+                               (sessionHeld || !fitsBudget(scanCost));
+            if (!withSession && !sessionOnly && !fitsBudget(scanCost)) {
+                holdBack();
+                return;
+            }
+            if (sessionDue && !withSession && !sessionOnly) sessionHeld = true;
+            
+            // The readers keep their configuration between scans; only chips
+            // that were reset or browned out get it written again. Reading
+            // it back is a good part of a scan's bus time, so it is done
+            // once every SESSION_CHECK_MS.
+            if (withSession || sessionOnly) {
+                unsigned long sessionStart = micros();
+                lastSessionCheck = currentMillis;
+                sessionHeld = false;
+                onlineReaders = readerBank.checkSession(PLACED_READERS);
+                sessionTime = micros() - sessionStart;
+                if (sessionTime > phaseCost[SCAN_IDLE]) phaseCost[SCAN_IDLE] = sessionTime;
+                if (readerBank.sessionReinits() != lastReinits) {
+                    lastReinits = readerBank.sessionReinits();
+                    LOG_WARN(F("Reader configuration restored after a chip reset"));
+                }
+                if (sessionOnly) {
+                    // No room left for the scan in this second
+                    holdBack();
+                    break;
+                }
+            }
+            scanMask = due & onlineReaders;
+            // A reader that did not answer the session check cannot see
+            // its tag: its check counts as missed
+            for (uint8_t i = 0; i < NUM_READERS; i++) {
+                if ((due & ~onlineReaders & ((ReaderMask)1 << i)) && readerStates[i].tagPresent) {
+                    polls[i].lastMiss = currentMillis;
+                }
+            }
+            if (!scanMask) {
+                schedulePolls(due, currentMillis);
+                break;
+            }
+            
+            // Between scans every tag is halted, the only state in which it
+            // ignores frames meant for the other readers (they share SS, so
+            // every frame goes out on all of them). A halted tag answers
+            // WUPA only, so readers that hold a tag or just lost one are
+            // checked with WUPA, and everything it woke is halted again.
+            // When only empty readers are due, REQA finds a new tag without
+            // waking the halted ones, and no HALT is needed. The occupied
+            // readers listen in: their own tag ignores the REQA, so an
+            // answer there is a new tag and its UID is read.
+            scanWakeup = false;
+            for (uint8_t i = 0; i < NUM_READERS; i++) {
+                if ((scanMask & ((ReaderMask)1 << i)) &&
+                    (readerStates[i].tagPresent || polls[i].mode == POLL_BURST)) {
+                    scanWakeup = true;
+                }
+            }
+            watchMask = scanWakeup ? 0 : occupiedReaders & onlineReaders & ~scanMask;
+            scanUidMask = 0;
+            scanStartTransactions = readerBank.transactions();
+            readerBank.startRequest(scanWakeup ? PICC_REQALL : PICC_REQIDL, scanMask | watchMask);
+            lastPollMicros = micros();
+            scanStats.scans++;
+            windowScans++;
+            scanPhase = SCAN_REQUEST;
             break;
-        case 3:
-            readers[readerNum].begin(COMMON_SS_PIN, 13, 11, MISO_PIN4, COMMON_SS_PIN, COMMON_RST_PIN);
+        }
+        
+        case SCAN_REQUEST: {
+            if (!readerBank.poll()) break;
+            
+            // A reader holding the same tag for a while only needs to know
+            // the tag still answers; the UID is read for new tags, during a
+            // burst and every POLL_UID_EVERY checks to catch a quick swap
+            ReaderMask presentMask = readerBank.result(nullptr);
+            ReaderMask uidMask = presentMask & watchMask;
+            for (uint8_t i = 0; i < NUM_READERS; i++) {
+                ReaderMask bit = (ReaderMask)1 << i;
+                if (!(scanMask & bit)) continue;
+                pollStats[i].polls++;
+                
+                if (!(presentMask & bit)) {
+                    polls[i].lastMiss = currentMillis;
+                    // A missed check is looked at closely until the tag
+                    // answers again or times out
+                    if (polls[i].mode == POLL_STABLE) startBurst(i);
+                } else if (!readerStates[i].tagPresent || polls[i].mode != POLL_STABLE ||
+                           ++polls[i].checksSinceUid >= POLL_UID_EVERY) {
+                    uidMask |= bit;
+                } else {
+                    readerStates[i].lastReadTime = currentMillis;
+                }
+            }
+            
+            // Reading the UIDs has to fit the budget with the HALT after it;
+            // if not, the tags that answered count as seen, and their UIDs
+            // are read by a later scan
+            if (uidMask && !fitsBudget(phaseCost[SCAN_ANTICOLL] + phaseCost[SCAN_HALT])) {
+                for (uint8_t i = 0; i < NUM_READERS; i++) {
+                    if ((uidMask & scanMask & ((ReaderMask)1 << i)) && readerStates[i].tagPresent) {
+                        readerStates[i].lastReadTime = currentMillis;
+                    }
+                }
+                uidMask = 0;
+                holdBack();
+            }
+            
+            scanUidMask = uidMask;
+            if (uidMask) {
+                readerBank.startAnticoll(uidMask);
+                scanPhase = SCAN_ANTICOLL;
+            } else if (presentMask || (scanWakeup && (PLACED_READERS & ~scanMask))) {
+                // Every tag the request woke - after a WUPA on the readers
+                // outside the scan too - goes back to halt, or the next
+                // request would find it READY and knock it back to IDLE
+                readerBank.startHalt(scanMask | watchMask);
+                scanPhase = SCAN_HALT;
+            } else {
+                finishScan(currentMillis);
+            }
             break;
-        case 4:
-            readers[readerNum].begin(COMMON_SS_PIN, 13, 11, MISO_PIN5, COMMON_SS_PIN, COMMON_RST_PIN);
+        }
+        
+        case SCAN_ANTICOLL: {
+            if (!readerBank.poll()) break;
+            
+            // Handled below, once the bus time is counted
+            readMask = readerBank.result(serNums);
+            
+            // A tag that answered the request but gave no UID was not read
+            // either; repeated, it times out like a missing one
+            for (uint8_t i = 0; i < NUM_READERS; i++) {
+                ReaderMask bit = (ReaderMask)1 << i;
+                if ((scanUidMask & scanMask & ~readMask & bit) && readerStates[i].tagPresent) {
+                    polls[i].lastMiss = currentMillis;
+                }
+            }
+            
+            // Put the cards into halt mode (the HALT frame goes out on every reader)
+            readerBank.startHalt(scanMask | watchMask);
+            scanPhase = SCAN_HALT;
             break;
-        case 5:
-            readers[readerNum].begin(COMMON_SS_PIN, 13, 11, MISO_PIN6, COMMON_SS_PIN, COMMON_RST_PIN);
+        }
+        
+        case SCAN_HALT:
+            if (readerBank.poll()) finishScan(currentMillis);
             break;
-        default:
-            return false;
     }
     
-    // Initialize the RFID reader
-    readers[readerNum].init();
-    
-    // Give the reader a moment to stabilize
-    delay(50);
+    unsigned long busTime = micros() - busStart;
+    scanStats.busMicros += busTime;
+    windowBusMicros += busTime;
     
-    // Look for cards
-    uchar status;
-    uchar str[MAX_LEN];
-    
-    // Search for a card
-    status = readers[readerNum].request(PICC_REQIDL, str);
-    if (status != MI_OK) {
-        return false;
+    // The cost of each part of the scan, for the budget. A call counts for
+    // the part it started in (the one that starts a scan for its request);
+    // a part is over once the scan has moved on.
+    if (startPhase != SCAN_IDLE || scanPhase != SCAN_IDLE) {
+        ScanPhase costPhase = startPhase == SCAN_IDLE ? SCAN_REQUEST : startPhase;
+        phaseBusMicros += busTime - sessionTime;
+        if (scanPhase != costPhase) {
+            if (phaseBusMicros > phaseCost[costPhase]) phaseCost[costPhase] = phaseBusMicros;
+            phaseBusMicros = 0;
+        }
     }
     
-    // Show card type
-    // readers[readerNum].showCardType(str);
-    
-    // Get the card serial number
-    status = readers[readerNum].anticoll(str);
-    if (status != MI_OK) {
-        return false;
+    for (uint8_t i = 0; readMask; i++, readMask >>= 1) {
+        if (readMask & 1) {
+            pollStats[i].uidReads++;
+            polls[i].checksSinceUid = 0;
+            handleTagRead(i, serNums[i], currentMillis);
+        }
     }
-    
-    // Get reader position
-    GridPosition* pos = readerPositions[readerNum];
-    if (!pos) return false;
+}
+
+void BoardController::finishScan(unsigned long currentMillis) {
+    // RF transactions of the scan; one that only confirmed tags and empty
+    // readers is the steady state
+    unsigned long transactions = readerBank.transactions() - scanStartTransactions;
+    scanStats.transactions += transactions;
+    if (!scanUidMask) {
+        scanStats.steadyScans++;
+        scanStats.steadyTransactions += transactions;
+    }
+    
+    schedulePolls(scanMask, currentMillis);
+    scanPhase = SCAN_IDLE;
+}
+
+bool BoardController::fitsBudget(unsigned long cost) {
+    return windowBusMicros + cost <= busBudget;
+}
+
+// The budget holds back a scan or a part of one during this second
+void BoardController::holdBack() {
+    if (!windowDeferred) scanStats.budgetHits++;
+    windowDeferred = true;
+}
+
+ReaderMask BoardController::dueReaders(unsigned long currentMillis) {
+    // A scan costs about the same for one reader as for all of them, so
+    // once a reader is due the readers due within POLL_JOIN_MS come along
+    ReaderMask due = 0;
+    ReaderMask soon = 0;
+    for (uint8_t i = 0; i < NUM_READERS; i++) {
+        long wait = (long)(polls[i].nextPoll - currentMillis);
+        if (wait <= 0) due |= (ReaderMask)1 << i;
+        if (wait <= POLL_JOIN_MS) soon |= (ReaderMask)1 << i;
+    }
+    return due ? soon & PLACED_READERS : 0;
+}
+
+void BoardController::startBurst(uint8_t readerNum) {
+    polls[readerNum].mode = POLL_BURST;
+    polls[readerNum].burstLeft = POLL_BURST_COUNT;
+    // The next scan picks it up
+    polls[readerNum].nextPoll = millis();
+}
+
+void BoardController::schedulePolls(ReaderMask readers, unsigned long currentMillis) {
+    for (uint8_t i = 0; readers; i++, readers >>= 1) {
+        if (!(readers & 1)) continue;
+        
+        ReaderPoll& poll = polls[i];
+        if (poll.mode == POLL_BURST && poll.burstLeft > 0) poll.burstLeft--;
+        if (poll.mode != POLL_BURST || poll.burstLeft == 0) {
+            poll.mode = readerStates[i].tagPresent ? POLL_STABLE : POLL_EMPTY;
+        }
+        
+        unsigned long interval = POLL_EMPTY_MS;
+        if (poll.mode == POLL_BURST) interval = POLL_BURST_MS;
+        else if (poll.mode == POLL_STABLE) interval = POLL_STABLE_MS;
+        poll.nextPoll = currentMillis + interval;
+    }
+}
+
+const ReaderPollStats* BoardController::getPollStats(uint8_t readerIndex) {
+    if (readerIndex < NUM_READERS) {
+        return &pollStats[readerIndex];
+    }
+    return nullptr;
+}
+
+PollMode BoardController::getPollMode(uint8_t readerIndex) {
+    if (readerIndex < NUM_READERS) {
+        return (PollMode)polls[readerIndex].mode;
+    }
+    return POLL_EMPTY;
+}
+
+void BoardController::handleTagRead(uint8_t readerNum, byte* uid, unsigned long currentMillis) {
+    readerStates[readerNum].lastReadTime = currentMillis;
     
     // If this is a new tag or a different tag
     bool isNewOrChangedTag = !readerStates[readerNum].tagPresent;
@@ -429,7 +648,7 @@ bool BoardController::checkReader(uint8_t readerNum) {
     if (readerStates[readerNum].tagPresent) {
         isNewOrChangedTag = false;
         for (byte i = 0; i < 4; i++) {
-            if (str[i] != readerStates[readerNum].tagUID[i]) {
+            if (uid[i] != readerStates[readerNum].tagUID[i]) {
                 isNewOrChangedTag = true;
                 break;
             }
@@ -438,169 +657,271 @@ bool BoardController::checkReader(uint8_t readerNum) {
     
     if (isNewOrChangedTag) {
         // Store UID of this tag
-        memcpy(readerStates[readerNum].tagUID, str, 4);
+        memcpy(readerStates[readerNum].tagUID, uid, 4);
         
-        // Identify the plant
-        PlantID plantId = PlantDatabase::identifyPlantByTag(str);
+        // Identify the plant; in learn mode an unknown tag is captured
+        PlantID plantId = identifyTag(uid);
+        if (learning) {
+            plantId = learnTag(readerNum, uid, plantId, currentMillis);
+        }
         readerStates[readerNum].currentPlant = plantId;
         
-        // Debug output
-        Serial.print(F("Reader "));
-        Serial.print(readerNum + 1);
-        Serial.print(F(" - Tag UID: "));
-        readers[readerNum].showCardID(str);
-        Serial.print(F(" - Plant: "));
-        Serial.println(PlantDatabase::getPlantInfo(plantId)->name);
+        LOG_INFO(F("Reader "), readerNum + 1, F(" - Tag UID: "), LogHex(uid, 4),
+                 F(" - Plant: "), PlantDatabase::getPlantName(plantId));
+        Telemetry::tagPlaced(readerNum, uid, plantId);
+        startBurst(readerNum);
+    }
+    
+    // If this is a new tag detection
+    if (!readerStates[readerNum].tagPresent) {
+        // The tag came after the last poll that found none
+        ReaderPollStats& stats = pollStats[readerNum];
+        unsigned long latency = currentMillis - polls[readerNum].lastMiss;
+        stats.detections++;
+        stats.latencySumMs += latency;
+        if (latency > stats.latencyMaxMs) stats.latencyMaxMs = latency;
+        
+        readerStates[readerNum].tagPresent = true;
+        occupiedReaders |= (ReaderMask)1 << readerNum;
+        LOG_INFO(F("Reader "), readerNum + 1, F(" - Tag detected"));
+    }
+    
+    // Evaluate plant interactions whenever a plant is placed or swapped
+    if (isNewOrChangedTag && !learning) {
+        evaluatePlantInteractions(readerNum);
+        tagChanged(readerNum);
+    }
+}
+
+PlantID BoardController::identifyTag(byte* uid) {
+    PlantID plantId = PlantDatabase::identifyPlantByTag(uid);
+    if (plantId != UNKNOWN) return plantId;
+    
+    // Captured in learn mode, but not saved yet
+    for (uint8_t i = 0; i < learnCount; i++) {
+        if (memcmp(learnBatch[i].uid, uid, 4) == 0) {
+            return (PlantID)learnBatch[i].plantId;
+        }
+    }
+    return UNKNOWN;
+}
+
+PlantID BoardController::learnTag(uint8_t readerNum, byte* uid, PlantID plantId, unsigned long currentMillis) {
+    uint8_t ringNum = readerNum + 1;
+    Plant plant;
+    effects.stop(ringNum);
+    
+    if (plantId != UNKNOWN) {
+        // Known already: a short flash in the color of its plant
+        PlantDatabase::getPlantInfo(plantId, &plant);
+        effects.play(ringNum, EFFECT_FLASH, plant.color[0], plant.color[1], plant.color[2]);
+        return plantId;
+    }
+    
+    if (learnCount >= LEARN_BATCH_SIZE) {
+        // The batch is still being saved; the tag stays unknown
+        effects.play(ringNum, EFFECT_FLASH, 255, 0, 0);
+        LOG_WARN(F("Learn mode: batch full, place tag "), LogHex(uid, 4), F(" again"));
+        return UNKNOWN;
+    }
+    
+    // Captured: the ring grows in the color of the plant and stays on
+    memcpy(learnBatch[learnCount].uid, uid, 4);
+    learnBatch[learnCount].plantId = learnPlant;
+    learnCount++;
+    capturedTotal++;
+    lastCaptureTime = currentMillis;
+    
+    PlantDatabase::getPlantInfo(learnPlant, &plant);
+    effects.play(ringNum, EFFECT_GROWTH, plant.color[0], plant.color[1], plant.color[2]);
+    LOG_INFO(F("Learn mode: tag "), LogHex(uid, 4), F(" is now "), PlantDatabase::getPlantName(learnPlant));
+    return learnPlant;
+}
+
+void BoardController::saveLearnedTags(unsigned long currentMillis) {
+    if (!learnCount) return;
+    
+    // A batch is saved when the next placement on every reader might not
+    // fit, when no tag came for a while or when learn mode ends. Tags
+    // captured while it is being saved join it.
+    if (!learnSaving) {
+        if (learning && learnCount <= LEARN_BATCH_SIZE - NUM_READERS &&
+            currentMillis - lastCaptureTime < LEARN_SAVE_DELAY) {
+            return;
+        }
+        learnSaving = true;
+    }
+    
+    // One tag at a time; TagStore::service() writes it out
+    if (TagStore::busy()) return;
+    if (learnSaved < learnCount) {
+        TagInfo& tag = learnBatch[learnSaved++];
+        if (!PlantDatabase::registerTagInBackground(tag.uid, (PlantID)tag.plantId)) {
+            LOG_WARN(F("Learn mode: tag store full, tag "), LogHex(tag.uid, 4), F(" not saved"));
+        }
+        return;
     }
     
-    // Put the card into halt mode
-    readers[readerNum].halt();
+    LOG_INFO(F("Learn mode: "), learnCount, F(" tags saved"));
+    learnCount = 0;
+    learnSaved = 0;
+    learnSaving = false;
+}
+
+bool BoardController::startLearning(PlantID plantId) {
+    if (plantId == UNKNOWN || plantId >= NUM_PLANTS) return false;
     
+    if (!learning) {
+        // The game pauses; the rings only confirm captured tags
+        resetRings();
+        capturedTotal = 0;
+    }
+    learning = true;
+    learnPlant = plantId;
+    LOG_INFO(F("Learn mode: new tags become "), PlantDatabase::getPlantName(plantId));
     return true;
 }
 
+void BoardController::stopLearning() {
+    if (!learning) return;
+    learning = false;
+    LOG_INFO(F("Learn mode off, "), capturedTotal, F(" tags captured"));
+    
+    // Back to the game: every tag on the board gets its verdict again
+    resetRings();
+    reevaluate(PLACED_READERS, 0);
+}
+
+void BoardController::resetRings() {
+    for (uint8_t i = 0; i < NUM_READERS; i++) {
+        clearRing(i + 1);
+        effectStates[i].verdict = VERDICT_NONE;
+    }
+}
+
+void BoardController::tagChanged(uint8_t readerNum) {
+    // Only this reader and its neighbors can have a new verdict. The ring
+    // of this reader always restarts, so a swapped plant gets feedback.
+    ReaderMask self = (ReaderMask)1 << readerNum;
+    reevaluate(BoardLayout::getNeighbors(readerNum), self);
+}
+
 void BoardController::evaluatePlantInteractions(uint8_t readerNum) {
+    // Only explains the placement in the log - compiled out without it
+#if LOG_LEVEL >= LOG_LEVEL_INFO
     PlantID currentPlant = readerStates[readerNum].currentPlant;
     if (currentPlant == UNKNOWN) return;
     
-    GridPosition* pos = readerPositions[readerNum];
-    if (!pos) return;
+    ReaderLayout pos;
+    if (!BoardLayout::getReader(readerNum, &pos)) return;
     
     // 1. Check if plant likes the environment
-    const Plant* plant = PlantDatabase::getPlantInfo(currentPlant);
-    bool plantHappy = PlantDatabase::plantThrives(currentPlant, pos->attributes);
-    bool plantOkay = PlantDatabase::plantTolerates(currentPlant, pos->attributes);
+    const __FlashStringHelper* plantName = PlantDatabase::getPlantName(currentPlant);
+    bool plantHappy = PlantDatabase::plantThrives(currentPlant, pos.attributes);
+    bool plantOkay = PlantDatabase::plantTolerates(currentPlant, pos.attributes);
     
     if (plantHappy) {
-        Serial.print(F("Plant '"));
-        Serial.print(plant->name);
-        Serial.print(F("' is happy with the environment at reader "));
-        Serial.println(readerNum + 1);
-        showLikesEffect(readerNum + 1);
+        LOG_INFO(F("Plant '"), plantName, F("' is happy with the environment at reader "), readerNum + 1);
     } else if (plantOkay) {
-        Serial.print(F("Plant '"));
-        Serial.print(plant->name);
-        Serial.print(F("' tolerates the environment at reader "));
-        Serial.println(readerNum + 1);
-        showNeutralEffect(readerNum + 1);
+        LOG_INFO(F("Plant '"), plantName, F("' tolerates the environment at reader "), readerNum + 1);
     } else {
-        Serial.print(F("Plant '"));
-        Serial.print(plant->name);
-        Serial.print(F("' is unhappy with the environment at reader "));
-        Serial.println(readerNum + 1);
-        showDislikesEffect(readerNum + 1);
+        LOG_INFO(F("Plant '"), plantName, F("' is unhappy with the environment at reader "), readerNum + 1);
     }
     
     // 2. Check neighboring plants for interactions
-    Serial.println(F("Evaluating neighboring plants..."));
-    
-    // Debug info - print current plant position
-    Serial.print(F("Current plant '"));
-    Serial.print(plant->name);
-    Serial.print(F("' at position ("));
-    Serial.print(pos->row);
-    Serial.print(F(","));
-    Serial.print(pos->col);
-    Serial.println(F(")"));
+    LOG_DEBUG(F("Evaluating neighboring plants..."));
+    LOG_DEBUG(F("Current plant '"), plantName, F("' at position ("), pos.row, F(","), pos.col, F(")"));
     
     bool foundNeighbor = false;
     
-    for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
-        for (uint8_t col = 0; col < MATRIX_COLS; col++) {
-            // Skip if this is the same position as current plant
-            if (row == pos->row && col == pos->col) continue;
-            
-            // Skip if this is not a neighboring position or has no reader
-            if (!areNeighbors(pos->row, pos->col, row, col) || 
-                grid[row][col].readerIndex < 0) {
-                continue;
-            }
-            
-            uint8_t neighborReaderNum = grid[row][col].readerIndex;
-            
-            // Debug info - found a neighboring reader
-            Serial.print(F("Found neighboring reader "));
-            Serial.print(neighborReaderNum + 1);
-            Serial.print(F(" at position ("));
-            Serial.print(row);
-            Serial.print(F(","));
-            Serial.print(col);
-            Serial.println(F(")"));
-            
-            // Skip if neighbor has no tag present
-            if (!readerStates[neighborReaderNum].tagPresent) {
-                Serial.print(F("Reader "));
-                Serial.print(neighborReaderNum + 1);
-                Serial.println(F(" has no tag present"));
-                continue;
-            }
-            
-            PlantID neighborPlant = readerStates[neighborReaderNum].currentPlant;
-            foundNeighbor = true;
-            
-            Serial.print(F("Reader "));
-            Serial.print(neighborReaderNum + 1);
-            Serial.print(F(" has plant: "));
-            Serial.println(PlantDatabase::getPlantInfo(neighborPlant)->name);
-            
-            // Evaluate relationship
-            PlantRelationship relationship = PlantDatabase::getRelationship(currentPlant, neighborPlant);
-            Serial.print(F("Evaluating relationship between '"));
-            Serial.print(plant->name);
-            Serial.print(F("' and '"));
-            Serial.print(PlantDatabase::getPlantInfo(neighborPlant)->name);
-            Serial.print(F("' at reader "));
-            Serial.println(neighborReaderNum + 1);
-
-            Serial.print(F("Relationship: "));
-            Serial.print(relationship == LIKES ? "LIKES" : 
-                          relationship == HATES ? "HATES" : "NEUTRAL");
-            Serial.println();
-
-            if (relationship == LIKES) {
-                // Positive interaction
-                Serial.print(F("Plant '"));
-                Serial.print(plant->name);
-                Serial.print(F("' likes being next to '"));
-                Serial.print(PlantDatabase::getPlantInfo(neighborPlant)->name);
-                Serial.println(F("'"));
-                
-                growthEffect(readerNum + 1, neighborReaderNum + 1);
-            }
-            else if (relationship == HATES) {
-                // Negative interaction
-                Serial.print(F("Plant '"));
-                Serial.print(plant->name);
-                Serial.print(F("' dislikes being next to '"));
-                Serial.print(PlantDatabase::getPlantInfo(neighborPlant)->name);
-                Serial.println(F("'"));
-                
-                showDislikesEffect(readerNum + 1);
-            }
+    // Walk the readers next to this one; the mask comes from the board layout
+    ReaderMask neighbors = pos.neighbors;
+    for (uint8_t neighborReaderNum = 0; neighbors; neighborReaderNum++, neighbors >>= 1) {
+        if (!(neighbors & 1)) continue;
+        
+#if LOG_LEVEL >= LOG_LEVEL_DEBUG
+        ReaderLayout neighborPos;
+        BoardLayout::getReader(neighborReaderNum, &neighborPos);
+        LOG_DEBUG(F("Found neighboring reader "), neighborReaderNum + 1,
+                  F(" at position ("), neighborPos.row, F(","), neighborPos.col, F(")"));
+#endif
+        
+        // Skip if neighbor has no tag present
+        if (!(occupiedReaders & ((ReaderMask)1 << neighborReaderNum))) {
+            LOG_DEBUG(F("Reader "), neighborReaderNum + 1, F(" has no tag present"));
+            continue;
+        }
+        
+        PlantID neighborPlant = readerStates[neighborReaderNum].currentPlant;
+        const __FlashStringHelper* neighborName = PlantDatabase::getPlantName(neighborPlant);
+        foundNeighbor = true;
+        LOG_DEBUG(F("Reader "), neighborReaderNum + 1, F(" has plant: "), neighborName);
+        
+        // Evaluate relationship
+        PlantRelationship relationship = PlantDatabase::getRelationship(currentPlant, neighborPlant);
+        LOG_DEBUG(F("Relationship: "), relationship == LIKES ? F("LIKES") :
+                                       relationship == HATES ? F("HATES") : F("NEUTRAL"));
+        
+        if (relationship == LIKES) {
+            // Positive interaction
+            LOG_INFO(F("Plant '"), plantName, F("' likes being next to '"), neighborName, F("'"));
+        }
+        else if (relationship == HATES) {
+            // Negative interaction
+            LOG_INFO(F("Plant '"), plantName, F("' dislikes being next to '"), neighborName, F("'"));
         }
     }
     
     if (!foundNeighbor) {
-        Serial.println(F("No neighboring plants found"));
+        LOG_INFO(F("No neighboring plants found"));
     }
+#endif
 }
 
 void BoardController::setRingColor(uint8_t readerNum, uint8_t r, uint8_t g, uint8_t b) {
     uint16_t startLED = getRingStartLED(readerNum);
     
     if (startLED != 0xFFFF) { // Valid ring
+        // A fixed color replaces any running effect
+        effects.stop(readerNum);
         for (int i = 0; i < NUM_LEDS_PER_RING; i++) {
             leds[startLED + i] = CRGB(r, g, b);
         }
-        FastLED.show();
+        markRingDirty(readerNum);
     }
 }
 
-void BoardController::setRingColorWithBrightness(uint8_t readerNum, uint8_t r, uint8_t g, uint8_t b, uint8_t brightness) {
-    uint8_t adjustedR = (r * brightness) / 100;
-    uint8_t adjustedG = (g * brightness) / 100;
-    uint8_t adjustedB = (b * brightness) / 100;
-    setRingColor(readerNum, adjustedR, adjustedG, adjustedB);
+void BoardController::flushLeds() {
+    for (uint8_t chain = 0; chain < NUM_LED_CHAINS; chain++) {
+        if (!(dirtyChains & (1 << chain))) continue;
+        
+        unsigned long start = micros();
+        ledChains[chain]->showLeds(FastLED.getBrightness());
+        unsigned long elapsed = micros() - start;
+        
+        ledStats.shows++;
+        ledStats.showMicros += elapsed;
+        windowShows++;
+        windowShowMicros += elapsed;
+    }
+    dirtyChains = 0;
+    
+    // Roll the per-second counters
+    unsigned long currentMillis = millis();
+    if (currentMillis - statsWindowStart >= 1000) {
+        ledStats.showsPerSecond = windowShows;
+        ledStats.showMicrosPerSecond = windowShowMicros;
+        windowShows = 0;
+        windowShowMicros = 0;
+        statsWindowStart = currentMillis;
+    }
+}
+
+void BoardController::markRingDirty(uint8_t readerNum) {
+    uint16_t startLED = getRingStartLED(readerNum);
+    if (startLED != 0xFFFF) {
+        dirtyChains |= 1 << (startLED / LEDS_PER_CHAIN);
+    }
 }
 
 uint16_t BoardController::getRingStartLED(uint8_t readerNum) {
@@ -621,67 +942,53 @@ void BoardController::changeGameMode() {
     switch (currentGameMode) {
         case ENVIRONMENT_MODE:
             currentGameMode = NEIGHBORS_MODE;
-            Serial.println(F("Game Mode changed: Neighbors Check"));
+            LOG_INFO(F("Game Mode changed: Neighbors Check"));
             break;
         case NEIGHBORS_MODE:
             currentGameMode = COMBINED_MODE;
-            Serial.println(F("Game Mode changed: Combined Environment & Neighbors Check"));
+            LOG_INFO(F("Game Mode changed: Combined Environment & Neighbors Check"));
             break;
         case COMBINED_MODE:
         default:
             currentGameMode = ENVIRONMENT_MODE;
-            Serial.println(F("Game Mode changed: Environment Check"));
+            LOG_INFO(F("Game Mode changed: Environment Check"));
             break;
     }
     
+    // Every verdict depends on the mode (learn mode shows none)
+    if (!learning) {
+        reevaluate(PLACED_READERS, 0);
+    }
+    
     // Display the current game mode
     displayGameMode();
 }
 
 void BoardController::displayGameMode() {
-    // Clear all LEDs first
-    FastLED.clear();
-    
-    // Show a distinctive pattern for each game mode on any available/unused LEDs
+    // Flash the empty rings in the color of the game mode
+    uint8_t r = 0, g = 0, b = 0;
     switch (currentGameMode) {
         case ENVIRONMENT_MODE:
-            // Green pattern for environment mode
-            for (int i = 0; i < NUM_READERS; i++) {
-                if (!readerStates[i].tagPresent) {
-                    // Use a green color for environment mode
-                    setRingColor(i + 1, 0, 255, 0);
-                    delay(100);
-                }
-            }
+            // Green for environment mode
+            g = 255;
             break;
             
         case NEIGHBORS_MODE:
-            // Blue pattern for neighbors mode
-            for (int i = 0; i < NUM_READERS; i++) {
-                if (!readerStates[i].tagPresent) {
-                    // Use a blue color for neighbors mode
-                    setRingColor(i + 1, 0, 0, 255);
-                    delay(100);
-                }
-            }
+            // Blue for neighbors mode
+            b = 255;
             break;
             
         case COMBINED_MODE:
-            // Purple pattern for combined mode
-            for (int i = 0; i < NUM_READERS; i++) {
-                if (!readerStates[i].tagPresent) {
-                    // Use a purple color for combined mode
-                    setRingColor(i + 1, 255, 0, 255);
-                    delay(100);
-                }
-            }
+            // Purple for combined mode
+            r = 255;
+            b = 255;
             break;
     }
     
-    // After showing the mode, reset empty rings to off
+    // The flash turns the ring off again when it ends
     for (int i = 0; i < NUM_READERS; i++) {
         if (!readerStates[i].tagPresent) {
-            clearRing(i + 1);
+            effects.play(i + 1, EFFECT_FLASH, r, g, b);
         }
     }
 }
@@ -689,67 +996,24 @@ void BoardController::displayGameMode() {
 void BoardController::optimizeRFIDReaders() {
     Serial.println(F("Optimizing RFID readers for NXP Ultra NFC tags..."));
     
-    for (uint8_t i = 0; i < NUM_READERS; i++) {
-        // Initialize the reader
-        setRFIDMaxGain(i);
-    }
+    setRFIDMaxGain();
     
     Serial.println(F("RFID readers optimized for maximum reading distance"));
 }
 
-void BoardController::setRFIDMaxGain(uint8_t readerNum) {
-    if (readerNum >= NUM_READERS) return;
+void BoardController::setRFIDMaxGain() {
+    // Register writes are broadcast, so this tunes every chip on the bus
+    // at once. The values become part of the reader session and survive
+    // chip resets; 100% ASK (TxAutoReg) is already in it from init().
     
-    // Initialize appropriate reader with its MISO pin
-    switch (readerNum) {
-        case 0:
-            readers[readerNum].begin(COMMON_SS_PIN, 13, 11, MISO_PIN1, COMMON_SS_PIN, COMMON_RST_PIN);
-            break;
-        case 1:
-            readers[readerNum].begin(COMMON_SS_PIN, 13, 11, MISO_PIN2, COMMON_SS_PIN, COMMON_RST_PIN);
-            break;
-        case 2:
-            readers[readerNum].begin(COMMON_SS_PIN, 13, 11, MISO_PIN3, COMMON_SS_PIN, COMMON_RST_PIN);
-            break;
-        case 3:
-            readers[readerNum].begin(COMMON_SS_PIN, 13, 11, MISO_PIN4, COMMON_SS_PIN, COMMON_RST_PIN);
-            break;
-        case 4:
-            readers[readerNum].begin(COMMON_SS_PIN, 13, 11, MISO_PIN5, COMMON_SS_PIN, COMMON_RST_PIN);
-            break;
-        case 5:
-            readers[readerNum].begin(COMMON_SS_PIN, 13, 11, MISO_PIN6, COMMON_SS_PIN, COMMON_RST_PIN);
-            break;
-        default:
-            return;
-    }
+    // Set maximum receiver gain (RFCfgReg)
+    readerBank.setConfig(RFCfgReg, 0x70); // Highest gain setting (48dB)
     
-    // Initialize the RFID reader
-    readers[readerNum].init();
+    // Tune the antenna circuit (ModWidthReg)
+    readerBank.setConfig(ModWidthReg, 0x26);
     
-    // Enhanced settings for better reading distance
-    // Set maximum receiver gain (RFCfgReg, 0x26)
-    readers[readerNum].writeTo(0x26 << 1, 0x7F); // Highest gain setting (48dB)
+    // Optimize receiver settings (RxSelReg)
+    readerBank.setConfig(RxSelReg, 0x86);
     
-    // Increase modulation depth (TxASKReg, 0x15)
-    readers[readerNum].writeTo(0x15 << 1, 0x40); // 100% ASK modulation
-    
-    // Tune the antenna circuit (ModWidthReg, 0x24)
-    readers[readerNum].writeTo(0x24 << 1, 0x26);
-    
-    // Optimize receiver settings (RxSelReg, 0x17)
-    readers[readerNum].writeTo(0x17 << 1, 0x86);
-    
-    // Ensure the antenna is on
-    readers[readerNum].antennaOn();
-    
-    // Reset any pending commands
-    readers[readerNum].reset();
-    
-    // Small delay to allow settings to take effect
-    delay(50);
-    
-    Serial.print(F("Reader #"));
-    Serial.print(readerNum + 1);
-    Serial.println(F(" optimized for NXP Ultra tags"));
-}
\ No newline at end of file
+    Serial.println(F("All readers optimized for NXP Ultra tags"));
+}
@@ -4,9 +4,23 @@
 #include <Arduino.h>
 // Replace MFRC522 with RFID1 library
 #include "RFID1/rfid1.h"
+#include "RFID1/rfid1_fast.h"
 #include <FastLED.h>
 #include "BoardConfig.h"
+#include "BoardLayout.h"
 #include "PlantDatabase.h"
+#include "RingEffects.h"
+#include "Log.h"
+#include "Telemetry.h"
+#include "TagStore.h"
+
+// Learn mode: tags captured before they are saved to EEPROM as a batch.
+// Saving starts once the batch has no room left for a tag on every
+// reader, or once no new tag came for LEARN_SAVE_DELAY ms.
+#define LEARN_BATCH_SIZE 12
+#define LEARN_SAVE_DELAY 3000
+
+static_assert(LEARN_BATCH_SIZE > NUM_READERS, "a learn batch must hold a tag from every reader");
 
 // Game modes
 enum GameMode {
@@ -15,11 +29,63 @@ enum GameMode {
     COMBINED_MODE = 2
 };
 
+// Phases of the non-blocking reader scan
+enum ScanPhase {
+    SCAN_IDLE = 0,
+    SCAN_REQUEST,
+    SCAN_ANTICOLL,
+    SCAN_HALT
+};
+
+// What a reader's ring shows for the plant on it
+enum ReaderVerdict {
+    VERDICT_NONE = 0,       // no plant, ring off
+    VERDICT_NEUTRAL,
+    VERDICT_LIKES,
+    VERDICT_DISLIKES
+};
+
 // Effect status for each reader
 struct EffectState {
     bool environmentHappy;
     bool neighborRelationshipGood;
-    unsigned long lastEffectTime;
+    ReaderVerdict verdict;      // last verdict shown on the ring
+};
+
+// LED output counters; a "show" is one chain pushed out
+struct LedStats {
+    unsigned long shows;                // since begin()
+    unsigned long showMicros;           // time spent in show since begin()
+    unsigned long showsPerSecond;       // during the last full second
+    unsigned long showMicrosPerSecond;  // during the last full second
+};
+
+// How often a reader is polled (see POLL_* in BoardConfig.h)
+enum PollMode {
+    POLL_EMPTY = 0,         // no tag: polled quickly
+    POLL_BURST,             // tag just came or went, or missed a check
+    POLL_STABLE             // same tag for a while: presence checks
+};
+
+// Polling counters of a reader since begin()
+struct ReaderPollStats {
+    unsigned long polls;            // scans the reader was part of
+    unsigned long uidReads;         // polls that read the UID (anticollision)
+    unsigned long detections;       // tags found on the empty reader
+    unsigned long latencySumMs;     // per detection: from the last poll that found no tag
+    unsigned long latencyMaxMs;
+};
+
+// Reader bus counters
+struct ScanStats {
+    unsigned long scans;                // since begin()
+    unsigned long budgetHits;           // seconds in which the bus budget ran out
+    unsigned long transactions;         // RF transactions (frames to the tags) since begin()
+    unsigned long steadyScans;          // scans that read no UID, since begin()
+    unsigned long steadyTransactions;   // RF transactions of those
+    unsigned long busMicros;            // since begin()
+    unsigned long scansPerSecond;       // during the last full second
+    unsigned long busMicrosPerSecond;   // during the last full second
 };
 
 // Holds the current state of a reader/position
@@ -38,20 +104,30 @@ public:
     // Update method to be called in the main loop
     void update();
     
-    // Place a reader at the specified grid position with environmental attributes
-    bool placeReader(uint8_t readerNum, uint8_t row, uint8_t col, uint8_t attributes);
-    
     // Check if two positions are neighbors (including diagonal)
     bool areNeighbors(uint8_t row1, uint8_t col1, uint8_t row2, uint8_t col2);
     
+    // Get the readers next to a reader (including diagonal) as a mask
+    ReaderMask getNeighborMask(uint8_t readerIndex);
+    
     // Get reader number at position, returns 0 if no reader
     uint8_t getReaderAt(uint8_t row, uint8_t col);
     
     // Get environment attributes at position
     uint8_t getAttributesAt(uint8_t row, uint8_t col);
     
-    // Get the position information for a specific reader
-    GridPosition* getReaderPosition(uint8_t readerIndex);
+    // Get the position information for a specific reader; false if the
+    // reader is not on the board
+    bool getReaderPosition(uint8_t readerIndex, GridPosition* pos);
+    
+    // Get the tag state of a specific reader
+    const ReaderState* getReaderState(uint8_t readerIndex);
+    
+    // Get the verdict currently shown for a reader
+    ReaderVerdict getReaderVerdict(uint8_t readerIndex);
+    
+    // Number of reader verdicts computed since begin()
+    unsigned long getEvaluationCount() { return evaluationCount; }
     
     // Change game mode
     void changeGameMode();
@@ -62,7 +138,23 @@ public:
     // Display current game mode on LEDs
     void displayGameMode();
     
-    // Visual effects for feedback
+    // Learn mode: every unknown tag placed on any reader is bound to the
+    // plant. The game pauses, the ring confirms each captured tag and the
+    // tags are saved in batches in the background. Calling it again
+    // switches the plant.
+    bool startLearning(PlantID plantId);
+    
+    // Back to the game; captured tags not saved yet are still saved
+    void stopLearning();
+    
+    bool isLearning() { return learning; }
+    PlantID getLearningPlant() { return learnPlant; }
+    
+    // Tags captured since startLearning(), and those not in EEPROM yet
+    uint16_t getCapturedCount() { return capturedTotal; }
+    uint8_t getUnsavedCount() { return learnCount; }
+    
+    // Visual effects for feedback (queued per ring, animated by update())
     void showLikesEffect(uint8_t readerNum);
     void showDislikesEffect(uint8_t readerNum);
     void showNeutralEffect(uint8_t readerNum);
@@ -73,42 +165,133 @@ public:
     void growthEffect(uint8_t readerNum, uint8_t targetReaderNum);
     void rainbowEffect(uint8_t readerNum, uint8_t duration);
     
-    // Direct LED control for testing
+    // Is an effect playing on this ring?
+    bool isRingAnimating(uint8_t readerNum);
+    
+    // Direct LED control for testing. The change is shown by the next
+    // update() or flushLeds().
     void setRingColor(uint8_t readerNum, uint8_t r, uint8_t g, uint8_t b);
     
+    // Push out the LED chains that changed since the last flush
+    void flushLeds();
+    
+    // LED output counters
+    const LedStats& getLedStats() { return ledStats; }
+    
+    // Reader polling and bus counters
+    const ReaderPollStats* getPollStats(uint8_t readerIndex);
+    PollMode getPollMode(uint8_t readerIndex);
+    const ScanStats& getScanStats() { return scanStats; }
+    
+    // Reader bus time allowed per second (us)
+    void setBusBudget(unsigned long microsPerSecond) { busBudget = microsPerSecond; }
+    unsigned long getBusBudget() { return busBudget; }
+    
     // RFID Reader optimization
     void optimizeRFIDReaders();
-    void setRFIDMaxGain(uint8_t readerNum);
+    void setRFIDMaxGain();
 
 private:
-    // Changed from MFRC522 to RFID1
-    RFID1 readers[NUM_READERS];
+    // All readers share SCK/MOSI/SS, so one RFID1 in bank mode drives them.
+    // The pins are template parameters so register access uses port I/O.
+    RFID1Fast<COMMON_SS_PIN, COMMON_SCK_PIN, COMMON_MOSI_PIN,
+              MISO_PIN1, MISO_PIN2, MISO_PIN3, MISO_PIN4, MISO_PIN5, MISO_PIN6> readerBank;
     CRGB leds[TOTAL_LEDS];
-    GridPosition grid[MATRIX_ROWS][MATRIX_COLS];
+    RingEffects effects;
+    
+    // LED output: one bit per chain that needs to be pushed out
+    CLEDController* ledChains[NUM_LED_CHAINS];
+    uint8_t dirtyChains;
+    LedStats ledStats;
+    unsigned long statsWindowStart;
+    unsigned long windowShows;
+    unsigned long windowShowMicros;
+    
+    // update() timing, reported once a second over the telemetry
+    unsigned long loopWindowStart;
+    uint16_t windowUpdates;
+    unsigned long windowMaxUpdateMicros;
     ReaderState readerStates[NUM_READERS];
     EffectState effectStates[NUM_READERS];
-    GridPosition* readerPositions[NUM_READERS];
+    
+    // Positions and neighbors come from BOARD_LAYOUT (BoardLayout.h)
+    ReaderMask occupiedReaders;     // readers with a tag on them
     
     GameMode currentGameMode;
     
-    const unsigned long READ_INTERVAL = 100;      // Time between read attempts (ms)
-    const unsigned long TAG_TIMEOUT = 500;        // Time until tag is considered removed (ms)
-    const unsigned long EFFECT_INTERVAL = 2000;   // Time between effect cycles (ms)
+    // Reader scan state - one transaction step per update()
+    ScanPhase scanPhase;
+    ReaderMask scanMask;            // readers polled by the running scan
+    ReaderMask watchMask;           // occupied readers listening in on a REQA scan
+    bool scanWakeup;                // the scan sent WUPA, not REQA
+    ReaderMask scanUidMask;         // readers whose UID the scan reads
+    unsigned long scanStartTransactions;
+    ReaderMask onlineReaders;       // answered the last session check
+    unsigned long lastSessionCheck;
+    unsigned long lastPollMicros;
+    
+    // Per-reader poll schedule
+    struct ReaderPoll {
+        uint8_t mode;               // PollMode
+        uint8_t burstLeft;          // quick polls left in POLL_BURST
+        uint8_t checksSinceUid;     // presence checks since the UID was read
+        unsigned long nextPoll;
+        unsigned long lastMiss;     // last poll that found no tag
+    };
+    ReaderPoll polls[NUM_READERS];
+    ReaderPollStats pollStats[NUM_READERS];
     
-    // Initialize the grid matrix
-    void initializeGrid();
+    // Reader bus time, counted for the budget and the stats
+    ScanStats scanStats;
+    unsigned long busBudget;
+    unsigned long windowScans;
+    unsigned long windowBusMicros;
+    bool windowDeferred;            // budget ran out during this second
+    // Longest bus time seen for each part of a scan, indexed by ScanPhase:
+    // the session check (SCAN_IDLE), the request, the anticollision and
+    // the HALT. A part only starts when its worst case fits the budget.
+    unsigned long phaseCost[SCAN_HALT + 1];
+    unsigned long phaseBusMicros;   // bus time of the part running now
+    bool sessionHeld;               // a due session check gave way to a scan
+    
+    const unsigned long TAG_TIMEOUT = 500;        // A check missing the tag this long after its last read removes it (ms)
     
     // Reader handling
-    bool checkReader(uint8_t readerNum);
-    void evaluatePlantInteractions(uint8_t readerNum);
+    void advanceScan(unsigned long currentMillis);
+    ReaderMask dueReaders(unsigned long currentMillis);
+    void startBurst(uint8_t readerNum);
+    void schedulePolls(ReaderMask readers, unsigned long currentMillis);
+    void finishScan(unsigned long currentMillis);
+    bool fitsBudget(unsigned long cost);
+    void holdBack();
+    void handleTagRead(uint8_t readerNum, byte* uid, unsigned long currentMillis);
+    void evaluatePlantInteractions(uint8_t readerNum);  // explains a placement over serial
+    void tagChanged(uint8_t readerNum);
+    
+    // Learn mode
+    bool learning;
+    PlantID learnPlant;
+    TagInfo learnBatch[LEARN_BATCH_SIZE];   // captured, not saved yet
+    uint8_t learnCount;
+    uint8_t learnSaved;         // batch entries handed to the tag store
+    bool learnSaving;
+    unsigned long lastCaptureTime;
+    uint16_t capturedTotal;
+    PlantID identifyTag(byte* uid);
+    PlantID learnTag(uint8_t readerNum, byte* uid, PlantID plantId, unsigned long currentMillis);
+    void saveLearnedTags(unsigned long currentMillis);
+    void resetRings();
     
-    // Continuous effect handling
-    void updateContinuousEffects();
-    void applyContinuousEffect(uint8_t readerNum);
+    // Verdict handling - only readers whose inputs changed are evaluated,
+    // only rings whose verdict changed are redrawn
+    unsigned long evaluationCount;
+    ReaderVerdict evaluateReader(uint8_t readerNum);
+    void reevaluate(ReaderMask affected, ReaderMask forced);
+    void showVerdict(uint8_t readerNum);
     
     // LED control
-    void setRingColorWithBrightness(uint8_t readerNum, uint8_t r, uint8_t g, uint8_t b, uint8_t brightness);
     uint16_t getRingStartLED(uint8_t readerNum);
+    void markRingDirty(uint8_t readerNum);
 };
 
 #endif // BOARD_CONTROLLER_H
\ No newline at end of file
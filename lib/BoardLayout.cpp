@@ -0,0 +1,37 @@
+#include "BoardLayout.h"
+#include "IndexList.h"
+
+struct ReaderLayoutTable {
+    ReaderLayout readers[NUM_READERS];
+};
+
+template <uint16_t... I>
+constexpr ReaderLayoutTable makeReaderLayouts(IndexList<I...>) {
+    return ReaderLayoutTable{{layout::readerLayout(I)...}};
+}
+
+// Position, environment and neighbors of every reader, built by the compiler
+static constexpr ReaderLayoutTable readerLayouts PROGMEM =
+    makeReaderLayouts(MakeIndexList<NUM_READERS>::type());
+
+bool BoardLayout::getReader(uint8_t readerIndex, ReaderLayout* out) {
+    if (readerIndex >= NUM_READERS) return false;
+    memcpy_P(out, &readerLayouts.readers[readerIndex], sizeof(ReaderLayout));
+    return out->row != NO_CELL;
+}
+
+ReaderMask BoardLayout::getNeighbors(uint8_t readerIndex) {
+    ReaderLayout entry;
+    return getReader(readerIndex, &entry) ? entry.neighbors : 0;
+}
+
+int8_t BoardLayout::readerAt(uint8_t row, uint8_t col) {
+    if (row >= MATRIX_ROWS || col >= MATRIX_COLS) return -1;
+    for (uint8_t i = 0; i < NUM_READERS; i++) {
+        if (pgm_read_byte(&readerLayouts.readers[i].row) == row &&
+            pgm_read_byte(&readerLayouts.readers[i].col) == col) {
+            return i;
+        }
+    }
+    return -1;
+}
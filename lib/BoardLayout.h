@@ -0,0 +1,135 @@
+#ifndef BOARD_LAYOUT_H
+#define BOARD_LAYOUT_H
+
+#include <Arduino.h>
+#include "BoardConfig.h"
+
+// Where a reader sits on the grid and the environment there
+struct ReaderPlacement {
+    uint8_t reader;      // 1-based reader number
+    uint8_t row;
+    uint8_t col;
+    uint8_t attributes;  // Environmental attributes at this position
+};
+
+// The board layout. Readers are placed next to each other so plant
+// relationships can be tested; a reader that is not listed is not scanned.
+// Everything the board needs at runtime is generated from this table at
+// compile time, and a layout with a reader off the grid or two readers in
+// one cell does not compile.
+constexpr ReaderPlacement BOARD_LAYOUT[] = {
+    {1, 2, 0, PARTIALLY_SHADED | DRY},    // Potato tolerates it, Tomato dislikes
+    {2, 4, 0, PARTIALLY_SHADED | DRY},
+    {3, 5, 1, PARTIALLY_SHADED | MOIST},
+    {4, 3, 1, PARTIALLY_SHADED | MOIST},
+    {5, 1, 1, PARTIALLY_SHADED | MOIST},
+    {6, 2, 2, PARTIALLY_SHADED | WET}
+};
+
+constexpr uint8_t LAYOUT_SIZE = sizeof(BOARD_LAYOUT) / sizeof(BOARD_LAYOUT[0]);
+
+// Row/column of a reader that is not on the board
+#define NO_CELL 0xFF
+
+// What the board knows about one reader, indexed by 0-based reader number
+struct ReaderLayout {
+    uint8_t row;            // NO_CELL if the reader is not placed
+    uint8_t col;
+    uint8_t attributes;
+    ReaderMask neighbors;   // placed readers next to it (including diagonal)
+};
+
+// Compile-time layout checks and generators. These are C++11 constexpr
+// functions, so loops are written as recursion over the layout entries.
+namespace layout {
+
+constexpr bool entryOnGrid(uint8_t i) {
+    return BOARD_LAYOUT[i].reader >= 1 && BOARD_LAYOUT[i].reader <= NUM_READERS &&
+           BOARD_LAYOUT[i].row < MATRIX_ROWS && BOARD_LAYOUT[i].col < MATRIX_COLS;
+}
+
+constexpr bool allOnGrid(uint8_t i = 0) {
+    return i >= LAYOUT_SIZE || (entryOnGrid(i) && allOnGrid(i + 1));
+}
+
+constexpr bool sameCell(uint8_t i, uint8_t j) {
+    return BOARD_LAYOUT[i].row == BOARD_LAYOUT[j].row && BOARD_LAYOUT[i].col == BOARD_LAYOUT[j].col;
+}
+
+// No two entries i < j share a cell
+constexpr bool cellsUnique(uint8_t i = 0, uint8_t j = 1) {
+    return i >= LAYOUT_SIZE ? true :
+           j >= LAYOUT_SIZE ? cellsUnique(i + 1, i + 2) :
+           !sameCell(i, j) && cellsUnique(i, j + 1);
+}
+
+// No reader is listed twice
+constexpr bool readersUnique(uint8_t i = 0, uint8_t j = 1) {
+    return i >= LAYOUT_SIZE ? true :
+           j >= LAYOUT_SIZE ? readersUnique(i + 1, i + 2) :
+           BOARD_LAYOUT[i].reader != BOARD_LAYOUT[j].reader && readersUnique(i, j + 1);
+}
+
+constexpr int distance(uint8_t a, uint8_t b) {
+    return a > b ? a - b : b - a;
+}
+
+// Adjacent horizontally, vertically, or diagonally
+constexpr bool entriesAdjacent(uint8_t i, uint8_t j) {
+    return i != j && distance(BOARD_LAYOUT[i].row, BOARD_LAYOUT[j].row) <= 1 &&
+           distance(BOARD_LAYOUT[i].col, BOARD_LAYOUT[j].col) <= 1;
+}
+
+constexpr ReaderMask readerBit(uint8_t i) {
+    return (ReaderMask)1 << (BOARD_LAYOUT[i].reader - 1);
+}
+
+constexpr ReaderMask neighborsOf(uint8_t entry, uint8_t i = 0) {
+    return i >= LAYOUT_SIZE ? 0 :
+           (ReaderMask)((entriesAdjacent(entry, i) ? readerBit(i) : 0) | neighborsOf(entry, i + 1));
+}
+
+constexpr ReaderMask placedMask(uint8_t i = 0) {
+    return i >= LAYOUT_SIZE ? 0 : (ReaderMask)(readerBit(i) | placedMask(i + 1));
+}
+
+// Layout entry of a 0-based reader, LAYOUT_SIZE if it is not placed
+constexpr uint8_t entryOf(uint8_t readerIndex, uint8_t i = 0) {
+    return i >= LAYOUT_SIZE ? LAYOUT_SIZE :
+           BOARD_LAYOUT[i].reader == readerIndex + 1 ? i : entryOf(readerIndex, i + 1);
+}
+
+constexpr ReaderLayout readerAtEntry(uint8_t entry) {
+    return entry >= LAYOUT_SIZE ? ReaderLayout{NO_CELL, NO_CELL, NONE, 0} :
+           ReaderLayout{BOARD_LAYOUT[entry].row, BOARD_LAYOUT[entry].col,
+                        BOARD_LAYOUT[entry].attributes, neighborsOf(entry)};
+}
+
+constexpr ReaderLayout readerLayout(uint8_t readerIndex) {
+    return readerAtEntry(entryOf(readerIndex));
+}
+
+} // namespace layout
+
+static_assert(LAYOUT_SIZE <= NUM_READERS, "BOARD_LAYOUT lists more readers than NUM_READERS");
+static_assert(layout::allOnGrid(), "BOARD_LAYOUT has a reader number or cell out of range");
+static_assert(layout::cellsUnique(), "BOARD_LAYOUT puts two readers in the same cell");
+static_assert(layout::readersUnique(), "BOARD_LAYOUT lists a reader twice");
+
+// Readers on the board
+constexpr ReaderMask PLACED_READERS = layout::placedMask();
+
+// Access to the generated layout, which lives in flash
+class BoardLayout {
+public:
+    // Layout of a 0-based reader; false if the reader is not on the board
+    static bool getReader(uint8_t readerIndex, ReaderLayout* out);
+
+    // Readers next to a reader (including diagonal) as a mask
+    static ReaderMask getNeighbors(uint8_t readerIndex);
+
+    // 0-based reader in a cell, -1 if there is none
+    static int8_t readerAt(uint8_t row, uint8_t col);
+};
+
+#endif // BOARD_LAYOUT_H
@@ -0,0 +1,124 @@
+#include "CommandLine.h"
+
+static int8_t hexDigit(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+bool CommandArgs::getHex(uint8_t index, uint8_t* bytes, uint8_t length) const {
+    const char* s = get(index);
+    if (strlen(s) != length * 2) return false;
+
+    for (uint8_t i = 0; i < length; i++) {
+        int8_t high = hexDigit(s[i * 2]);
+        int8_t low = hexDigit(s[i * 2 + 1]);
+        if (high < 0 || low < 0) return false;
+        bytes[i] = (high << 4) | low;
+    }
+    return true;
+}
+
+bool CommandArgs::getNumber(uint8_t index, unsigned int max, unsigned int* value) const {
+    const char* s = get(index);
+    if (!*s) return false;
+
+    unsigned long n = 0;
+    for (; *s; s++) {
+        if (*s < '0' || *s > '9') return false;
+        n = n * 10 + (*s - '0');
+        if (n > max) return false;
+    }
+    *value = n;
+    return true;
+}
+
+CommandLine::CommandLine(const CommandEntry* table, uint8_t numCommands)
+    : table(table), numCommands(numCommands), length(0), tooLong(false) {
+}
+
+void CommandLine::poll() {
+    for (uint8_t n = 0; n < COMMAND_BYTES_PER_POLL && Serial.available(); n++) {
+        feed(Serial.read());
+    }
+}
+
+bool CommandLine::feed(char c) {
+    if (c != '\n' && c != '\r') {
+        if (length < COMMAND_LINE_LENGTH) {
+            line[length++] = c;
+        } else {
+            tooLong = true;
+        }
+        return false;
+    }
+
+    // End of line; the '\n' of a "\r\n" ends an empty one
+    bool ran = false;
+    if (tooLong) {
+        Serial.println(F("Command too long"));
+    } else if (length > 0) {
+        line[length] = '\0';
+        ran = dispatch();
+    }
+    length = 0;
+    tooLong = false;
+    return ran;
+}
+
+bool CommandLine::dispatch() {
+    // Split into words in place
+    const char* name = NULL;
+    CommandArgs args;
+    args.numArgs = 0;
+    char* p = line;
+    while (*p) {
+        while (*p == ' ' || *p == '\t') *p++ = '\0';
+        if (!*p) break;
+
+        if (!name) {
+            name = p;
+        } else if (args.numArgs < COMMAND_MAX_ARGS) {
+            args.args[args.numArgs++] = p;
+        } else {
+            Serial.println(F("Too many arguments"));
+            return false;
+        }
+        while (*p && *p != ' ' && *p != '\t') p++;
+    }
+    if (!name) return false;
+
+    for (uint8_t i = 0; i < numCommands; i++) {
+        const CommandEntry* entry = &table[i];
+        if (strcmp_P(name, entry->name) != 0) continue;
+
+        if (args.count() < pgm_read_byte(&entry->minArgs)) {
+            Serial.print(F("Use: "));
+            Serial.print(reinterpret_cast<const __FlashStringHelper*>(entry->name));
+            Serial.print(' ');
+            Serial.println(reinterpret_cast<const __FlashStringHelper*>(entry->usage));
+            return false;
+        }
+        CommandHandler handler = (CommandHandler)pgm_read_ptr(&entry->handler);
+        handler(args);
+        return true;
+    }
+
+    Serial.println(F("Unknown command. Type 'help' for available commands."));
+    return false;
+}
+
+void CommandLine::printHelp() {
+    Serial.println(F("Available commands:"));
+    for (uint8_t i = 0; i < numCommands; i++) {
+        const CommandEntry* entry = &table[i];
+        Serial.print(reinterpret_cast<const __FlashStringHelper*>(entry->name));
+        if (pgm_read_byte(&entry->usage[0])) {
+            Serial.print(' ');
+            Serial.print(reinterpret_cast<const __FlashStringHelper*>(entry->usage));
+        }
+        Serial.print(F(" - "));
+        Serial.println(reinterpret_cast<const __FlashStringHelper*>(entry->description));
+    }
+}
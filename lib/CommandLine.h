@@ -0,0 +1,70 @@
+#ifndef COMMAND_LINE_H
+#define COMMAND_LINE_H
+
+#include <Arduino.h>
+#include <string.h>
+
+// Longest command line; longer lines are rejected as a whole
+#define COMMAND_LINE_LENGTH 40
+// Words after the command name
+#define COMMAND_MAX_ARGS 4
+// Serial bytes taken per poll(), so a burst of input cannot stall update()
+#define COMMAND_BYTES_PER_POLL 16
+
+// The words after the command name, split in place in the line buffer
+class CommandArgs {
+public:
+    uint8_t count() const { return numArgs; }
+    const char* get(uint8_t index) const { return index < numArgs ? args[index] : ""; }
+    bool is(uint8_t index, const char* word) const { return strcmp(get(index), word) == 0; }
+
+    // Exactly 'length' bytes as 2 hex digits each, e.g. "04E5121A"
+    bool getHex(uint8_t index, uint8_t* bytes, uint8_t length) const;
+    // A decimal number up to 'max'
+    bool getNumber(uint8_t index, unsigned int max, unsigned int* value) const;
+
+private:
+    friend class CommandLine;
+    const char* args[COMMAND_MAX_ARGS];
+    uint8_t numArgs;
+};
+
+typedef void (*CommandHandler)(const CommandArgs& args);
+
+// One row of a command table in flash; 'help' prints name, usage and
+// description
+struct CommandEntry {
+    char name[10];
+    char usage[24];         // the arguments, e.g. "[tag_id_hex] [plant_id]"
+    char description[48];
+    uint8_t minArgs;
+    CommandHandler handler;
+};
+
+// Reads commands from the serial port a few bytes per poll() and runs the
+// handler of the matching table row. Uses a fixed line buffer and never
+// waits for input.
+class CommandLine {
+public:
+    CommandLine(const CommandEntry* table, uint8_t numCommands);
+
+    // Take what the serial port has, up to COMMAND_BYTES_PER_POLL bytes
+    void poll();
+
+    // One input byte; true if it completed a line that ran a command
+    bool feed(char c);
+
+    // The command table as a help text
+    void printHelp();
+
+private:
+    const CommandEntry* table;      // in flash
+    uint8_t numCommands;
+    char line[COMMAND_LINE_LENGTH + 1];
+    uint8_t length;
+    bool tooLong;
+
+    bool dispatch();
+};
+
+#endif // COMMAND_LINE_H
@@ -0,0 +1,12 @@
+#ifndef INDEX_LIST_H
+#define INDEX_LIST_H
+
+#include <stdint.h>
+
+// 0, 1, ... N-1 as a template parameter pack, so a table can be built by a
+// constexpr function as one initializer list (C++11 has no index_sequence)
+template <uint16_t... I> struct IndexList {};
+template <uint16_t N, uint16_t... I> struct MakeIndexList : MakeIndexList<N - 1, N - 1, I...> {};
+template <uint16_t... I> struct MakeIndexList<0, I...> { typedef IndexList<I...> type; };
+
+#endif // INDEX_LIST_H
@@ -0,0 +1,97 @@
+#include "Log.h"
+
+Logger Log;
+
+void Logger::drain() {
+    // Tell how much was lost once everything before it is out
+    if (dropped && tail == head) {
+        unsigned long count = dropped;
+        dropped = 0;
+        message(F("Log: "), count, F(" lines dropped"));
+    }
+
+    writeOut(head);
+}
+
+void Logger::writeOut(uint8_t upTo) {
+    int room = Serial.availableForWrite();
+    while (room > 0 && tail != upTo) {
+        // Up to 'upTo' or the end of the buffer, whichever is first
+        uint16_t end = upTo > tail ? upTo : LOG_BUFFER_SIZE;
+        uint16_t count = end - tail;
+        if (count > (uint16_t)room) count = room;
+
+        Serial.write((const uint8_t*)&buffer[tail], count);
+        tail = (tail + count) % LOG_BUFFER_SIZE;
+        room -= count;
+    }
+}
+
+bool Logger::write(const uint8_t* data, uint8_t length) {
+    lineStart = head;
+    overflow = false;
+    for (uint8_t i = 0; i < length; i++) {
+        put((char)data[i]);
+    }
+    if (overflow) {
+        head = lineStart;
+        return false;
+    }
+    return true;
+}
+
+void Logger::put(char c) {
+    if (overflow) return;
+
+    uint8_t next = (head + 1) % LOG_BUFFER_SIZE;
+    if (next == tail) {
+        // Make room by moving the complete lines the serial port takes
+        // right now; the line being written may still be dropped
+        writeOut(lineStart);
+        if (next == tail) {
+            overflow = true;
+            return;
+        }
+    }
+    buffer[head] = c;
+    head = next;
+}
+
+void Logger::put(const char* s) {
+    while (*s) put(*s++);
+}
+
+void Logger::put(const __FlashStringHelper* s) {
+    const char* p = (const char*)s;
+    for (char c = pgm_read_byte(p); c; c = pgm_read_byte(++p)) {
+        put(c);
+    }
+}
+
+void Logger::put(long n) {
+    if (n < 0) {
+        put('-');
+        put(0UL - (unsigned long)n);
+    } else {
+        put((unsigned long)n);
+    }
+}
+
+void Logger::put(unsigned long n) {
+    char digits[sizeof(unsigned long) * 3];
+    uint8_t count = 0;
+    do {
+        digits[count++] = '0' + n % 10;
+        n /= 10;
+    } while (n);
+    while (count) put(digits[--count]);
+}
+
+void Logger::put(const LogHex& hex) {
+    for (uint8_t i = 0; i < hex.length; i++) {
+        uint8_t high = hex.data[i] >> 4;
+        uint8_t low = hex.data[i] & 0x0F;
+        put((char)(high < 10 ? '0' + high : 'A' + high - 10));
+        put((char)(low < 10 ? '0' + low : 'A' + low - 10));
+    }
+}
@@ -0,0 +1,122 @@
+#ifndef LOG_H
+#define LOG_H
+
+#include <Arduino.h>
+
+// Log levels; LOG_LEVEL selects the most detailed one that is compiled in
+#define LOG_LEVEL_NONE 0
+#define LOG_LEVEL_ERROR 1
+#define LOG_LEVEL_WARN 2
+#define LOG_LEVEL_INFO 3
+#define LOG_LEVEL_DEBUG 4
+
+#ifndef LOG_LEVEL
+#define LOG_LEVEL LOG_LEVEL_INFO
+#endif
+
+// Bytes of log text waiting for the serial port
+#ifndef LOG_BUFFER_SIZE
+#define LOG_BUFFER_SIZE 192
+#endif
+
+// One line per call, the arguments printed one after the other:
+//   LOG_INFO(F("Reader "), readerNum + 1, F(" - Tag removed"));
+// A level that is not compiled in costs nothing - not even the arguments
+// are evaluated.
+#if LOG_LEVEL >= LOG_LEVEL_ERROR
+#define LOG_ERROR(...) Log.message(__VA_ARGS__)
+#else
+#define LOG_ERROR(...) do {} while (0)
+#endif
+
+#if LOG_LEVEL >= LOG_LEVEL_WARN
+#define LOG_WARN(...) Log.message(__VA_ARGS__)
+#else
+#define LOG_WARN(...) do {} while (0)
+#endif
+
+#if LOG_LEVEL >= LOG_LEVEL_INFO
+#define LOG_INFO(...) Log.message(__VA_ARGS__)
+#else
+#define LOG_INFO(...) do {} while (0)
+#endif
+
+#if LOG_LEVEL >= LOG_LEVEL_DEBUG
+#define LOG_DEBUG(...) Log.message(__VA_ARGS__)
+#else
+#define LOG_DEBUG(...) do {} while (0)
+#endif
+
+// Bytes printed as hex, two digits each (tag UIDs)
+struct LogHex {
+    const uint8_t* data;
+    uint8_t length;
+    LogHex(const uint8_t* data, uint8_t length) : data(data), length(length) {}
+};
+
+// Log lines are formatted into a ring buffer right away and written out by
+// drain() only as fast as the serial port takes them, so logging never
+// waits for the port. A line that does not fit is dropped as a whole and
+// counted; the count is logged once the buffer has drained.
+class Logger {
+public:
+    template <typename... Args>
+    void message(Args... args) {
+        lineStart = head;
+        overflow = false;
+        append(args...);
+        put('\n');
+        if (overflow) {
+            head = lineStart;
+            dropped++;
+            droppedTotal++;
+        }
+    }
+
+    // Queue raw bytes (a telemetry frame) between the lines; false if
+    // they do not fit
+    bool write(const uint8_t* data, uint8_t length);
+
+    // Write out what the serial TX buffer takes without blocking
+    void drain();
+
+    // Lines dropped since startup
+    unsigned long getDropped() { return droppedTotal; }
+
+    // Bytes waiting to be written
+    uint8_t pending() { return head >= tail ? head - tail : LOG_BUFFER_SIZE - tail + head; }
+
+private:
+    char buffer[LOG_BUFFER_SIZE];
+    uint8_t head;
+    uint8_t tail;
+    uint8_t lineStart;      // where the line being written begins
+    bool overflow;
+    unsigned long dropped;          // not reported yet
+    unsigned long droppedTotal;
+
+    void writeOut(uint8_t upTo);
+    void append() {}
+
+    template <typename T, typename... Rest>
+    void append(T first, Rest... rest) {
+        put(first);
+        append(rest...);
+    }
+
+    void put(char c);
+    void put(const char* s);
+    void put(const __FlashStringHelper* s);
+    void put(unsigned char n) { put((unsigned long)n); }
+    void put(int n) { put((long)n); }
+    void put(unsigned int n) { put((unsigned long)n); }
+    void put(long n);
+    void put(unsigned long n);
+    void put(const LogHex& hex);
+};
+
+static_assert(LOG_BUFFER_SIZE <= 256, "LOG_BUFFER_SIZE must fit the uint8_t ring indices");
+
+extern Logger Log;
+
+#endif // LOG_H
@@ -0,0 +1,68 @@
+#include "MemoryProbe.h"
+
+#ifdef __AVR__
+
+#define STACK_MARKER 0xC5
+
+extern uint8_t _end;        // end of .bss, start of the heap
+extern uint8_t __stack;     // top of SRAM
+extern uint8_t __data_start;
+extern char* __brkval;      // end of the heap, 0 until the first malloc
+
+// Runs before the C runtime sets up anything, so nothing is on the stack
+// yet: fill everything from the end of .bss to the top of SRAM
+void paintStack() __attribute__((naked, used, section(".init1")));
+void paintStack() {
+    __asm volatile(
+        "    ldi r30, lo8(_end)\n"
+        "    ldi r31, hi8(_end)\n"
+        "    ldi r24, %[marker]\n"
+        "    ldi r25, hi8(__stack)\n"
+        "    rjmp 2f\n"
+        "1:  st Z+, r24\n"
+        "2:  cpi r30, lo8(__stack)\n"
+        "    cpc r31, r25\n"
+        "    brlo 1b\n"
+        "    breq 1b\n"
+        :: [marker] "M" (STACK_MARKER));
+}
+
+void MemoryProbe::read(MemoryReport* report) {
+    uint8_t* heapEnd = __brkval ? (uint8_t*)__brkval : &_end;
+    uint8_t* stackPointer = (uint8_t*)SP;
+
+    // The lowest byte the stack ever wrote is the first overwritten marker
+    uint8_t* p = heapEnd;
+    while (p < stackPointer && *p == STACK_MARKER) p++;
+
+    report->total = RAMEND - RAMSTART + 1;
+    report->staticData = &_end - &__data_start;
+    report->heap = heapEnd - &_end;
+    report->freeNow = stackPointer - heapEnd;
+    report->stackPeak = (uint8_t*)RAMEND - p + 1;
+    report->neverUsed = p - heapEnd;
+}
+
+#else
+
+void MemoryProbe::read(MemoryReport* report) {
+    memset(report, 0, sizeof(MemoryReport));
+}
+
+#endif
+
+void MemoryProbe::print(const MemoryReport& report) {
+    Serial.print(F("SRAM: "));
+    Serial.print(report.staticData);
+    Serial.print(F(" static, "));
+    Serial.print(report.heap);
+    Serial.print(F(" heap, "));
+    Serial.print(report.freeNow);
+    Serial.print(F(" free of "));
+    Serial.println(report.total);
+    Serial.print(F("Stack: "));
+    Serial.print(report.stackPeak);
+    Serial.print(F(" peak, "));
+    Serial.print(report.neverUsed);
+    Serial.println(F(" never used"));
+}
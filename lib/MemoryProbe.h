@@ -0,0 +1,25 @@
+#ifndef MEMORY_PROBE_H
+#define MEMORY_PROBE_H
+
+#include <Arduino.h>
+
+// SRAM use of the running board, in bytes
+struct MemoryReport {
+    uint16_t total;         // SRAM size
+    uint16_t staticData;    // .data and .bss
+    uint16_t heap;          // handed out by malloc (String, new)
+    uint16_t freeNow;       // between the heap and the stack pointer
+    uint16_t stackPeak;     // deepest the stack has been since reset
+    uint16_t neverUsed;     // free bytes the stack has never reached
+};
+
+// The free SRAM is filled with a marker before main() runs; the stack
+// high-water mark is where the marker is still intact. Only measured on
+// AVR - elsewhere the report is all zero.
+class MemoryProbe {
+public:
+    static void read(MemoryReport* report);
+    static void print(const MemoryReport& report);
+};
+
+#endif // MEMORY_PROBE_H
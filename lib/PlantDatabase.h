@@ -3,6 +3,7 @@
 
 #include <Arduino.h>
 #include "BoardConfig.h"
+#include "PlantSet.h"
 
 // Plant ID enum for easy reference
 enum PlantID {
@@ -19,9 +20,12 @@ enum PlantID {
     NUM_PLANTS  // This will be the count of plants
 };
 
-// Structure to hold plant information
+// Set of plant IDs
+typedef PlantBitset<NUM_PLANTS> PlantSet;
+
+// Structure to hold plant information (the catalogue is kept in flash)
 struct Plant {
-    const char* name;               // Plant name
+    const char* name;               // Plant name, in flash
     uint8_t preferredEnvironment;   // Bit flags for preferred conditions
     uint8_t toleratedEnvironment;   // Conditions plant can tolerate
     uint8_t color[3];               // RGB color for this plant's LED display
@@ -30,7 +34,7 @@ struct Plant {
 // Structure to store registered RFID tag info
 struct TagInfo {
     byte uid[4];       // UID of the tag (assuming 4-byte UIDs)
-    PlantID plantId;   // Associated plant
+    uint8_t plantId;   // Associated plant (PlantID)
 };
 
 class PlantDatabase {
@@ -41,29 +45,32 @@ public:
     // Lookup plant by tag UID
     static PlantID identifyPlantByTag(byte* tagUid);
     
-    // Get plant information
-    static const Plant* getPlantInfo(PlantID plantId);
+    // Get plant information, copied out of flash
+    static void getPlantInfo(PlantID plantId, Plant* plant);
+    
+    // Get the plant name for printing
+    static const __FlashStringHelper* getPlantName(PlantID plantId);
     
     // Check relationships between plants
     static PlantRelationship getRelationship(PlantID plant1, PlantID plant2);
     
+    // How a plant feels about a set of neighbors: HATES if it hates any
+    // of them, otherwise LIKES if it likes any of them, otherwise NEUTRAL
+    static PlantRelationship getNeighborhoodRelationship(PlantID plantId, const PlantSet& neighbors);
+    
     // Check if plant thrives in given environment
     static bool plantThrives(PlantID plantId, uint8_t environment);
     
     // Check if plant tolerates given environment
     static bool plantTolerates(PlantID plantId, uint8_t environment);
     
-    // Register a new tag-plant association
+    // Register a new tag-plant association, kept in EEPROM (TagStore.h);
+    // a built-in tag can be registered again to give it another plant
     static bool registerTag(byte* tagUid, PlantID plantId);
-
-private:
-    static Plant plants[NUM_PLANTS];
-    static TagInfo registeredTags[];
-    static int8_t plantRelationships[NUM_PLANTS][NUM_PLANTS];
-    static uint8_t tagCount;
     
-    // Helper function to compare UIDs
-    static bool compareUID(byte* uid1, byte* uid2);
+    // The same without waiting for the EEPROM, written by
+    // TagStore::service(); false if the store is full or still busy
+    static bool registerTagInBackground(byte* tagUid, PlantID plantId);
 };
 
 #endif // PLANT_DATABASE_H
\ No newline at end of file
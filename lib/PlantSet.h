@@ -0,0 +1,42 @@
+#ifndef PLANT_SET_H
+#define PLANT_SET_H
+
+#include <stdint.h>
+
+// The sets are made of words of the native register width
+#ifdef __AVR__
+typedef uint8_t PlantSetWord;
+#else
+typedef uint32_t PlantSetWord;
+#endif
+
+// Set of plant IDs (0 .. N-1), one bit per plant
+template <uint16_t N>
+struct PlantBitset {
+    static const uint8_t WORD_BITS = sizeof(PlantSetWord) * 8;
+    static const uint16_t WORDS = (N + WORD_BITS - 1) / WORD_BITS;
+
+    PlantSetWord words[WORDS];
+
+    void clear() {
+        for (uint16_t i = 0; i < WORDS; i++) words[i] = 0;
+    }
+
+    void set(uint16_t id) {
+        words[id / WORD_BITS] |= (PlantSetWord)1 << (id % WORD_BITS);
+    }
+
+    bool test(uint16_t id) const {
+        return (words[id / WORD_BITS] >> (id % WORD_BITS)) & 1;
+    }
+
+    // Does this set share a plant with the other one?
+    bool intersects(const PlantBitset& other) const {
+        for (uint16_t i = 0; i < WORDS; i++) {
+            if (words[i] & other.words[i]) return true;
+        }
+        return false;
+    }
+};
+
+#endif // PLANT_SET_H
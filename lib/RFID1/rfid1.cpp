@@ -2,16 +2,46 @@
 #include <Arduino.h>  
 //#include "softspi.h"
 
-SOFTSPI softSpi;
+//Timer: TPrescaler = 0x196 gives 60 us ticks, t = (TReload+1) * 60 us
+#define TIMER_MODE 0x81	//TAuto=1; TPrescaler[11..8] = 1
+#define TIMER_PRESCALER 0x96
+static const uchar timerReload[] = {
+    249,	//RFID1_TIMER_LONG: 15 ms
+    8	//RFID1_TIMER_SHORT: 0.54 ms
+};
+
+//CRC_A (ISO 14443-3): CRC-16 0x1021 bit-reversed (0x8408), preset 0x6363,
+//LSB first. The table holds the CRC of every byte value and is built by
+//the compiler into flash.
+#define CRC_A_POLY 0x8408
+#define CRC_A_PRESET 0x6363
+static constexpr uint16_t crcAEntry(uint16_t crc, uchar bits)
+{
+    return bits == 0 ? crc : crcAEntry((crc & 1) ? (crc >> 1) ^ CRC_A_POLY : crc >> 1, bits - 1);
+}
+#define CRC_A_1(n) crcAEntry(n, 8)
+#define CRC_A_4(n) CRC_A_1(n), CRC_A_1(n + 1), CRC_A_1(n + 2), CRC_A_1(n + 3)
+#define CRC_A_16(n) CRC_A_4(n), CRC_A_4(n + 4), CRC_A_4(n + 8), CRC_A_4(n + 12)
+#define CRC_A_64(n) CRC_A_16(n), CRC_A_16(n + 16), CRC_A_16(n + 32), CRC_A_16(n + 48)
+static const uint16_t crcATable[256] PROGMEM = {
+    CRC_A_64(0), CRC_A_64(64), CRC_A_64(128), CRC_A_64(192)
+};
+static_assert(crcAEntry(0x80, 8) == 0x8408, "CRC_A table entry");
   
 void RFID1::begin(uchar csnPin, uchar sckPin, uchar mosiPin, uchar misoPin, uchar chipSelectPin, uchar NRSTPD)
 {
-  softSpi.begin(csnPin, sckPin, mosiPin, misoPin);
+  _spi.begin(csnPin, sckPin, mosiPin, misoPin);
   pinMode(chipSelectPin, OUTPUT);
   digitalWrite(chipSelectPin, LOW);  //Set RFID as write mode
   pinMode(NRSTPD, OUTPUT);
   _chipSelectPin = chipSelectPin;
   _NRSTPD = NRSTPD;
+  _configCount = 0;
+  _reinits = 0;
+  _timerProfile = RFID1_TIMER_LONG;
+  _transactions = 0;
+  _txOp = RFID1_OP_NONE;
+  _txPending = 0;
 }
 /**********************************************************
  * Function：ShowCardID
@@ -37,19 +67,19 @@ void RFID1::showCardID(uchar *id)
  **********************************************************/
 void RFID1::showCardType(uchar* type)
 {
-    Serial.print("Card type: ");
+    Serial.print(F("Card type: "));
     if(type[0]==0x04&&type[1]==0x00) 
-        Serial.println("MFOne-S50");
+        Serial.println(F("MFOne-S50"));
     else if(type[0]==0x02&&type[1]==0x00)
-        Serial.println("MFOne-S70");
+        Serial.println(F("MFOne-S70"));
     else if(type[0]==0x44&&type[1]==0x00)
-        Serial.println("MF-UltraLight");
+        Serial.println(F("MF-UltraLight"));
     else if(type[0]==0x08&&type[1]==0x00)
-        Serial.println("MF-Pro");
+        Serial.println(F("MF-Pro"));
     else if(type[0]==0x44&&type[1]==0x03)
-        Serial.println("MF Desire");
+        Serial.println(F("MF Desire"));
     else
-        Serial.println("Unknown");
+        Serial.println(F("Unknown"));
 }
 /**********************************************************
  * Function：Write_MFRC5200
@@ -62,8 +92,8 @@ void RFID1::writeTo(uchar addr, uchar val)
     digitalWrite(_chipSelectPin, LOW);
 
     //address format：0XXXXXX0
-    softSpi.writeByte((addr<<1)&0x7E); 
-    softSpi.writeByte(val);
+    _spi.writeByte((addr<<1)&0x7E); 
+    _spi.writeByte(val);
     
     digitalWrite(_chipSelectPin, HIGH);
 }
@@ -80,8 +110,8 @@ uchar RFID1::readFrom(uchar addr)
     digitalWrite(_chipSelectPin, LOW);
 
     //address format：1XXXXXX0
-    softSpi.writeByte(((addr<<1)&0x7E) | 0x80); 
-    val = softSpi.SPI_RW(0x00);
+    _spi.writeByte(((addr<<1)&0x7E) | 0x80); 
+    val = _spi.SPI_RW(0x00);
     
     digitalWrite(_chipSelectPin, HIGH);
     
@@ -160,11 +190,12 @@ void RFID1::init(void)
 
     reset();
          
-    //Timer: TPrescaler*TreloadVal/6.78MHz = 24ms
-    writeTo(TModeReg, 0x8D); //Tauto=1; f(Timer) = 6.78MHz/TPreScaler
-    writeTo(TPrescalerReg, 0x3E); //TModeReg[3..0] + TPrescalerReg
-    writeTo(TReloadRegL, 30); 
+    //Timer: 15 ms until a transceive without answer gives up
+    writeTo(TModeReg, TIMER_MODE);
+    writeTo(TPrescalerReg, TIMER_PRESCALER);
+    writeTo(TReloadRegL, timerReload[RFID1_TIMER_LONG]);
     writeTo(TReloadRegH, 0);
+    _timerProfile = RFID1_TIMER_LONG;
     
     writeTo(TxAutoReg, 0x40); //100%ASK
     writeTo(ModeReg, 0x3D); //CRC initilizate value 0x6363 ???
@@ -192,6 +223,7 @@ uchar RFID1::request(uchar reqMode, uchar *TagType)
     uchar status; 
     uint backBits; //the data bits that received
 
+    setTimerProfile(RFID1_TIMER_SHORT);
     writeTo(BitFramingReg, 0x07); //TxLastBists = BitFramingReg[2..0] ???
     
     TagType[0] = reqMode;
@@ -255,6 +287,7 @@ uchar RFID1::toCard(uchar command, uchar *sendData, uchar sendLen, uchar *backDa
 
     //procceed it
     writeTo(CommandReg, command);
+    _transactions++;
     if (command == PCD_TRANSCEIVE)
     { 
         setBitMask(BitFramingReg, 0x80); //StartSend=1,transmission of data starts 
@@ -339,6 +372,7 @@ uchar RFID1::anticoll(uchar *serNum)
     
     //ClearBitMask(Status2Reg, 0x08); //strSensclear
     //ClearBitMask(CollReg,0x80); //ValuesAfterColl
+    setTimerProfile(RFID1_TIMER_LONG);
     writeTo(BitFramingReg, 0x00); //TxLastBists = BitFramingReg[2..0]
  
     serNum[0] = PICC_ANTICOLL;
@@ -364,37 +398,23 @@ uchar RFID1::anticoll(uchar *serNum)
 }
 /*
  * Function：CalulateCRC
- * Description：Use MF522 to caculate CRC
- * Input parameter：pIndata--the CRC data need to be read，len--data length，pOutData-- the caculated result of CRC
+ * Description：caculate the CRC_A of a frame in software, one table lookup
+ * per byte; the MF522 CRC coprocessor (PCD_CALCCRC) is not used, so no SPI
+ * transfer is needed
+ * Input parameter：pIndata--the CRC data need to be read，len--data length，pOutData-- the caculated result of CRC, low byte first
  * return：Null
  */
-void RFID1::calulateCRC(uchar *pIndata, uchar len, uchar *pOutData)
+void RFID1::calulateCRC(const uchar *pIndata, uchar len, uchar *pOutData)
 {
-    uchar i, n;
+    uint16_t crc = CRC_A_PRESET;
 
-    clearBitMask(DivIrqReg, 0x04); //CRCIrq = 0
-    setBitMask(FIFOLevelReg, 0x80); //Clear FIFO pointer
-    //Write_MFRC522(CommandReg, PCD_IDLE);
-
-    //Write data into FIFO 
-    for (i=0; i<len; i++)
-    { 
-        writeTo(FIFODataReg, *(pIndata+i)); 
-    }
-    writeTo(CommandReg, PCD_CALCCRC);
-
-    //waite CRC caculation to finish
-    i = 0xFF;
-    do 
+    for (uchar i=0; i<len; i++)
     {
-        n = readFrom(DivIrqReg);
-        i--;
+        crc = (crc >> 8) ^ pgm_read_word(&crcATable[(crc ^ pIndata[i]) & 0xFF]);
     }
-    while ((i!=0) && !(n&0x04)); //CRCIrq = 1
 
-    //read CRC caculation result
-    pOutData[0] = readFrom(CRCResultRegL);
-    pOutData[1] = readFrom(CRCResultRegM);
+    pOutData[0] = crc & 0xFF;
+    pOutData[1] = crc >> 8;
 }
 /*
  * Function：MFRC522_Write
@@ -409,6 +429,7 @@ uchar RFID1::write(uchar blockAddr, uchar *writeData)
     uchar i;
     uchar buff[18]; 
     
+    setTimerProfile(RFID1_TIMER_LONG);
     buff[0] = PICC_WRITE;
     buff[1] = blockAddr;
     calulateCRC(buff, 2, &buff[2]);
@@ -453,4 +474,543 @@ void RFID1::halt(void)
     calulateCRC(buff, 2, &buff[2]);
  
     status = toCard(PCD_TRANSCEIVE, buff, 4, buff,&unLen);
-}
\ No newline at end of file
+}
+/*
+ * Function：BeginBank
+ * Description：set up bank mode, one RFID1 object driving every chip on the bus
+ * Input parameter：misoPins--MISO pin of each chip, count--number of chips,
+ * chipSelectPin/NRSTPD--the shared SS and reset pins
+ * return：null
+ */
+void RFID1::beginBank(uchar sckPin, uchar mosiPin, const uchar *misoPins, uchar count, uchar chipSelectPin, uchar NRSTPD)
+{
+  _spi.beginMulti(chipSelectPin, sckPin, mosiPin, misoPins, count);
+  pinMode(chipSelectPin, OUTPUT);
+  digitalWrite(chipSelectPin, LOW);  //Set RFID as write mode
+  pinMode(NRSTPD, OUTPUT);
+  _chipSelectPin = chipSelectPin;
+  _NRSTPD = NRSTPD;
+  _configCount = 0;
+  _reinits = 0;
+  _timerProfile = RFID1_TIMER_LONG;
+  _transactions = 0;
+  _txOp = RFID1_OP_NONE;
+  _txPending = 0;
+}
+/*
+ * Function：ReadFromAll
+ * Description：read one register of every chip in a single bus transaction
+ * Input parameter：addr--register address, vals--receives readerCount() values
+ * return：null
+ */
+void RFID1::readFromAll(uchar addr, uchar *vals)
+{
+    digitalWrite(_chipSelectPin, LOW);
+
+    //address format：1XXXXXX0
+    _spi.writeByte(((addr<<1)&0x7E) | 0x80);
+    _spi.transferMulti(0x00, vals);
+
+    digitalWrite(_chipSelectPin, HIGH);
+}
+/*
+ * Function：ToCardAll
+ * Description：toCard() for every chip in the bank at once. The command is
+ * written once for all chips, the wait loop and the FIFO reads clock the bus
+ * once per step and sample every chip.
+ * Input parameter：mask--chips whose result matters, backData--readerCount()
+ * rows of backStride bytes, backLen--received bits per chip
+ * return：mask of chips that returned MI_OK
+ */
+uchar RFID1::toCardAll(uchar command, uchar *sendData, uchar sendLen, uchar mask, uchar *backData, uchar backStride, uint *backLen)
+{
+    uint i;
+
+    txStart(command, sendData, sendLen, mask);
+
+    //wait until every chip in the mask answered or ran into its timer
+    i = 2000;
+    while (txPollIrq() && i != 0)
+    {
+        i--;
+    }
+
+    return txFinish(backData, backStride, backLen);
+}
+/*
+ * Function：TxStart
+ * Description：first half of toCardAll(): load the FIFO and start the command
+ * Input parameter：command--MF522 command bits, mask--chips to wait for
+ * return：null
+ */
+void RFID1::txStart(uchar command, uchar *sendData, uchar sendLen, uchar mask)
+{
+    uchar i;
+
+    _txIrqEn = 0x00;
+    _txWaitIRq = 0x00;
+    switch (command)
+    {
+        case PCD_AUTHENT:
+            _txIrqEn = 0x12;
+            _txWaitIRq = 0x10;
+            break;
+        case PCD_TRANSCEIVE:
+            _txIrqEn = 0x77;
+            _txWaitIRq = 0x30;
+            break;
+        default:
+            break;
+    }
+    _txCommand = command;
+    _txMask = mask;
+    _txPending = mask;
+    for (i=0; i<RFID1_MAX_READERS; i++)
+    {
+        _txIrq[i] = 0;
+    }
+
+    //every chip sees the same writes, so the setup matches toCard()
+    writeTo(CommIEnReg, _txIrqEn|0x80);
+    writeTo(CommIrqReg, 0x7F); //Set1=0: clear all the interrupt bits
+    writeTo(FIFOLevelReg, 0x80); //FlushBuffer=1
+    writeTo(CommandReg, PCD_IDLE);
+
+    for (i=0; i<sendLen; i++)
+    {
+        writeTo(FIFODataReg, sendData[i]);
+    }
+
+    writeTo(CommandReg, command);
+    _transactions++;
+    if (command == PCD_TRANSCEIVE)
+    {
+        writeTo(BitFramingReg, readFrom(BitFramingReg) | 0x80); //StartSend=1
+    }
+}
+/*
+ * Function：TxPollIrq
+ * Description：read CommIrqReg of every chip once (one bus transaction)
+ * Input parameter：null
+ * return：mask of chips that are still waiting
+ */
+uchar RFID1::txPollIrq(void)
+{
+    uchar irq[RFID1_MAX_READERS];
+    uchar count = readerCount();
+    uchar k;
+
+    if (!_txPending)
+    {
+        return 0;
+    }
+    readFromAll(CommIrqReg, irq);
+    for (k=0; k<count; k++)
+    {
+        if ((_txPending & (1 << k)) && ((irq[k] & 0x01) || (irq[k] & _txWaitIRq)))
+        {
+            _txPending &= ~(1 << k);
+            _txIrq[k] = irq[k];
+        }
+    }
+    return _txPending;
+}
+/*
+ * Function：TxFinish
+ * Description：second half of toCardAll(): check errors and read the FIFOs
+ * Input parameter：backData--readerCount() rows of backStride bytes,
+ * backLen--received bits per chip
+ * return：mask of chips that returned MI_OK
+ */
+uchar RFID1::txFinish(uchar *backData, uchar backStride, uint *backLen)
+{
+    uchar okMask = 0;
+    uchar count = readerCount();
+    uchar err[RFID1_MAX_READERS];
+    uchar level[RFID1_MAX_READERS];
+    uchar control[RFID1_MAX_READERS];
+    uchar data[RFID1_MAX_READERS];
+    uchar maxLevel = 0;
+    uchar i, k, n;
+
+    writeTo(BitFramingReg, readFrom(BitFramingReg) & (~0x80)); //StartSend=0
+
+    readFromAll(ErrorReg, err);
+    if (_txCommand == PCD_TRANSCEIVE)
+    {
+        readFromAll(FIFOLevelReg, level);
+        readFromAll(ControlReg, control);
+    }
+
+    for (k=0; k<count; k++)
+    {
+        if (!(_txMask & (1 << k)) || (_txPending & (1 << k)))
+        {
+            continue;
+        }
+        if ((err[k] & 0x1B) || (_txIrq[k] & _txIrqEn & 0x01))
+        {
+            continue; //protocol error or no tag answered before the timer
+        }
+        okMask |= (1 << k);
+        if (_txCommand == PCD_TRANSCEIVE)
+        {
+            n = level[k];
+            if (control[k] & 0x07)
+            {
+                backLen[k] = (n-1)*8 + (control[k] & 0x07);
+            }
+            else
+            {
+                backLen[k] = n*8;
+            }
+            if (n > backStride)
+            {
+                level[k] = backStride;
+            }
+            if (level[k] > maxLevel)
+            {
+                maxLevel = level[k];
+            }
+        }
+    }
+
+    //read the FIFOs side by side, a chip with fewer bytes just returns junk
+    for (i=0; i<maxLevel; i++)
+    {
+        readFromAll(FIFODataReg, data);
+        for (k=0; k<count; k++)
+        {
+            if ((okMask & (1 << k)) && i < level[k])
+            {
+                backData[k*backStride + i] = data[k];
+            }
+        }
+    }
+
+    _txPending = 0;
+    return okMask;
+}
+/*
+ * Function：RequestAll
+ * Description：send REQA/WUPA from every chip in the bank
+ * Input parameter：reqMode--PICC_REQIDL or PICC_REQALL, mask--chips to check
+ * return：mask of chips with a card answering with a 16 bit ATQA
+ */
+uchar RFID1::requestAll(uchar reqMode, uchar mask)
+{
+    startRequest(reqMode, mask);
+    while (!poll())
+    {
+    }
+    return result(0);
+}
+/*
+ * Function：AnticollAll
+ * Description：read the serial number of the card on every chip in the mask
+ * Input parameter：serNums--one row of 4 UID bytes plus check byte per chip
+ * return：mask of chips whose serial number passed the check byte
+ */
+uchar RFID1::anticollAll(uchar mask, uchar serNums[][5])
+{
+    startAnticoll(mask);
+    while (!poll())
+    {
+    }
+    return result(serNums);
+}
+/*
+ * Function：StartSession
+ * Description：reset the chips once and load the session configuration
+ * (same timer and ASK settings as init())
+ * Input parameter：null
+ * return：null
+ */
+void RFID1::startSession(void)
+{
+    digitalWrite(_NRSTPD,HIGH);
+
+    reset();
+
+    _configCount = 0;
+    _reinits = 0;
+
+    //Timer: 15 ms until a transceive without answer gives up
+    setConfig(TModeReg, TIMER_MODE);
+    setConfig(TPrescalerReg, TIMER_PRESCALER);
+    setConfig(TReloadRegL, timerReload[RFID1_TIMER_LONG]);
+    setConfig(TReloadRegH, 0);
+    _timerProfile = RFID1_TIMER_LONG;
+
+    setConfig(TxAutoReg, 0x40); //100%ASK
+    setConfig(ModeReg, 0x3D); //CRC initilizate value 0x6363
+
+    antennaOn(); //turn on antenna
+}
+/*
+ * Function：SetConfig
+ * Description：write a register and keep it as part of the session
+ * configuration, so checkSession() can verify and restore it
+ * Input parameter：reg--register address, val--value
+ * return：null
+ */
+void RFID1::setConfig(uchar reg, uchar val)
+{
+    uchar i;
+
+    for (i=0; i<_configCount; i++)
+    {
+        if (_configRegs[i] == reg)
+        {
+            break;
+        }
+    }
+    if (i == _configCount)
+    {
+        if (_configCount >= RFID1_MAX_CONFIG)
+        {
+            return;
+        }
+        _configRegs[i] = reg;
+        _configCount++;
+    }
+    _configVals[i] = val;
+    writeTo(reg, val);
+}
+/*
+ * Function：SetTimerProfile
+ * Description：change how long the next transceives wait for a card,
+ * without a reset. The new reload value is part of the session
+ * configuration, so checkSession() restores it after a chip reset.
+ * Input parameter：profile--RFID1_TIMER_LONG or RFID1_TIMER_SHORT
+ * return：null
+ */
+void RFID1::setTimerProfile(uchar profile)
+{
+    if (profile == _timerProfile || profile >= sizeof(timerReload))
+    {
+        return;
+    }
+    setConfig(TReloadRegL, timerReload[profile]);
+    _timerProfile = profile;
+}
+/*
+ * Function：ApplyConfig
+ * Description：rewrite the session configuration without a soft reset;
+ * chips that still hold it are not disturbed by the identical writes
+ * Input parameter：null
+ * return：null
+ */
+void RFID1::applyConfig(void)
+{
+    uchar i;
+
+    for (i=0; i<_configCount; i++)
+    {
+        writeTo(_configRegs[i], _configVals[i]);
+    }
+    //antennaOn() only looks at the first chip, a reset chip has it off
+    writeTo(TxControlReg, readFrom(TxControlReg) | 0x03);
+}
+/*
+ * Function：CheckSession
+ * Description：read VersionReg and the session configuration back from
+ * every chip in one pass each and compare a checksum. If any chip lost its
+ * configuration it is written again, without the soft reset of init().
+ * Input parameter：mask--chips to check
+ * return：mask of chips that answer with a valid VersionReg
+ */
+uchar RFID1::checkSession(uchar mask)
+{
+    uchar vals[RFID1_MAX_READERS];
+    uchar sums[RFID1_MAX_READERS];
+    uchar expected = 0;
+    uchar online = 0;
+    uchar stale = 0;
+    uchar count = readerCount();
+    uchar i, k;
+
+    //a chip that is missing or powered down reads as 0x00 or 0xFF
+    readFromAll(VersionReg, vals);
+    for (k=0; k<count; k++)
+    {
+        sums[k] = 0;
+        if ((mask & (1 << k)) && vals[k] != 0x00 && vals[k] != 0xFF)
+        {
+            online |= (1 << k);
+        }
+    }
+
+    for (i=0; i<=_configCount; i++)
+    {
+        uchar want;
+        if (i < _configCount)
+        {
+            readFromAll(_configRegs[i], vals);
+            want = _configVals[i];
+        }
+        else
+        {
+            readFromAll(TxControlReg, vals); //antenna must still be on
+            want = 0x03;
+        }
+        expected = (uchar)((expected << 1) | (expected >> 7)) ^ want;
+        for (k=0; k<count; k++)
+        {
+            uchar got = (i < _configCount) ? vals[k] : (vals[k] & 0x03);
+            sums[k] = (uchar)((sums[k] << 1) | (sums[k] >> 7)) ^ got;
+        }
+    }
+
+    for (k=0; k<count; k++)
+    {
+        if ((online & (1 << k)) && sums[k] != expected)
+        {
+            stale |= (1 << k);
+        }
+    }
+
+    if (stale)
+    {
+        _reinits++;
+        applyConfig();
+    }
+
+    return online;
+}
+/*
+ * Function：StartRequest
+ * Description：start REQA/WUPA on the chips in mask and return at once;
+ * call poll() until it returns 1, then result() gives the chips with a card.
+ * Runs on the short timer: a chip without a card is done within a millisecond.
+ * Input parameter：reqMode--PICC_REQIDL or PICC_REQALL, mask--chips to check
+ * return：null
+ */
+void RFID1::startRequest(uchar reqMode, uchar mask)
+{
+    setTimerProfile(RFID1_TIMER_SHORT);
+    writeTo(BitFramingReg, 0x07); //TxLastBists = BitFramingReg[2..0]
+    txStart(PCD_TRANSCEIVE, &reqMode, 1, mask);
+    _txOp = RFID1_OP_REQUEST;
+    _txStartTime = millis();
+}
+/*
+ * Function：StartAnticoll
+ * Description：start reading the serial numbers on the chips in mask;
+ * result(serNums) returns them once poll() reports completion
+ * Input parameter：mask--chips with a card (usually the request result)
+ * return：null
+ */
+void RFID1::startAnticoll(uchar mask)
+{
+    uchar cmd[2] = {PICC_ANTICOLL, 0x20};
+
+    setTimerProfile(RFID1_TIMER_LONG);
+    writeTo(BitFramingReg, 0x00); //TxLastBists = BitFramingReg[2..0]
+    txStart(PCD_TRANSCEIVE, cmd, 2, mask);
+    _txOp = RFID1_OP_ANTICOLL;
+    _txStartTime = millis();
+}
+/*
+ * Function：StartHalt
+ * Description：send HALT to the cards on the chips in mask. A card never
+ * answers HALT, so the transaction completes once the frame is sent.
+ * Input parameter：mask--chips to wait for
+ * return：null
+ */
+void RFID1::startHalt(uchar mask)
+{
+    uchar buff[4];
+
+    buff[0] = PICC_HALT;
+    buff[1] = 0;
+    calulateCRC(buff, 2, &buff[2]);
+
+    txStart(PCD_TRANSCEIVE, buff, 4, mask);
+    _txWaitIRq |= 0x40; //TxIRq: the frame is out
+    _txOp = RFID1_OP_HALT;
+    _txStartTime = millis();
+}
+/*
+ * Function：Poll
+ * Description：advance the running transaction by one CommIrqReg read;
+ * never waits. A transaction whose chips do not finish within
+ * RFID1_TX_TIMEOUT_MS is closed with those chips marked as failed.
+ * Input parameter：null
+ * return：1 when the transaction is done (or none is running), else 0
+ */
+uchar RFID1::poll(void)
+{
+    uint backBits[RFID1_MAX_READERS];
+    uchar count = readerCount();
+    uchar serNumCheck;
+    uchar i, k;
+
+    if (_txOp == RFID1_OP_NONE || _txOp == RFID1_OP_DONE)
+    {
+        return 1;
+    }
+    if (txPollIrq() && (millis() - _txStartTime) < RFID1_TX_TIMEOUT_MS)
+    {
+        return 0;
+    }
+
+    _txResult = txFinish(&_txData[0][0], 5, backBits);
+    for (k=0; k<count; k++)
+    {
+        if (!(_txResult & (1 << k)))
+        {
+            continue;
+        }
+        if (_txOp == RFID1_OP_REQUEST && backBits[k] != 0x10)
+        {
+            _txResult &= ~(1 << k); //no 16 bit ATQA
+        }
+        else if (_txOp == RFID1_OP_ANTICOLL)
+        {
+            //Verify card serial number
+            serNumCheck = 0;
+            for (i=0; i<4; i++)
+            {
+                serNumCheck ^= _txData[k][i];
+            }
+            if (serNumCheck != _txData[k][4])
+            {
+                _txResult &= ~(1 << k);
+            }
+        }
+    }
+    if (_txOp == RFID1_OP_HALT)
+    {
+        _txResult = _txMask & ~_txPending; //no answer is the expected outcome
+    }
+    _txOp = RFID1_OP_DONE;
+    return 1;
+}
+/*
+ * Function：Result
+ * Description：outcome of the last finished transaction
+ * Input parameter：serNums--receives the serial numbers after an anticoll
+ * (one row of 4 UID bytes plus check byte per chip), may be 0
+ * return：mask of chips that completed with MI_OK
+ */
+uchar RFID1::result(uchar serNums[][5])
+{
+    uchar k;
+
+    if (_txOp != RFID1_OP_DONE)
+    {
+        return 0;
+    }
+    if (serNums)
+    {
+        for (k=0; k<readerCount(); k++)
+        {
+            if (_txResult & (1 << k))
+            {
+                memcpy(serNums[k], _txData[k], 5);
+            }
+        }
+    }
+    return _txResult;
+}
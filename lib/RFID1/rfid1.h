@@ -6,6 +6,21 @@
 
 
 #define MAX_LEN 16	//Define the maximum length of the array
+#define RFID1_MAX_READERS SOFTSPI_MAX_MISO	//Readers that can share one bus in bank mode
+#define RFID1_MAX_CONFIG 10	//Registers tracked by a reader session
+#define RFID1_TX_TIMEOUT_MS 30	//Give up on a transaction the chip timer should have ended
+
+//Chip timer profiles: how long a transceive waits for the card before
+//TimerIRq ends it. Both use 60 us ticks, so a switch is one TReloadRegL write.
+#define RFID1_TIMER_LONG 0	//15 ms: anticollision, select, read, write
+#define RFID1_TIMER_SHORT 1	//0.54 ms: REQA/WUPA, the ATQA comes after about 0.1 ms
+
+//Non-blocking transaction that is currently running
+#define RFID1_OP_NONE 0
+#define RFID1_OP_REQUEST 1
+#define RFID1_OP_ANTICOLL 2
+#define RFID1_OP_HALT 3
+#define RFID1_OP_DONE 4
 
 //#include "SOFTSPI.h"
 
@@ -117,8 +132,8 @@ class RFID1
 	  void  begin(uchar csnPin, uchar sckPin, uchar mosiPin, uchar misoPin, uchar chipSelectPin, uchar NRSTPD);
 	  void  showCardID(uchar *id);
 	  void  showCardType(uchar* type);
-	  void  writeTo(uchar addr, uchar val);
-	  uchar readFrom(uchar addr);
+	  virtual void  writeTo(uchar addr, uchar val);
+	  virtual uchar readFrom(uchar addr);
 	  void  setBitMask(uchar reg, uchar mask);
 	  void  clearBitMask(uchar reg, uchar mask);
 	  void  antennaOn(void);
@@ -128,12 +143,78 @@ class RFID1
 	  uchar request(uchar reqMode, uchar *TagType);
 	  uchar toCard(uchar command, uchar *sendData, uchar sendLen, uchar *backData, uint *backLen);
 	  uchar anticoll(uchar *serNum);
-	  void  calulateCRC(uchar *pIndata, uchar len, uchar *pOutData);
+	  static void  calulateCRC(const uchar *pIndata, uchar len, uchar *pOutData);
 	  uchar write(uchar blockAddr, uchar *writeData);
 	  void  halt(void);
+
+	  // Bank mode: several MFRC522 share SCK, MOSI, SS and RST and each one
+	  // drives its own MISO line. Register writes reach every chip at once,
+	  // reads clock the bus once and return one value per chip. Reader masks
+	  // use bit k for the chip on misoPins[k].
+	  void  beginBank(uchar sckPin, uchar mosiPin, const uchar *misoPins, uchar count, uchar chipSelectPin, uchar NRSTPD);
+	  uchar readerCount(void) { return _spi.misoCount(); }
+	  virtual void  readFromAll(uchar addr, uchar *vals);
+	  uchar toCardAll(uchar command, uchar *sendData, uchar sendLen, uchar mask, uchar *backData, uchar backStride, uint *backLen);
+	  uchar requestAll(uchar reqMode, uchar mask);
+	  uchar anticollAll(uchar mask, uchar serNums[][5]);
+
+	  // Reader session: the chips are reset and configured once, afterwards
+	  // checkSession() only reads the configuration back and rewrites it when
+	  // a chip lost it (soft reset, brownout). setConfig() adds a register to
+	  // the session configuration, call it after startSession().
+	  void  startSession(void);
+	  void  setConfig(uchar reg, uchar val);
+	  uchar checkSession(uchar mask);
+	  uint  sessionReinits(void) { return _reinits; }
+
+	  // Chip timer profile for the next transactions. request(),
+	  // startRequest() and requestAll() switch to RFID1_TIMER_SHORT, so an
+	  // empty reader gives up within a millisecond; anticoll() and write()
+	  // switch back to RFID1_TIMER_LONG. Only TReloadRegL is written, and
+	  // only when the profile changes; the session keeps the current value.
+	  void  setTimerProfile(uchar profile);
+	  uchar timerProfile(void) { return _timerProfile; }
+
+	  // Non-blocking transactions: start one, call poll() from loop() until
+	  // it returns 1, then read result(). Each poll() is one CommIrqReg read,
+	  // so loop() stays responsive while the cards answer. Works in bank mode
+	  // (all chips in the mask at once) and for a single reader (mask 0x01).
+	  void  startRequest(uchar reqMode, uchar mask);
+	  void  startAnticoll(uchar mask);
+	  void  startHalt(uchar mask);
+	  uchar poll(void);
+	  uchar result(uchar serNums[][5]);
+	  uchar busy(void) { return _txOp != RFID1_OP_NONE && _txOp != RFID1_OP_DONE; }
+
+	  // RF transactions (frames sent to the cards) since begin()/beginBank();
+	  // in bank mode one transaction goes out on every reader
+	  unsigned long transactions(void) { return _transactions; }
 	private:
+	  SOFTSPI _spi;
 	  uchar _chipSelectPin;
 	  uchar _NRSTPD;
+	  uchar _configRegs[RFID1_MAX_CONFIG];
+	  uchar _configVals[RFID1_MAX_CONFIG];
+	  uchar _configCount;
+	  uint  _reinits;
+	  uchar _timerProfile;
+	  unsigned long _transactions;
+
+	  uchar _txOp;
+	  uchar _txCommand;
+	  uchar _txIrqEn;
+	  uchar _txWaitIRq;
+	  uchar _txMask;
+	  uchar _txPending;
+	  uchar _txResult;
+	  unsigned long _txStartTime;
+	  uchar _txIrq[RFID1_MAX_READERS];
+	  uchar _txData[RFID1_MAX_READERS][5];
+
+	  void  applyConfig(void);
+	  void  txStart(uchar command, uchar *sendData, uchar sendLen, uchar mask);
+	  uchar txPollIrq(void);
+	  uchar txFinish(uchar *backData, uchar backStride, uint *backLen);
 };
 
 #endif
\ No newline at end of file
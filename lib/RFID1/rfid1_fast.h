@@ -0,0 +1,47 @@
+#ifndef RFID1_FAST_H
+#define RFID1_FAST_H
+
+#include "rfid1.h"
+#include "softspi_fast.h"
+
+/**********************************************************
+ * RFID1Fast
+ * 
+ * RFID1 with the bus pins fixed at compile time. Only the register
+ * access is replaced (through FastSOFTSPI), every command such as
+ * request(), toCard() or requestAll() is inherited unchanged.
+ * Still call begin()/beginBank() with the same pins, it sets the pin
+ * modes and the reader count used in bank mode.
+ **********************************************************/
+template <uchar SS, uchar SCK, uchar MOSI, uchar... MISO>
+class RFID1Fast : public RFID1
+{
+	public:
+	  void writeTo(uchar addr, uchar val) override
+	  {
+	    SoftSpiPin<SS>::low();
+	    Spi::writeByte((addr<<1)&0x7E);
+	    Spi::writeByte(val);
+	    SoftSpiPin<SS>::high();
+	  }
+	  uchar readFrom(uchar addr) override
+	  {
+	    uchar val;
+	    SoftSpiPin<SS>::low();
+	    Spi::writeByte(((addr<<1)&0x7E) | 0x80);
+	    val = Spi::SPI_RW(0x00);
+	    SoftSpiPin<SS>::high();
+	    return val;
+	  }
+	  void readFromAll(uchar addr, uchar *vals) override
+	  {
+	    SoftSpiPin<SS>::low();
+	    Spi::writeByte(((addr<<1)&0x7E) | 0x80);
+	    Spi::transferMulti(0x00, vals);
+	    SoftSpiPin<SS>::high();
+	  }
+	private:
+	  typedef FastSOFTSPI<SCK, MOSI, MISO...> Spi;
+};
+
+#endif
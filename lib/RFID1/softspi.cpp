@@ -11,6 +11,32 @@ void SOFTSPI::begin(uchar csnPin, uchar sckPin, uchar mosiPin, uchar misoPin)
   _sckPin = sckPin;
   _mosiPin = mosiPin;
   _misoPin = misoPin;
+  _misoPins[0] = misoPin;
+  _misoCount = 1;
+}
+/**************************************************
+ * Function: beginMulti();
+ * 
+ * Description:
+ * Same as begin() for a bus where SCK, MOSI and CSN are shared by several
+ * slaves and each slave drives its own MISO line. The first MISO pin is
+ * used by the single-line functions below.
+ **************************************************/
+void SOFTSPI::beginMulti(uchar csnPin, uchar sckPin, uchar mosiPin, const uchar *misoPins, uchar misoCount)
+{
+  uchar i;
+
+  if (misoCount > SOFTSPI_MAX_MISO)
+  {
+    misoCount = SOFTSPI_MAX_MISO;
+  }
+  begin(csnPin, sckPin, mosiPin, misoPins[0]);
+  for (i = 1; i < misoCount; i++)
+  {
+    pinMode(misoPins[i], INPUT);
+    _misoPins[i] = misoPins[i];
+  }
+  _misoCount = misoCount;
 }
 void SOFTSPI::writeByte(uchar dat)
 {
@@ -161,5 +187,43 @@ unsigned char SOFTSPI::writeFromBuf(unsigned char reg, unsigned char *pBuf, unsi
   digitalWrite(_csnPin, 1);                   // Set CSN high again
   return status;                  // return nRF24L01 status unsigned char
 }
+/**************************************************/
+/**************************************************
+ * Function: transferMulti();
+ * 
+ * Description:
+ * Clocks 'Byte' out on MOSI exactly like SPI_RW() and samples every
+ * MISO line on the same SCK edge, so in[k] receives the byte driven by
+ * the slave on misoPins[k]. 'in' must hold misoCount() bytes.
+ **************************************************/
+void SOFTSPI::transferMulti(unsigned char Byte, unsigned char *in)
+{
+  unsigned char i, k;
 
-
+  for (k = 0; k < _misoCount; k++)
+  {
+    in[k] = 0;
+  }
+  for (i = 0; i < 8; i++)
+  {
+    if (Byte & 0x80)
+    {
+      digitalWrite(_mosiPin, 1);
+    }
+    else
+    {
+      digitalWrite(_mosiPin, 0);
+    }
+    digitalWrite(_sckPin, 1);
+    Byte <<= 1;
+    for (k = 0; k < _misoCount; k++)
+    {
+      in[k] <<= 1;
+      if (digitalRead(_misoPins[k]) == 1)
+      {
+        in[k] |= 1;                     // capture MISO bit of slave k
+      }
+    }
+    digitalWrite(_sckPin, 0);
+  }
+}
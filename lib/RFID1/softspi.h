@@ -4,10 +4,13 @@
 #define uchar unsigned char
 #define uint  unsigned int
 
+#define SOFTSPI_MAX_MISO 6	//Maximum number of MISO lines sampled per SCK edge
+
 class SOFTSPI
 {
   public:
 	void begin(uchar csnPin, uchar sckPin, uchar mosiPin, uchar misoPin);
+	void beginMulti(uchar csnPin, uchar sckPin, uchar mosiPin, const uchar *misoPins, uchar misoCount);
 	void writeByte(uchar dat);
 	uchar readByte(void);
 	unsigned char SPI_RW(unsigned char Byte);
@@ -15,11 +18,15 @@ class SOFTSPI
 	unsigned char SPI_Read(unsigned char reg);
 	unsigned char readToBuf(unsigned char reg, unsigned char *pBuf, unsigned char bytes);
 	unsigned char writeFromBuf(unsigned char reg, unsigned char *pBuf, unsigned char bytes);
+	void transferMulti(unsigned char Byte, unsigned char *in);
+	uchar misoCount(void) { return _misoCount; }
   private:
     uchar _csnPin;
 	uchar _sckPin;
 	uchar _mosiPin;
 	uchar _misoPin;
+	uchar _misoPins[SOFTSPI_MAX_MISO];
+	uchar _misoCount;
 };
 
 #endif
\ No newline at end of file
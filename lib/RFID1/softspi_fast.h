@@ -0,0 +1,141 @@
+#ifndef __SOFTSPI_FAST_H
+#define __SOFTSPI_FAST_H
+
+#include <Arduino.h>
+#include "softspi.h"
+
+/**************************************************
+ * FastSOFTSPI
+ * 
+ * Soft-SPI transport with the pins fixed at compile time. On the
+ * ATmega328P (Uno/Nano) every pin access resolves to a single sbi/cbi/sbic
+ * on PORTx/PINx instead of a digitalWrite()/digitalRead() pin-table lookup.
+ * On other targets it falls back to the Arduino pin functions, so the same
+ * code still runs (just without the speedup). Use SOFTSPI when the pins
+ * are only known at runtime.
+ *
+ * MISO may list several pins: transferMulti() samples all of them on the
+ * same SCK edge, like SOFTSPI::transferMulti().
+ **************************************************/
+
+template <uchar PIN>
+struct SoftSpiPin
+{
+#if defined(__AVR_ATmega328P__) || defined(__AVR_ATmega168__)
+  // Arduino pins 0-7 are PORTD, 8-13 PORTB, 14-19 (A0-A5) PORTC
+  static inline void high(void)
+  {
+    if (PIN < 8) PORTD |= _BV(PIN & 7);
+    else if (PIN < 14) PORTB |= _BV((PIN - 8) & 7);
+    else PORTC |= _BV((PIN - 14) & 7);
+  }
+  static inline void low(void)
+  {
+    if (PIN < 8) PORTD &= ~_BV(PIN & 7);
+    else if (PIN < 14) PORTB &= ~_BV((PIN - 8) & 7);
+    else PORTC &= ~_BV((PIN - 14) & 7);
+  }
+  static inline uchar read(void)
+  {
+    if (PIN < 8) return (PIND >> (PIN & 7)) & 0x01;
+    else if (PIN < 14) return (PINB >> ((PIN - 8) & 7)) & 0x01;
+    else return (PINC >> ((PIN - 14) & 7)) & 0x01;
+  }
+#else
+  static inline void high(void) { digitalWrite(PIN, HIGH); }
+  static inline void low(void) { digitalWrite(PIN, LOW); }
+  static inline uchar read(void) { return digitalRead(PIN) == HIGH; }
+#endif
+  static inline void write(uchar val)
+  {
+    if (val) high();
+    else low();
+  }
+};
+
+template <uchar SCK, uchar MOSI, uchar... MISO>
+class FastSOFTSPI
+{
+  public:
+	static const uchar misoCount = sizeof...(MISO);
+
+	static void begin(void)
+	{
+	  const uchar misoPins[] = {MISO...};
+	  uchar i;
+
+	  pinMode(SCK, OUTPUT);
+	  pinMode(MOSI, OUTPUT);
+	  for (i = 0; i < misoCount; i++)
+	  {
+	    pinMode(misoPins[i], INPUT);
+	  }
+	}
+
+	static void writeByte(uchar dat)
+	{
+	  uchar i;
+	  for (i = 0; i < 8; i++)
+	  {
+	    SoftSpiPin<SCK>::low();
+	    SoftSpiPin<MOSI>::write(dat & 0x80);
+	    dat <<= 1;
+	    SoftSpiPin<SCK>::high();
+	  }
+	  SoftSpiPin<SCK>::low();
+	}
+
+	// Same timing as SOFTSPI::SPI_RW(), reads the first MISO pin
+	static uchar SPI_RW(uchar Byte)
+	{
+	  uchar i;
+	  for (i = 0; i < 8; i++)
+	  {
+	    SoftSpiPin<MOSI>::write(Byte & 0x80);
+	    SoftSpiPin<SCK>::high();
+	    Byte <<= 1;
+	    Byte |= readFirst<MISO...>();
+	    SoftSpiPin<SCK>::low();
+	  }
+	  return Byte;
+	}
+
+	static void transferMulti(uchar Byte, uchar *in)
+	{
+	  uchar i;
+	  for (i = 0; i < misoCount; i++)
+	  {
+	    in[i] = 0;
+	  }
+	  for (i = 0; i < 8; i++)
+	  {
+	    SoftSpiPin<MOSI>::write(Byte & 0x80);
+	    SoftSpiPin<SCK>::high();
+	    Byte <<= 1;
+	    sampleAll<MISO...>(in);
+	    SoftSpiPin<SCK>::low();
+	  }
+	}
+
+  private:
+	template <uchar FIRST, uchar... REST>
+	static inline uchar readFirst(void)
+	{
+	  return SoftSpiPin<FIRST>::read();
+	}
+
+	template <uchar FIRST>
+	static inline void sampleAll(uchar *in)
+	{
+	  *in = (uchar)((*in << 1) | SoftSpiPin<FIRST>::read());
+	}
+
+	template <uchar FIRST, uchar SECOND, uchar... REST>
+	static inline void sampleAll(uchar *in)
+	{
+	  *in = (uchar)((*in << 1) | SoftSpiPin<FIRST>::read());
+	  sampleAll<SECOND, REST...>(in + 1);
+	}
+};
+
+#endif
@@ -0,0 +1,191 @@
+#include "RingEffects.h"
+
+#define NO_FRAME 0xFFFF
+
+// Frame styles
+enum EffectStyle {
+    STYLE_SOLID = 0,    // color at full brightness
+    STYLE_PULSE,        // 100% down to 20% and back up
+    STYLE_RAMP,         // 20%, 40% ... 100%
+    STYLE_RAINBOW       // rainbow around the ring, rotated by one per frame
+};
+
+// Effect flags
+#define EFFECT_CLEAR_AT_END 0x01
+
+// How an effect is played: 'frames' frames of 'frameTicks' ticks each,
+// 'cycles' times, with 'pauseTicks' of the last frame after every cycle.
+// frames = 0 takes the frame count from the play() parameter.
+struct EffectDef {
+    uint8_t frameTicks;
+    uint8_t frames;
+    uint8_t cycles;
+    uint8_t pauseTicks;
+    uint8_t style;
+    uint8_t flags;
+};
+
+// Timings match the delay()-based effects they replace (5 ms ticks)
+static const EffectDef effectTable[NUM_EFFECTS] PROGMEM = {
+    // EFFECT_NONE
+    {1, 1, 0, 0, STYLE_SOLID, 0},
+    // EFFECT_PULSE - 18 frames of 20 ms
+    {4, 18, 1, 0, STYLE_PULSE, 0},
+    // EFFECT_LIKES - three pulses, 100 ms apart
+    {4, 18, 3, 20, STYLE_PULSE, 0},
+    // EFFECT_DISLIKES - three pulses, 100 ms apart
+    {4, 18, 3, 20, STYLE_PULSE, 0},
+    // EFFECT_GROWTH - five steps of 100 ms
+    {20, 5, 1, 0, STYLE_RAMP, 0},
+    // EFFECT_RAINBOW - 15 ms per frame
+    {3, 0, 1, 0, STYLE_RAINBOW, 0},
+    // EFFECT_FLASH - 600 ms on, then off
+    {20, 6, 1, 0, STYLE_SOLID, EFFECT_CLEAR_AT_END}
+};
+
+static void loadEffect(uint8_t type, uint8_t param, EffectDef* def) {
+    const EffectDef* entry = &effectTable[type];
+    def->frameTicks = pgm_read_byte(&entry->frameTicks);
+    def->frames = pgm_read_byte(&entry->frames);
+    def->cycles = pgm_read_byte(&entry->cycles);
+    def->pauseTicks = pgm_read_byte(&entry->pauseTicks);
+    def->style = pgm_read_byte(&entry->style);
+    def->flags = pgm_read_byte(&entry->flags);
+    if (def->frames == 0) def->frames = param;
+}
+
+void RingEffects::begin() {
+    for (uint8_t i = 0; i < NUM_READERS; i++) {
+        rings[i].queued = 0;
+        ringLeds[i] = nullptr;
+    }
+    lastTickTime = millis();
+}
+
+void RingEffects::attachRing(uint8_t ringNum, CRGB* firstLed) {
+    if (ringNum < 1 || ringNum > NUM_READERS) return;
+    ringLeds[ringNum - 1] = firstLed;
+}
+
+bool RingEffects::play(uint8_t ringNum, EffectType type, uint8_t r, uint8_t g, uint8_t b, uint8_t param) {
+    if (ringNum < 1 || ringNum > NUM_READERS) return false;
+    if (type == EFFECT_NONE || type >= NUM_EFFECTS) return false;
+
+    RingAnimation& anim = rings[ringNum - 1];
+    if (anim.queued > EFFECT_QUEUE_DEPTH) return false;  // Queue full
+
+    if (anim.queued == 0) {
+        anim.ticks = 0;
+        anim.frame = NO_FRAME;
+    }
+    EffectSlot& slot = anim.queue[anim.queued++];
+    slot.type = type;
+    slot.r = r;
+    slot.g = g;
+    slot.b = b;
+    slot.param = param;
+    return true;
+}
+
+void RingEffects::stop(uint8_t ringNum) {
+    if (ringNum < 1 || ringNum > NUM_READERS) return;
+    rings[ringNum - 1].queued = 0;
+}
+
+bool RingEffects::isActive(uint8_t ringNum) {
+    if (ringNum < 1 || ringNum > NUM_READERS) return false;
+    return rings[ringNum - 1].queued != 0;
+}
+
+uint8_t RingEffects::update(unsigned long currentMillis) {
+    unsigned long elapsed = (currentMillis - lastTickTime) / EFFECT_TICK_MS;
+    lastTickTime += elapsed * EFFECT_TICK_MS;
+    if (elapsed > 0xFFFF) elapsed = 0xFFFF;  // Far behind - just skip ahead
+
+    uint8_t changed = 0;
+    for (uint8_t i = 0; i < NUM_READERS; i++) {
+        if (rings[i].queued && advance(i, elapsed)) {
+            changed |= (1 << i);
+        }
+    }
+    return changed;
+}
+
+bool RingEffects::advance(uint8_t ring, uint16_t ticks) {
+    RingAnimation& anim = rings[ring];
+    bool changed = false;
+
+    while (anim.queued) {
+        EffectDef def;
+        loadEffect(anim.queue[0].type, anim.queue[0].param, &def);
+        uint16_t cycleTicks = def.frames * def.frameTicks + def.pauseTicks;
+        uint32_t totalTicks = (uint32_t)cycleTicks * def.cycles;
+
+        if ((uint32_t)anim.ticks + ticks < totalTicks) {
+            anim.ticks += ticks;
+
+            // Frame within the cycle; the pause holds the last frame
+            uint16_t cycle = anim.ticks / cycleTicks;
+            uint16_t frame = (anim.ticks % cycleTicks) / def.frameTicks;
+            if (frame >= def.frames) frame = def.frames - 1;
+
+            uint16_t absoluteFrame = cycle * def.frames + frame;
+            if (absoluteFrame != anim.frame) {
+                render(ring, frame);
+                anim.frame = absoluteFrame;
+                changed = true;
+            }
+            break;
+        }
+
+        // Effect finished - carry the remaining ticks into the next one
+        ticks -= totalTicks - anim.ticks;
+        if ((def.flags & EFFECT_CLEAR_AT_END) && ringLeds[ring]) {
+            for (uint8_t i = 0; i < NUM_LEDS_PER_RING; i++) {
+                ringLeds[ring][i] = CRGB(0, 0, 0);
+            }
+            changed = true;
+        }
+        next(ring);
+    }
+    return changed;
+}
+
+void RingEffects::render(uint8_t ring, uint16_t frame) {
+    CRGB* ledsOut = ringLeds[ring];
+    if (!ledsOut) return;
+
+    const EffectSlot& slot = rings[ring].queue[0];
+    EffectDef def;
+    loadEffect(slot.type, slot.param, &def);
+
+    if (def.style == STYLE_RAINBOW) {
+        for (uint8_t i = 0; i < NUM_LEDS_PER_RING; i++) {
+            ledsOut[i] = CHSV((i * 256 / NUM_LEDS_PER_RING) + frame, 255, 255);
+        }
+        return;
+    }
+
+    uint8_t brightness = 100;
+    if (def.style == STYLE_PULSE) {
+        // Frames 0-8 dim from 100% to 20%, frames 9-17 come back up
+        brightness = frame < 9 ? (10 - frame) * 10 : (frame - 7) * 10;
+    } else if (def.style == STYLE_RAMP) {
+        brightness = 20 * (frame + 1);
+    }
+
+    CRGB color((slot.r * brightness) / 100, (slot.g * brightness) / 100, (slot.b * brightness) / 100);
+    for (uint8_t i = 0; i < NUM_LEDS_PER_RING; i++) {
+        ledsOut[i] = color;
+    }
+}
+
+void RingEffects::next(uint8_t ring) {
+    RingAnimation& anim = rings[ring];
+    for (uint8_t i = 1; i < anim.queued; i++) {
+        anim.queue[i - 1] = anim.queue[i];
+    }
+    anim.queued--;
+    anim.ticks = 0;
+    anim.frame = NO_FRAME;
+}
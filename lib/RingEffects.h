@@ -0,0 +1,74 @@
+#ifndef RING_EFFECTS_H
+#define RING_EFFECTS_H
+
+#include <Arduino.h>
+#include <FastLED.h>
+#include "BoardConfig.h"
+
+// Base tick of the animation engine; every frame time is a multiple of it
+#define EFFECT_TICK_MS 5
+
+// Effects waiting per ring behind the one that is playing
+#define EFFECT_QUEUE_DEPTH 3
+
+// Effects the rings can play (index into the effect table)
+enum EffectType {
+    EFFECT_NONE = 0,
+    EFFECT_PULSE,       // dim down and back up once
+    EFFECT_LIKES,       // three pulses
+    EFFECT_DISLIKES,    // three pulses
+    EFFECT_GROWTH,      // ramp up from dim to full in five steps
+    EFFECT_RAINBOW,     // rotating rainbow, param = number of frames
+    EFFECT_FLASH,       // solid color for a moment, then off
+    NUM_EFFECTS
+};
+
+// A queued or playing effect on one ring
+struct EffectSlot {
+    uint8_t type;
+    uint8_t r, g, b;
+    uint8_t param;
+};
+
+// Animation state of one ring
+struct RingAnimation {
+    EffectSlot queue[EFFECT_QUEUE_DEPTH + 1];   // queue[0] is playing
+    uint8_t queued;                             // entries in use
+    uint16_t ticks;                             // ticks since queue[0] started
+    uint16_t frame;                             // last frame rendered
+};
+
+// Frame-based LED ring animations. Effects are described by a table
+// (frame time, frame count, repeats, pause) and advanced from update()
+// on a fixed tick, so all rings animate at once without blocking the loop.
+class RingEffects {
+public:
+    void begin();
+
+    // Tell the engine where the LEDs of a ring (1-based) live
+    void attachRing(uint8_t ringNum, CRGB* firstLed);
+
+    // Queue an effect behind whatever the ring is playing
+    bool play(uint8_t ringNum, EffectType type, uint8_t r, uint8_t g, uint8_t b, uint8_t param = 0);
+
+    // Drop the playing and queued effects; the LEDs keep their last frame
+    void stop(uint8_t ringNum);
+
+    // Is the ring playing an effect?
+    bool isActive(uint8_t ringNum);
+
+    // Advance all rings to the current time. Returns a mask of rings that
+    // got a new frame (bit 0 = ring 1); the caller shows them.
+    uint8_t update(unsigned long currentMillis);
+
+private:
+    RingAnimation rings[NUM_READERS];
+    CRGB* ringLeds[NUM_READERS];
+    unsigned long lastTickTime;
+
+    bool advance(uint8_t ring, uint16_t ticks);
+    void render(uint8_t ring, uint16_t frame);
+    void next(uint8_t ring);
+};
+
+#endif // RING_EFFECTS_H
@@ -0,0 +1,219 @@
+#include "TagStore.h"
+#include <EEPROM.h>
+#include "Log.h"
+
+#define HEADER_MAGIC_0 'T'
+#define HEADER_MAGIC_1 'G'
+
+// Slots between the home slots of two generations; coprime to the slot
+// count, so every generation starts its chains somewhere else
+#define GENERATION_STRIDE 53
+
+uint8_t TagStore::generation = 0;
+uint8_t TagStore::tagCount = 0;
+TagStore::Record TagStore::pending;
+uint8_t TagStore::pendingSlot = 0;
+uint8_t TagStore::pendingWritten = TAG_STORE_RECORD_SIZE;
+
+// CRC-8, polynomial 0x07
+static uint8_t crc8(const uint8_t* data, uint8_t length) {
+    uint8_t crc = 0;
+    for (uint8_t i = 0; i < length; i++) {
+        crc ^= data[i];
+        for (uint8_t bit = 0; bit < 8; bit++) {
+            crc = (crc & 0x80) ? (crc << 1) ^ 0x07 : crc << 1;
+        }
+    }
+    return crc;
+}
+
+static int slotAddress(uint8_t slot) {
+    return TAG_STORE_HEADER_SIZE + slot * TAG_STORE_RECORD_SIZE;
+}
+
+void TagStore::begin() {
+    pendingWritten = TAG_STORE_RECORD_SIZE;
+
+    uint8_t header[TAG_STORE_HEADER_SIZE];
+    for (uint8_t i = 0; i < TAG_STORE_HEADER_SIZE; i++) {
+        header[i] = EEPROM.read(i);
+    }
+
+    if (header[0] != HEADER_MAGIC_0 || header[1] != HEADER_MAGIC_1 ||
+        header[2] != TAG_STORE_VERSION || header[3] != TAG_STORE_SLOTS ||
+        header[5] != crc8(header, 5)) {
+        LOG_WARN(F("Tag store: no valid store in EEPROM, formatting"));
+        format();
+        return;
+    }
+
+    generation = header[4];
+    tagCount = 0;
+    Record record;
+    for (uint8_t slot = 0; slot < TAG_STORE_SLOTS; slot++) {
+        if (readRecord(slot, &record) == SLOT_USED) tagCount++;
+    }
+}
+
+bool TagStore::lookup(const uint8_t* uid, uint8_t* plantId) {
+    Record record;
+    uint8_t slot = homeSlot(uid);
+    for (uint8_t probe = 0; probe < TAG_STORE_SLOTS; probe++) {
+        // The chain ends at the first free slot
+        uint8_t state = readRecord(slot, &record);
+        if (state == SLOT_FREE) return false;
+        if (state == SLOT_USED && memcmp(record.uid, uid, 4) == 0) {
+            *plantId = record.plantId;
+            return true;
+        }
+        if (++slot == TAG_STORE_SLOTS) slot = 0;
+    }
+    return false;
+}
+
+bool TagStore::store(const uint8_t* uid, uint8_t plantId) {
+    finishPending();
+
+    uint8_t slot;
+    if (!findSlot(uid, &slot)) return false;
+    writeRecord(slot, uid, plantId);
+    return true;
+}
+
+bool TagStore::storeInBackground(const uint8_t* uid, uint8_t plantId) {
+    if (busy()) return false;
+
+    uint8_t slot;
+    if (!findSlot(uid, &slot)) return false;
+    makeRecord(uid, plantId, &pending);
+    pendingSlot = slot;
+    pendingWritten = 0;
+    return true;
+}
+
+bool TagStore::busy() {
+    return pendingWritten < TAG_STORE_RECORD_SIZE || !eeprom_is_ready();
+}
+
+void TagStore::service() {
+    if (pendingWritten >= TAG_STORE_RECORD_SIZE || !eeprom_is_ready()) return;
+
+    // Reading and comparing first wears only the bytes that change, like
+    // update(); the comparison does not wait for anything
+    int address = slotAddress(pendingSlot) + pendingWritten;
+    uint8_t value = ((const uint8_t*)&pending)[pendingWritten];
+    if (EEPROM.read(address) != value) {
+        EEPROM.write(address, value);
+    }
+    pendingWritten++;
+}
+
+void TagStore::finishPending() {
+    while (pendingWritten < TAG_STORE_RECORD_SIZE) {
+        EEPROM.update(slotAddress(pendingSlot) + pendingWritten, ((const uint8_t*)&pending)[pendingWritten]);
+        pendingWritten++;
+    }
+}
+
+void TagStore::clear() {
+    finishPending();
+
+    // Records of older generations are free slots from now on. Only when
+    // the generation counter wraps could old records come back, so then
+    // the records are really erased (0xFF is left out: erased cells).
+    generation++;
+    if (generation == 0xFF) {
+        format();
+        return;
+    }
+    tagCount = 0;
+    writeHeader();
+}
+
+// The slot holding the tag, or the slot where it goes (and counts it): the
+// first torn record of the chain, or else the free slot that ends it. A
+// torn slot is only taken once the whole chain is known not to hold the tag.
+bool TagStore::findSlot(const uint8_t* uid, uint8_t* slot) {
+    Record record;
+    uint8_t candidate = homeSlot(uid);
+    bool torn = false;
+    uint8_t tornSlot = 0;
+    bool found = false;
+    for (uint8_t probe = 0; probe < TAG_STORE_SLOTS; probe++) {
+        uint8_t state = readRecord(candidate, &record);
+        if (state == SLOT_FREE) {
+            found = true;
+            break;
+        }
+        if (state == SLOT_USED && memcmp(record.uid, uid, 4) == 0) {
+            *slot = candidate;
+            return true;
+        }
+        if (state == SLOT_TORN && !torn) {
+            torn = true;
+            tornSlot = candidate;
+        }
+        if (++candidate == TAG_STORE_SLOTS) candidate = 0;
+    }
+    if (!found && !torn) return false;
+
+    if (tagCount >= TAG_STORE_MAX_TAGS) return false;
+    tagCount++;
+    *slot = torn ? tornSlot : candidate;
+    return true;
+}
+
+uint8_t TagStore::homeSlot(const uint8_t* uid) {
+    uint32_t key = uid[0] | ((uint32_t)uid[1] << 8) | ((uint32_t)uid[2] << 16) | ((uint32_t)uid[3] << 24);
+    key *= 2654435761UL;    // Knuth's multiplicative hash; the high bits are the mixed ones
+    return ((key >> 16) + (uint32_t)generation * GENERATION_STRIDE) % TAG_STORE_SLOTS;
+}
+
+uint8_t TagStore::readRecord(uint8_t slot, Record* record) {
+    static_assert(sizeof(Record) == TAG_STORE_RECORD_SIZE, "Record must match the EEPROM layout");
+    uint8_t* bytes = (uint8_t*)record;
+    int address = slotAddress(slot);
+    for (uint8_t i = 0; i < TAG_STORE_RECORD_SIZE; i++) {
+        bytes[i] = EEPROM.read(address + i);
+    }
+    if (record->generation != generation) return SLOT_FREE;
+    return record->crc == crc8(bytes, TAG_STORE_RECORD_SIZE - 1) ? SLOT_USED : SLOT_TORN;
+}
+
+void TagStore::makeRecord(const uint8_t* uid, uint8_t plantId, Record* record) {
+    memcpy(record->uid, uid, 4);
+    record->plantId = plantId;
+    record->generation = generation;
+    record->crc = crc8((const uint8_t*)record, TAG_STORE_RECORD_SIZE - 1);
+}
+
+void TagStore::writeRecord(uint8_t slot, const uint8_t* uid, uint8_t plantId) {
+    Record record;
+    makeRecord(uid, plantId, &record);
+
+    // update() skips the bytes that already hold the value
+    const uint8_t* bytes = (const uint8_t*)&record;
+    int address = slotAddress(slot);
+    for (uint8_t i = 0; i < TAG_STORE_RECORD_SIZE; i++) {
+        EEPROM.update(address + i, bytes[i]);
+    }
+}
+
+void TagStore::writeHeader() {
+    uint8_t header[TAG_STORE_HEADER_SIZE] = {
+        HEADER_MAGIC_0, HEADER_MAGIC_1, TAG_STORE_VERSION, TAG_STORE_SLOTS, generation, 0
+    };
+    header[5] = crc8(header, 5);
+    for (uint8_t i = 0; i < TAG_STORE_HEADER_SIZE; i++) {
+        EEPROM.update(i, header[i]);
+    }
+}
+
+void TagStore::format() {
+    generation = 0;
+    tagCount = 0;
+    for (int address = slotAddress(0); address < slotAddress(TAG_STORE_SLOTS); address++) {
+        EEPROM.update(address, 0xFF);
+    }
+    writeHeader();
+}
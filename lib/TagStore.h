@@ -0,0 +1,102 @@
+#ifndef TAG_STORE_H
+#define TAG_STORE_H
+
+#include <Arduino.h>
+
+// EEPROM given to the tag store (all of it on the Uno)
+#ifndef TAG_STORE_BYTES
+#define TAG_STORE_BYTES 1024
+#endif
+
+// Bump when the layout below changes; a store of another version is
+// formatted at boot
+#define TAG_STORE_VERSION 1
+
+// Header: 'T' 'G' | version | slots | generation | CRC-8 of the first five
+#define TAG_STORE_HEADER_SIZE 6
+// Record: UID (4) | plant | generation | CRC-8 of the first six
+#define TAG_STORE_RECORD_SIZE 7
+#define TAG_STORE_SLOTS ((TAG_STORE_BYTES - TAG_STORE_HEADER_SIZE) / TAG_STORE_RECORD_SIZE)
+// Kept below the slot count so probe chains stay short
+#define TAG_STORE_MAX_TAGS 128
+
+static_assert(TAG_STORE_SLOTS <= 255, "slot numbers must fit a uint8_t");
+static_assert(TAG_STORE_MAX_TAGS < TAG_STORE_SLOTS, "the store needs free slots to end its probe chains");
+
+// Tag registrations in EEPROM, kept across resets. The records form an
+// open-addressing hash table keyed by the 32-bit UID, looked up in place
+// (an EEPROM read is as quick as a RAM read on AVR, and the Uno has no
+// SRAM for hundreds of tags).
+//
+// Wear: a registration writes only its own record, and only the bytes
+// that change. Nothing - no counter, no table-wide CRC - is rewritten on
+// every registration. Clearing the store only starts a new generation in
+// the header; older records count as free, and the hash of the new
+// generation starts at other slots, so each provisioning round wears
+// different cells.
+class TagStore {
+public:
+    // Check the header and count the records; formats a missing, damaged
+    // or outdated store
+    static void begin();
+
+    // The plant registered for a tag; false if the tag is not in the store
+    static bool lookup(const uint8_t* uid, uint8_t* plantId);
+
+    // Register or re-register a tag; false if the store is full. Waits
+    // for the EEPROM (3.4 ms per byte written).
+    static bool store(const uint8_t* uid, uint8_t plantId);
+
+    // The same without waiting: the record is written one byte per
+    // service() call, whenever the EEPROM is ready. False if the store is
+    // full or still busy with the last one.
+    static bool storeInBackground(const uint8_t* uid, uint8_t plantId);
+
+    // Is a background write still running?
+    static bool busy();
+
+    // Write the next byte of a background write, if the EEPROM is ready
+    static void service();
+
+    // Forget all registrations
+    static void clear();
+
+    static uint8_t count() { return tagCount; }
+    static uint8_t capacity() { return TAG_STORE_MAX_TAGS; }
+
+private:
+    // What a slot holds. A record of the current generation whose CRC
+    // fails was torn by a reset mid-write: it is skipped like a used slot,
+    // so the tags stored after it in the chain stay reachable.
+    enum SlotState {
+        SLOT_FREE,      // erased, or of an older generation: ends a chain
+        SLOT_TORN,
+        SLOT_USED
+    };
+
+    struct Record {
+        uint8_t uid[4];
+        uint8_t plantId;
+        uint8_t generation;
+        uint8_t crc;
+    };
+
+    static uint8_t generation;
+    static uint8_t tagCount;
+
+    // The background write: a record and how much of it is written
+    static Record pending;
+    static uint8_t pendingSlot;
+    static uint8_t pendingWritten;
+
+    static uint8_t homeSlot(const uint8_t* uid);
+    static bool findSlot(const uint8_t* uid, uint8_t* slot);
+    static uint8_t readRecord(uint8_t slot, Record* record);
+    static void makeRecord(const uint8_t* uid, uint8_t plantId, Record* record);
+    static void writeRecord(uint8_t slot, const uint8_t* uid, uint8_t plantId);
+    static void finishPending();
+    static void writeHeader();
+    static void format();
+};
+
+#endif // TAG_STORE_H
@@ -0,0 +1,87 @@
+#include "Telemetry.h"
+#include "BoardConfig.h"
+#include "Log.h"
+
+bool Telemetry::enabled = false;
+unsigned long Telemetry::dropped = 0;
+
+static void putU16(uint8_t* p, uint16_t value) {
+    p[0] = value & 0xFF;
+    p[1] = value >> 8;
+}
+
+// Counters that outgrow 16 bits stop at 65535 instead of wrapping
+static void putU16Saturated(uint8_t* p, unsigned long value) {
+    putU16(p, value > 0xFFFF ? 0xFFFF : value);
+}
+
+static void putU32(uint8_t* p, uint32_t value) {
+    putU16(p, value & 0xFFFF);
+    putU16(p + 2, value >> 16);
+}
+
+void Telemetry::setEnabled(bool enable) {
+    enabled = enable;
+    if (enabled) {
+        // Tells the decoder what it is talking to
+        uint8_t payload[2] = {TELEMETRY_VERSION, NUM_READERS};
+        send(TELEMETRY_HELLO, payload, sizeof(payload));
+    }
+}
+
+void Telemetry::tagPlaced(uint8_t readerIndex, const uint8_t* uid, uint8_t plantId) {
+    if (!enabled) return;
+    uint8_t payload[6] = {(uint8_t)(readerIndex + 1), uid[0], uid[1], uid[2], uid[3], plantId};
+    send(TELEMETRY_TAG_PLACED, payload, sizeof(payload));
+}
+
+void Telemetry::tagRemoved(uint8_t readerIndex) {
+    if (!enabled) return;
+    uint8_t payload[1] = {(uint8_t)(readerIndex + 1)};
+    send(TELEMETRY_TAG_REMOVED, payload, sizeof(payload));
+}
+
+void Telemetry::verdict(uint8_t readerIndex, uint8_t verdict, uint8_t gameMode) {
+    if (!enabled) return;
+    uint8_t payload[3] = {(uint8_t)(readerIndex + 1), verdict, gameMode};
+    send(TELEMETRY_VERDICT, payload, sizeof(payload));
+}
+
+void Telemetry::loopStats(uint16_t updatesPerSecond, uint32_t maxUpdateMicros, uint16_t showsPerSecond) {
+    if (!enabled) return;
+    uint8_t payload[8];
+    putU16(&payload[0], updatesPerSecond);
+    putU32(&payload[2], maxUpdateMicros);
+    putU16(&payload[6], showsPerSecond);
+    send(TELEMETRY_LOOP_STATS, payload, sizeof(payload));
+}
+
+void Telemetry::errors(unsigned long readerReinits, unsigned long logDropped) {
+    if (!enabled) return;
+    uint8_t payload[6];
+    putU16Saturated(&payload[0], readerReinits);
+    putU16Saturated(&payload[2], logDropped);
+    putU16Saturated(&payload[4], dropped);
+    send(TELEMETRY_ERRORS, payload, sizeof(payload));
+}
+
+void Telemetry::send(uint8_t type, const uint8_t* payload, uint8_t length) {
+    uint8_t frame[TELEMETRY_MAX_PAYLOAD + TELEMETRY_FRAME_OVERHEAD];
+    uint16_t crc = 0xFFFF;
+
+    frame[0] = TELEMETRY_SYNC;
+    frame[1] = length;
+    frame[2] = type;
+    crc = telemetryCrc(crc, length);
+    crc = telemetryCrc(crc, type);
+    for (uint8_t i = 0; i < length; i++) {
+        frame[3 + i] = payload[i];
+        crc = telemetryCrc(crc, payload[i]);
+    }
+    frame[3 + length] = crc & 0xFF;
+    frame[4 + length] = crc >> 8;
+
+    if (!Log.write(frame, length + TELEMETRY_FRAME_OVERHEAD)) {
+        dropped++;
+    }
+}
@@ -0,0 +1,32 @@
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+#include <Arduino.h>
+#include "TelemetryProtocol.h"
+
+// Board events as binary frames (TelemetryProtocol.h) on the serial port.
+// Off until enabled; the frames go out through the log buffer, between the
+// log lines, so sending never waits for the port. A frame that does not
+// fit is dropped and counted.
+class Telemetry {
+public:
+    static void setEnabled(bool enable);
+    static bool isEnabled() { return enabled; }
+
+    static void tagPlaced(uint8_t readerIndex, const uint8_t* uid, uint8_t plantId);
+    static void tagRemoved(uint8_t readerIndex);
+    static void verdict(uint8_t readerIndex, uint8_t verdict, uint8_t gameMode);
+    static void loopStats(uint16_t updatesPerSecond, uint32_t maxUpdateMicros, uint16_t showsPerSecond);
+    static void errors(unsigned long readerReinits, unsigned long logDropped);
+
+    // Frames dropped since startup
+    static unsigned long getDropped() { return dropped; }
+
+private:
+    static bool enabled;
+    static unsigned long dropped;
+
+    static void send(uint8_t type, const uint8_t* payload, uint8_t length);
+};
+
+#endif // TELEMETRY_H
@@ -0,0 +1,120 @@
+#ifndef TELEMETRY_PROTOCOL_H
+#define TELEMETRY_PROTOCOL_H
+
+#include <stdint.h>
+
+// Binary telemetry frames, shared by the board and the host decoder:
+//
+//   0xA5 | length | type | payload (length bytes) | CRC low | CRC high
+//
+// The CRC is CRC-16/CCITT (polynomial 0x1021, start 0xFFFF) over length,
+// type and payload. Values wider than a byte are little-endian, readers
+// are numbered from 1. Log text may be sent between frames; it is plain
+// ASCII, so it never contains the sync byte.
+
+#define TELEMETRY_SYNC 0xA5
+#define TELEMETRY_VERSION 1
+#define TELEMETRY_MAX_PAYLOAD 16
+#define TELEMETRY_FRAME_OVERHEAD 5
+
+enum TelemetryType {
+    TELEMETRY_HELLO = 0,        // version, number of readers
+    TELEMETRY_TAG_PLACED,       // reader, UID (4), plant
+    TELEMETRY_TAG_REMOVED,      // reader
+    TELEMETRY_VERDICT,          // reader, verdict, game mode
+    TELEMETRY_LOOP_STATS,       // updates/s (2), longest update in us (4), LED chain shows/s (2)
+    TELEMETRY_ERRORS,           // reader reinits (2), log lines dropped (2), frames dropped (2); each stops at 65535
+    NUM_TELEMETRY_TYPES
+};
+
+inline uint16_t telemetryCrc(uint16_t crc, uint8_t data) {
+    crc ^= (uint16_t)data << 8;
+    for (uint8_t i = 0; i < 8; i++) {
+        crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : crc << 1;
+    }
+    return crc;
+}
+
+inline uint16_t telemetryU16(const uint8_t* p) {
+    return p[0] | ((uint16_t)p[1] << 8);
+}
+
+inline uint32_t telemetryU32(const uint8_t* p) {
+    return telemetryU16(p) | ((uint32_t)telemetryU16(p + 2) << 16);
+}
+
+// Picks frames out of a byte stream; bytes outside of frames are text
+class TelemetryDecoder {
+public:
+    enum Result {
+        NEED_MORE = 0,
+        FRAME,          // type, length and payload hold a frame
+        TEXT,           // the byte was text between frames
+        BAD_FRAME       // CRC or length did not match, frame skipped
+    };
+
+    uint8_t type;
+    uint8_t length;
+    uint8_t payload[TELEMETRY_MAX_PAYLOAD];
+    unsigned long frames;
+    unsigned long badFrames;
+
+    TelemetryDecoder() : type(0), length(0), frames(0), badFrames(0), state(WAIT_SYNC), received(0), crc(0) {}
+
+    Result feed(uint8_t byte) {
+        switch (state) {
+            case WAIT_SYNC:
+                if (byte != TELEMETRY_SYNC) return TEXT;
+                state = LENGTH;
+                crc = 0xFFFF;
+                return NEED_MORE;
+
+            case LENGTH:
+                if (byte > TELEMETRY_MAX_PAYLOAD) {
+                    state = WAIT_SYNC;
+                    badFrames++;
+                    return BAD_FRAME;
+                }
+                length = byte;
+                crc = telemetryCrc(crc, byte);
+                state = TYPE;
+                return NEED_MORE;
+
+            case TYPE:
+                type = byte;
+                crc = telemetryCrc(crc, byte);
+                received = 0;
+                state = length ? PAYLOAD : CRC_LOW;
+                return NEED_MORE;
+
+            case PAYLOAD:
+                payload[received++] = byte;
+                crc = telemetryCrc(crc, byte);
+                if (received == length) state = CRC_LOW;
+                return NEED_MORE;
+
+            case CRC_LOW:
+                if (byte != (crc & 0xFF)) break;
+                state = CRC_HIGH;
+                return NEED_MORE;
+
+            case CRC_HIGH:
+                if (byte != (crc >> 8)) break;
+                state = WAIT_SYNC;
+                frames++;
+                return FRAME;
+        }
+
+        state = WAIT_SYNC;
+        badFrames++;
+        return BAD_FRAME;
+    }
+
+private:
+    enum State { WAIT_SYNC, LENGTH, TYPE, PAYLOAD, CRC_LOW, CRC_HIGH };
+    State state;
+    uint8_t received;
+    uint16_t crc;
+};
+
+#endif // TELEMETRY_PROTOCOL_H
@@ -1,38 +1,52 @@
 #include "PlantDatabase.h"
-
-// Initialize the plant database with plant information
-Plant PlantDatabase::plants[NUM_PLANTS] = {
+#include "IndexList.h"
+#include "TagStore.h"
+
+// Plant names, kept in flash
+static const char nameUnknown[] PROGMEM = "Unknown";
+static const char nameCarrot[] PROGMEM = "Carrot";
+static const char nameTomato[] PROGMEM = "Tomato";
+static const char nameOnion[] PROGMEM = "Onion";
+static const char namePotato[] PROGMEM = "Potato";
+static const char nameEggplant[] PROGMEM = "Eggplant";
+static const char nameLettuce[] PROGMEM = "Lettuce";
+static const char namePea[] PROGMEM = "Pea";
+static const char nameCucumber[] PROGMEM = "Cucumber";
+
+// The plant catalogue, kept in flash; read it through getPlantInfo()
+static const Plant plants[NUM_PLANTS] PROGMEM = {
     // UNKNOWN
-    {"Unknown", NONE, NONE, {0, 0, 255}},  // Blue for unknown
+    {nameUnknown, NONE, NONE, {0, 0, 255}},  // Blue for unknown
     
     // CARROT
-    {"Carrot", PARTIALLY_SHADED | MOIST, PARTIALLY_SHADED | MOIST, {255, 120, 0}},  // Orange
+    {nameCarrot, PARTIALLY_SHADED | MOIST, PARTIALLY_SHADED | MOIST, {255, 120, 0}},  // Orange
 
     // TOMATO
-    {"Tomato", PARTIALLY_SHADED | WET, PARTIALLY_SHADED | WET, {255, 50, 0}},  // Red-orange
+    {nameTomato, PARTIALLY_SHADED | WET, PARTIALLY_SHADED | WET, {255, 50, 0}},  // Red-orange
     
     // ONION
-    {"Onion", PARTIALLY_SHADED | DRY, PARTIALLY_SHADED | DRY, {255, 255, 0}},  // Yellow
+    {nameOnion, PARTIALLY_SHADED | DRY, PARTIALLY_SHADED | DRY, {255, 255, 0}},  // Yellow
     
     // POTATO
-    {"Potato", PARTIALLY_SHADED | DRY, PARTIALLY_SHADED | DRY, {150, 75, 0}},  // Brown
+    {namePotato, PARTIALLY_SHADED | DRY, PARTIALLY_SHADED | DRY, {150, 75, 0}},  // Brown
     
     // BASIL
-    {"Eggplant", PARTIALLY_SHADED | MOIST, PARTIALLY_SHADED | MOIST, {0, 200, 0}},  // Green
+    {nameEggplant, PARTIALLY_SHADED | MOIST, PARTIALLY_SHADED | MOIST, {0, 200, 0}},  // Green
     
     // LETTUCE
-    {"Lettuce", PARTIALLY_SHADED | WET, PARTIALLY_SHADED | WET, {0, 255, 0}},  // Light green
+    {nameLettuce, PARTIALLY_SHADED | WET, PARTIALLY_SHADED | WET, {0, 255, 0}},  // Light green
 
     // Pea
-    {"Pea", PARTIALLY_SHADED | MOIST, PARTIALLY_SHADED | MOIST, {0, 255, 100}},  // Green-blue
+    {namePea, PARTIALLY_SHADED | MOIST, PARTIALLY_SHADED | MOIST, {0, 255, 100}},  // Green-blue
 
     // CUCUMBER
-    {"Cucumber", PARTIALLY_SHADED | WET, PARTIALLY_SHADED | WET, {0, 255, 50}}  // Green-blue
+    {nameCucumber, PARTIALLY_SHADED | WET, PARTIALLY_SHADED | WET, {0, 255, 50}}  // Green-blue
 
 };
 
-// Plant relationship matrix (-1: hates, 0: neutral, 1: likes)
-int8_t PlantDatabase::plantRelationships[NUM_PLANTS][NUM_PLANTS] = {
+// Plant relationship matrix (-1: hates, 0: neutral, 1: likes).
+// Only used at compile time to build the likes/hates sets below.
+constexpr int8_t plantRelationships[NUM_PLANTS][NUM_PLANTS] = {
     // 0 - Unknown plant has neutral relationship with everything
     {0, 0, 0, 0, 0, 0, 0, 0, 0},
     
@@ -61,8 +75,45 @@ int8_t PlantDatabase::plantRelationships[NUM_PLANTS][NUM_PLANTS] = {
     {0, 1, -1, -1, -1, -1, 1, 1, 0}
 };
 
-// Start with some pre-registered RFID tags - up to 20 tags
-TagInfo PlantDatabase::registeredTags[20] = {
+// The relationship matrix as one "likes" and one "hates" set per plant
+struct PlantRelations {
+    PlantSet likes;
+    PlantSet hates;
+};
+
+struct RelationTable {
+    PlantRelations plants[NUM_PLANTS];
+};
+
+// Word 'word' of the set of plants that 'plant' has 'relationship' with,
+// from bit 'bit' upwards
+constexpr PlantSetWord relationWord(uint16_t plant, int8_t relationship, uint16_t word, uint8_t bit = 0) {
+    return bit >= PlantSet::WORD_BITS || word * PlantSet::WORD_BITS + bit >= NUM_PLANTS ? 0 :
+           (PlantSetWord)((plantRelationships[plant][word * PlantSet::WORD_BITS + bit] == relationship ?
+                           (PlantSetWord)1 << bit : 0) |
+                          relationWord(plant, relationship, word, bit + 1));
+}
+
+template <uint16_t... W>
+constexpr PlantSet relationSet(uint16_t plant, int8_t relationship, IndexList<W...>) {
+    return PlantSet{{relationWord(plant, relationship, W)...}};
+}
+
+constexpr PlantRelations relationsOf(uint16_t plant) {
+    return PlantRelations{relationSet(plant, LIKES, MakeIndexList<PlantSet::WORDS>::type()),
+                          relationSet(plant, HATES, MakeIndexList<PlantSet::WORDS>::type())};
+}
+
+template <uint16_t... P>
+constexpr RelationTable makeRelationTable(IndexList<P...>) {
+    return RelationTable{{relationsOf(P)...}};
+}
+
+// Built by the compiler, kept in flash
+static constexpr RelationTable relations PROGMEM = makeRelationTable(MakeIndexList<NUM_PLANTS>::type());
+
+// Pre-registered RFID tags, kept in flash
+static const TagInfo builtinTags[] PROGMEM = {
     // Format: {{tag UID bytes}, associated plant}
     {{0x04, 0x53, 0x45, 0x3B}, TOMATO},
     {{0x04, 0x5B, 0x2B, 0x3B}, CUCUMBER},
@@ -73,39 +124,68 @@ TagInfo PlantDatabase::registeredTags[20] = {
     {{0x04, 0x13, 0x16, 0x3B}, PEA},
 };
 
-uint8_t PlantDatabase::tagCount = 7;  // Number of pre-registered tags
+#define NUM_BUILTIN_TAGS (sizeof(builtinTags) / sizeof(builtinTags[0]))
 
 void PlantDatabase::initialize() {
-    // Any additional initialization can go here
+    // The catalogue and the relationship sets are built at compile time;
+    // the tags registered at runtime are loaded from EEPROM
+    TagStore::begin();
 }
 
 PlantID PlantDatabase::identifyPlantByTag(byte* tagUid) {
-    for (uint8_t i = 0; i < tagCount; i++) {
-        if (compareUID(tagUid, registeredTags[i].uid)) {
-            return registeredTags[i].plantId;
+    // Registered tags first, so they can override the built-in ones
+    uint8_t plantId;
+    if (TagStore::lookup(tagUid, &plantId)) {
+        return (PlantID)plantId;
+    }
+    for (uint8_t i = 0; i < NUM_BUILTIN_TAGS; i++) {
+        if (memcmp_P(tagUid, builtinTags[i].uid, 4) == 0) {
+            return (PlantID)pgm_read_byte(&builtinTags[i].plantId);
         }
     }
     return UNKNOWN;
 }
 
-const Plant* PlantDatabase::getPlantInfo(PlantID plantId) {
-    if (plantId < NUM_PLANTS) {
-        return &plants[plantId];
+void PlantDatabase::getPlantInfo(PlantID plantId, Plant* plant) {
+    if (plantId >= NUM_PLANTS) {
+        plantId = UNKNOWN;  // Return unknown plant as fallback
+    }
+    memcpy_P(plant, &plants[plantId], sizeof(Plant));
+}
+
+const __FlashStringHelper* PlantDatabase::getPlantName(PlantID plantId) {
+    if (plantId >= NUM_PLANTS) {
+        plantId = UNKNOWN;
     }
-    return &plants[UNKNOWN];  // Return unknown plant as fallback
+    return (const __FlashStringHelper*)pgm_read_ptr(&plants[plantId].name);
 }
 
 PlantRelationship PlantDatabase::getRelationship(PlantID plant1, PlantID plant2) {
     if (plant1 < NUM_PLANTS && plant2 < NUM_PLANTS) {
-        return static_cast<PlantRelationship>(plantRelationships[plant1][plant2]);
+        PlantRelations sets;
+        memcpy_P(&sets, &relations.plants[plant1], sizeof(sets));
+        if (sets.hates.test(plant2)) return HATES;
+        if (sets.likes.test(plant2)) return LIKES;
     }
     return NEUTRAL;  // Default to neutral if invalid plants
 }
 
+PlantRelationship PlantDatabase::getNeighborhoodRelationship(PlantID plantId, const PlantSet& neighbors) {
+    if (plantId < NUM_PLANTS) {
+        // One plant it hates outweighs any number it likes
+        PlantRelations sets;
+        memcpy_P(&sets, &relations.plants[plantId], sizeof(sets));
+        if (sets.hates.intersects(neighbors)) return HATES;
+        if (sets.likes.intersects(neighbors)) return LIKES;
+    }
+    return NEUTRAL;
+}
+
 bool PlantDatabase::plantThrives(PlantID plantId, uint8_t environment) {
     if (plantId < NUM_PLANTS) {
         // All preferred conditions must be met
-        return (plants[plantId].preferredEnvironment & environment) == plants[plantId].preferredEnvironment;
+        uint8_t preferred = pgm_read_byte(&plants[plantId].preferredEnvironment);
+        return (preferred & environment) == preferred;
     }
     return false;
 }
@@ -113,39 +193,21 @@ bool PlantDatabase::plantThrives(PlantID plantId, uint8_t environment) {
 bool PlantDatabase::plantTolerates(PlantID plantId, uint8_t environment) {
     if (plantId < NUM_PLANTS) {
         // At least some tolerated conditions must be met
-        return (plants[plantId].toleratedEnvironment & environment) != 0;
+        return (pgm_read_byte(&plants[plantId].toleratedEnvironment) & environment) != 0;
     }
     return false;
 }
 
 bool PlantDatabase::registerTag(byte* tagUid, PlantID plantId) {
-    // Check if we have space for a new tag
-    if (tagCount >= sizeof(registeredTags) / sizeof(registeredTags[0])) {
-        return false;  // No more space
+    if (plantId >= NUM_PLANTS) {
+        return false;
     }
-    
-    // Check if tag is already registered
-    for (uint8_t i = 0; i < tagCount; i++) {
-        if (compareUID(tagUid, registeredTags[i].uid)) {
-            // Update existing tag
-            registeredTags[i].plantId = plantId;
-            return true;
-        }
-    }
-    
-    // Add new tag
-    memcpy(registeredTags[tagCount].uid, tagUid, 4);
-    registeredTags[tagCount].plantId = plantId;
-    tagCount++;
-    
-    return true;
+    return TagStore::store(tagUid, plantId);
 }
 
-bool PlantDatabase::compareUID(byte* uid1, byte* uid2) {
-    for (byte i = 0; i < 4; i++) {
-        if (uid1[i] != uid2[i]) {
-            return false;
-        }
+bool PlantDatabase::registerTagInBackground(byte* tagUid, PlantID plantId) {
+    if (plantId >= NUM_PLANTS) {
+        return false;
     }
-    return true;
-}
\ No newline at end of file
+    return TagStore::storeInBackground(tagUid, plantId);
+}
@@ -0,0 +1,145 @@
+"""
+SRAM/flash footprint per module, read from the linker map.
+
+As a PlatformIO extra script it makes the linker write a map file and adds
+the "memreport" target:
+
+    pio run -e uno -t memreport
+
+It can also be run on any GNU ld map file:
+
+    python scripts/memory_report.py .pio/build/uno/firmware.map
+
+Flash is code and constants (.text, .progmem, .rodata) plus the initial
+values of .data; SRAM is .data and .bss. Sections the linker dropped with
+--gc-sections are not counted.
+"""
+
+import os
+import re
+import sys
+
+# Uno (ATmega328P) sizes; the bootloader takes 512 bytes of flash
+FLASH_SIZE = 32256
+SRAM_SIZE = 2048
+
+FLASH_SECTIONS = (".text", ".rodata", ".init", ".fini", ".vectors", ".progmem")
+DATA_SECTIONS = (".data",)
+BSS_SECTIONS = (".bss", ".noinit")
+
+OUTPUT_SECTION = re.compile(r"^(\.[\w.]+)\s*(0x[0-9a-fA-F]+\s+0x[0-9a-fA-F]+.*)?$")
+INPUT_SECTION = re.compile(r"^ (\.[^\s]+|COMMON)\s*$|^ (\.[^\s]+|COMMON)\s+0x[0-9a-fA-F]+\s+0x[0-9a-fA-F]+\s+\S")
+ALLOCATION = re.compile(r"^\s+0x([0-9a-fA-F]+)\s+0x([0-9a-fA-F]+)\s+(\S.*)$")
+
+
+def kind_of(output_section):
+    if output_section.startswith(FLASH_SECTIONS):
+        return "flash"
+    if output_section.startswith(DATA_SECTIONS):
+        return "data"
+    if output_section.startswith(BSS_SECTIONS):
+        return "bss"
+    return None
+
+
+def module_name(path):
+    # "dir/libFoo.a(bar.cpp.o)" -> "Foo/bar.cpp", "dir/src/main.cpp.o" -> "main.cpp"
+    match = re.match(r"(.*)\((.*)\)$", path)
+    if match:
+        archive = os.path.basename(match.group(1))
+        archive = re.sub(r"^lib|\.a$", "", archive)
+        return archive + "/" + re.sub(r"\.o$", "", match.group(2))
+    return re.sub(r"\.o$", "", os.path.basename(path))
+
+
+def parse_map(lines):
+    modules = {}
+    output = None
+    pending = None
+    in_map = False
+
+    for line in lines:
+        line = line.rstrip("\n")
+        if not in_map:
+            in_map = line.startswith("Linker script and memory map")
+            continue
+
+        match = OUTPUT_SECTION.match(line)
+        if match and not line.startswith(" "):
+            output = kind_of(match.group(1))
+            pending = None
+            continue
+        if output is None:
+            continue
+
+        # An input section's address, size and object are on its own line,
+        # or on the next one when the section name is long
+        text = line
+        if INPUT_SECTION.match(line):
+            parts = line.split(None, 1)
+            if len(parts) == 1:
+                pending = parts[0]
+                continue
+            text = " " * 16 + parts[1]
+        elif pending is None:
+            continue
+        pending = None
+
+        match = ALLOCATION.match(text)
+        if not match:
+            continue
+        size = int(match.group(2), 16)
+        obj = match.group(3).strip()
+        if size == 0 or obj.startswith("0x") or " " in obj:
+            continue
+
+        entry = modules.setdefault(module_name(obj), {"flash": 0, "data": 0, "bss": 0})
+        entry[output] += size
+    return modules
+
+
+def print_report(modules, out=sys.stdout):
+    rows = sorted(modules.items(), key=lambda item: (-(item[1]["data"] + item[1]["bss"]),
+                                                     -item[1]["flash"], item[0]))
+    width = max([len(name) for name in modules] + [len("module")])
+    out.write("%-*s %7s %7s %6s %6s\n" % (width, "module", "flash", "SRAM", "data", "bss"))
+
+    totals = {"flash": 0, "data": 0, "bss": 0}
+    for name, entry in rows:
+        flash = entry["flash"] + entry["data"]
+        sram = entry["data"] + entry["bss"]
+        out.write("%-*s %7d %7d %6d %6d\n" % (width, name, flash, sram, entry["data"], entry["bss"]))
+        for key in totals:
+            totals[key] += entry[key]
+
+    flash = totals["flash"] + totals["data"]
+    sram = totals["data"] + totals["bss"]
+    out.write("%-*s %7d %7d %6d %6d\n" % (width, "total", flash, sram, totals["data"], totals["bss"]))
+    out.write("flash %.1f%% of %d, SRAM %.1f%% of %d (%d left for heap and stack)\n" %
+              (100.0 * flash / FLASH_SIZE, FLASH_SIZE, 100.0 * sram / SRAM_SIZE, SRAM_SIZE,
+               SRAM_SIZE - sram))
+
+
+def report(map_path):
+    with open(map_path) as f:
+        print_report(parse_map(f))
+
+
+try:
+    Import("env")  # noqa: F821 - defined when PlatformIO runs this script
+except NameError:
+    env = None
+
+if env is not None:
+    map_path = os.path.join("$BUILD_DIR", "${PROGNAME}.map")
+    env.Append(LINKFLAGS=["-Wl,-Map," + map_path])
+    env.AddCustomTarget(
+        name="memreport",
+        dependencies="$BUILD_DIR/${PROGNAME}.elf",
+        actions=lambda target, source, env: report(env.subst(map_path)),
+        title="Memory report",
+        description="SRAM/flash footprint per module")
+elif __name__ == "__main__":
+    if len(sys.argv) != 2:
+        sys.exit("usage: memory_report.py <linker map file>")
+    report(sys.argv[1])
@@ -2,10 +2,16 @@
 #include "BoardConfig.h"
 #include "BoardController.h"
 #include "PlantDatabase.h"
+#include "MemoryProbe.h"
+#include "CommandLine.h"
+#include "TagStore.h"
 
 // Create global board controller instance
 BoardController garden;
 
+// Serial command reader, the command table is at the end of this file
+extern CommandLine commands;
+
 // Button pin for changing game mode
 #define MODE_BUTTON_PIN 2  // Use digital pin 2 for the button
 
@@ -14,12 +20,11 @@ unsigned long lastDebounceTime = 0;
 unsigned long debounceDelay = 300;  // Longer debounce delay for human pressing
 
 // Forward declaration of helper function
-void processSerialCommand();
 void runDiagnosticTest();
 void checkModeButton();
 
 void setup() {
-    Serial.begin(9600);
+    Serial.begin(SERIAL_BAUD);
     while (!Serial && millis() < 3000); // Wait for serial but timeout after 3 seconds
     
     Serial.println(F("Interactive Garden - Test Mode"));
@@ -34,13 +39,7 @@ void setup() {
     // Optimize RFID readers for NXP Ultra NFC tags to improve reading distance
     garden.optimizeRFIDReaders();
     
-    // Place readers as neighbors (adjacent positions) to properly test plant relationships
-    garden.placeReader(1, 2, 0, PARTIALLY_SHADED | DRY);         // Reader 1: Sunny and Dry (Potato tolerates it, Tomato dislikes)
-    garden.placeReader(2, 4, 0, PARTIALLY_SHADED | DRY);       // Reader 2: Sunny and Moist (Tomato thrives, Potato tolerates)
-    garden.placeReader(3, 5, 1, PARTIALLY_SHADED | MOIST);         // Reader 3: Sunny and Wet (Neither prefers this)
-    garden.placeReader(4, 3, 1, PARTIALLY_SHADED | MOIST);
-    garden.placeReader(5, 1, 1, PARTIALLY_SHADED | MOIST);
-    garden.placeReader(6, 2, 2, PARTIALLY_SHADED | WET);
+    // The reader positions are compiled in from BOARD_LAYOUT (BoardLayout.h)
 
     // Quick startup test of all LEDs
     for (int i = 1; i <= 3; i++) {
@@ -60,10 +59,8 @@ void loop() {
     // Update the garden board (checks readers, handles LED effects)
     garden.update();
     
-    // Process any serial commands (for testing/diagnostics)
-    if (Serial.available()) {
-        processSerialCommand();
-    }
+    // Process serial commands (for testing/diagnostics) as they come in
+    commands.poll();
     
     // Small delay to prevent CPU hogging
     delay(10);
@@ -105,28 +102,32 @@ void runDiagnosticTest() {
         
         // Test colors: Red, Green, Blue, then off
         garden.setRingColor(i, 255, 0, 0);  // Red
+        garden.flushLeds();
         delay(500);
         garden.setRingColor(i, 0, 255, 0);  // Green
+        garden.flushLeds();
         delay(500);
         garden.setRingColor(i, 0, 0, 255);  // Blue
+        garden.flushLeds();
         delay(500);
         garden.clearRing(i);
+        garden.flushLeds();
     }
     
     // 3. Report environment at each position
     Serial.println(F("\nEnvironment at each reader position:"));
     for (int i = 1; i <= 3; i++) {
         int readerIndex = i - 1;
-        GridPosition* pos = garden.getReaderPosition(readerIndex);
-        if (pos != nullptr) {
+        GridPosition pos;
+        if (garden.getReaderPosition(readerIndex, &pos)) {
             Serial.print(F("Reader "));
             Serial.print(i);
             Serial.print(F(" at ("));
-            Serial.print(pos->row);
+            Serial.print(pos.row);
             Serial.print(F(","));
-            Serial.print(pos->col);
+            Serial.print(pos.col);
             Serial.print(F("): Attributes = "));
-            Serial.println(pos->attributes, BIN);
+            Serial.println(pos.attributes, BIN);
         }
     }
     
@@ -150,56 +151,177 @@ void runDiagnosticTest() {
     Serial.println(F(" - Press the button to cycle through different game modes"));
 }
 
-void processSerialCommand() {
-    String command = Serial.readStringUntil('\n');
-    command.trim();
+static void cmdTest(const CommandArgs& args) {
+    runDiagnosticTest();
+}
+
+static void cmdMode(const CommandArgs& args) {
+    // Same as pressing the button
+    garden.changeGameMode();
+}
+
+static void cmdRegister(const CommandArgs& args) {
+    // Example: "register 04E5121A 2" registers tag 04E5121A as TOMATO (2)
+    byte tagId[4];
+    unsigned int plantId;
+    if (!args.getHex(0, tagId, sizeof(tagId)) || !args.getNumber(1, NUM_PLANTS - 1, &plantId)) {
+        Serial.println(F("Invalid format. Use: register [tag_id_hex] [plant_id]"));
+        return;
+    }
     
-    if (command == "test") {
-        // Run diagnostic test
-        runDiagnosticTest();
+    if (PlantDatabase::registerTag(tagId, static_cast<PlantID>(plantId))) {
+        Serial.println(F("Tag registered successfully"));
+    } else {
+        Serial.println(F("Failed to register tag"));
     }
-    else if (command == "mode") {
-        // Change game mode via serial command
-        garden.changeGameMode();
+}
+
+static void cmdTags(const CommandArgs& args) {
+    if (args.is(0, "clear")) {
+        TagStore::clear();
+    } else if (args.count() > 0) {
+        Serial.println(F("Use: tags [clear]"));
+        return;
     }
-    else if (command.startsWith("register ")) {
-        // Format: "register [tag_id_hex] [plant_id]"
-        // Example: "register 04E5121A 1" to register tag 04E5121A as TOMATO (1)
-        
-        String params = command.substring(9); // Skip "register "
-        int spacePos = params.indexOf(' ');
-        
-        if (spacePos > 0) {
-            String tagIdStr = params.substring(0, spacePos);
-            int plantId = params.substring(spacePos + 1).toInt();
-            
-            // Convert hex string to bytes
-            byte tagId[4] = {0};
-            for (int i = 0; i < 4; i++) {
-                if (i*2+2 <= tagIdStr.length()) {
-                    String byteStr = tagIdStr.substring(i*2, i*2+2);
-                    tagId[i] = strtol(byteStr.c_str(), NULL, 16);
-                }
-            }
-            
-            if (PlantDatabase::registerTag(tagId, static_cast<PlantID>(plantId))) {
-                Serial.println(F("Tag registered successfully"));
-            } else {
-                Serial.println(F("Failed to register tag"));
-            }
-        } else {
-            Serial.println(F("Invalid format. Use: register [tag_id_hex] [plant_id]"));
+    Serial.print(F("Registered tags: "));
+    Serial.print(TagStore::count());
+    Serial.print(F(" of "));
+    Serial.println(TagStore::capacity());
+}
+
+static void cmdLearn(const CommandArgs& args) {
+    unsigned int plantId;
+    if (args.is(0, "stop")) {
+        garden.stopLearning();
+    } else if (args.count() > 0) {
+        if (!args.getNumber(0, NUM_PLANTS - 1, &plantId) || !garden.startLearning(static_cast<PlantID>(plantId))) {
+            Serial.println(F("Use: learn [plant_id|stop]"));
+            return;
         }
     }
-    else if (command == "help") {
-        Serial.println(F("Available commands:"));
-        Serial.println(F("test - Run a diagnostic test"));
-        Serial.println(F("mode - Change game mode (same as pressing the button)"));
-        Serial.println(F("register [tag_id_hex] [plant_id] - Register a new RFID tag"));
-        Serial.println(F("  Plant IDs: 1=Tomato, 2=Potato, 3=Carrot, etc."));
-        Serial.println(F("help - Display this help message"));
+    
+    if (garden.isLearning()) {
+        Serial.print(F("Learn mode: new tags become "));
+        Serial.print(PlantDatabase::getPlantName(garden.getLearningPlant()));
+        Serial.print(F(", "));
+    } else {
+        Serial.print(F("Learn mode off, "));
     }
-    else {
-        Serial.println(F("Unknown command. Type 'help' for available commands."));
+    Serial.print(garden.getCapturedCount());
+    Serial.print(F(" tags captured, "));
+    Serial.print(garden.getUnsavedCount());
+    Serial.println(F(" not saved yet"));
+}
+
+static void cmdLeds(const CommandArgs& args) {
+    // LED output counters
+    const LedStats& stats = garden.getLedStats();
+    Serial.print(F("LED chain shows: "));
+    Serial.print(stats.showsPerSecond);
+    Serial.print(F("/s, "));
+    Serial.print(stats.showMicrosPerSecond);
+    Serial.print(F(" us/s in show ("));
+    Serial.print(stats.shows);
+    Serial.print(F(" shows, "));
+    Serial.print(stats.showMicros);
+    Serial.println(F(" us total)"));
+}
+
+static void cmdReaders(const CommandArgs& args) {
+    // Set the bus budget, or show how each reader is polled
+    if (args.count() > 0) {
+        unsigned int budgetMs;
+        if (!args.getNumber(0, 1000, &budgetMs) || budgetMs == 0) {
+            Serial.println(F("Use: readers [budget_ms] (1-1000)"));
+            return;
+        }
+        garden.setBusBudget(budgetMs * 1000UL);
+    }
+    
+    for (uint8_t i = 0; i < NUM_READERS; i++) {
+        const ReaderPollStats* stats = garden.getPollStats(i);
+        Serial.print(F("Reader "));
+        Serial.print(i + 1);
+        switch (garden.getPollMode(i)) {
+            case POLL_EMPTY: Serial.print(F(": empty, ")); break;
+            case POLL_BURST: Serial.print(F(": burst, ")); break;
+            case POLL_STABLE: Serial.print(F(": stable, ")); break;
+        }
+        Serial.print(stats->polls);
+        Serial.print(F(" polls, "));
+        Serial.print(stats->uidReads);
+        Serial.print(F(" UID reads, "));
+        Serial.print(stats->detections);
+        Serial.print(F(" tags found"));
+        if (stats->detections) {
+            Serial.print(F(" after "));
+            Serial.print(stats->latencySumMs / stats->detections);
+            Serial.print(F(" ms avg, "));
+            Serial.print(stats->latencyMaxMs);
+            Serial.print(F(" ms max"));
+        }
+        Serial.println();
+    }
+    
+    const ScanStats& scan = garden.getScanStats();
+    Serial.print(F("Scans: "));
+    Serial.print(scan.scansPerSecond);
+    Serial.print(F("/s, bus "));
+    Serial.print(scan.busMicrosPerSecond);
+    Serial.print(F(" us/s of "));
+    Serial.print(garden.getBusBudget());
+    Serial.print(F(" allowed, budget ran out in "));
+    Serial.print(scan.budgetHits);
+    Serial.println(F(" s"));
+    // A scan that reads no UID: 1 for empty readers alone, 2 with a presence check
+    Serial.print(F("RF transactions per steady-state scan: "));
+    Serial.println(scan.steadyScans ? (double)scan.steadyTransactions / scan.steadyScans : 0.0);
+}
+
+static void cmdTelemetry(const CommandArgs& args) {
+    // Binary event frames between the log lines (see TelemetryProtocol.h)
+    if (args.is(0, "on")) {
+        Telemetry::setEnabled(true);
+    } else if (args.is(0, "off")) {
+        Telemetry::setEnabled(false);
+    } else {
+        Serial.println(F("Use: telemetry on|off"));
+    }
+}
+
+static void cmdMem(const CommandArgs& args) {
+    // SRAM use and how deep the stack has gone since reset
+    MemoryReport report;
+    MemoryProbe::read(&report);
+    MemoryProbe::print(report);
+}
+
+static void cmdHelp(const CommandArgs& args);
+
+// Serial commands; a new command is one more row and its handler
+static const CommandEntry commandTable[] PROGMEM = {
+    {"test", "", "Run a diagnostic test", 0, cmdTest},
+    {"mode", "", "Change game mode (same as pressing the button)", 0, cmdMode},
+    {"register", "[tag_id_hex] [plant_id]", "Register a new RFID tag", 2, cmdRegister},
+    {"tags", "[clear]", "Count or forget the registered tags", 0, cmdTags},
+    {"learn", "[plant_id|stop]", "Bind every new tag placed to a plant", 0, cmdLearn},
+    {"leds", "", "Show LED output counters", 0, cmdLeds},
+    {"readers", "[budget_ms]", "Show reader polling, set the bus budget", 0, cmdReaders},
+    {"mem", "", "Show SRAM use and the stack high-water mark", 0, cmdMem},
+    {"telemetry", "on|off", "Send board events as binary frames", 1, cmdTelemetry},
+    {"help", "", "Display this help message", 0, cmdHelp},
+};
+
+CommandLine commands(commandTable, sizeof(commandTable) / sizeof(commandTable[0]));
+
+static void cmdHelp(const CommandArgs& args) {
+    commands.printHelp();
+    Serial.print(F("  Plant IDs:"));
+    for (uint8_t id = 1; id < NUM_PLANTS; id++) {
+        Serial.print(' ');
+        Serial.print(id);
+        Serial.print('=');
+        Serial.print(PlantDatabase::getPlantName(static_cast<PlantID>(id)));
     }
+    Serial.println();
 }
@@ -0,0 +1,113 @@
+/**
+ * Incremental Board Evaluation Simulation (host)
+ *
+ * Runs the real BoardController in neighbors mode and checks that the
+ * cached reader verdicts follow placements and removals right away:
+ * - tomato (reader 1) and onion (reader 5) like each other
+ * - potato on reader 4, next to reader 1 but not to reader 5, turns
+ *   reader 1 to "dislikes" and leaves reader 5 alone
+ * - taking the potato away turns reader 1 back to "likes"
+ * - nothing is evaluated while the board does not change
+ *
+ * The periodic evaluation this replaces re-ran every occupied reader every
+ * 2 s (EFFECT_INTERVAL) and only looked at the reader itself.
+ *
+ * Build and run with: pio run -e board_eval_sim && .pio/build/board_eval_sim/program
+ */
+
+#include <stdio.h>
+#include "Arduino.h"
+#include "BoardConfig.h"
+#include "BoardController.h"
+#include "mfrc522_sim.h"
+
+#define OLD_EFFECT_INTERVAL 2000
+#define STEADY_MS 10000
+
+static const uint8_t misoPins[NUM_READERS] = {
+    MISO_PIN1, MISO_PIN2, MISO_PIN3, MISO_PIN4, MISO_PIN5, MISO_PIN6
+};
+
+static const uint8_t tomatoUid[4] = {0x04, 0x53, 0x45, 0x3B};
+static const uint8_t potatoUid[4] = {0x04, 0xDA, 0x41, 0x3B};
+static const uint8_t onionUid[4] = {0x04, 0xCC, 0x25, 0x3B};
+
+static const char *verdictNames[] = {"none", "neutral", "likes", "dislikes"};
+
+static BoardController garden;
+static int failures = 0;
+
+static void runFor(unsigned long ms) {
+    unsigned long end = millis() + ms;
+    while (millis() < end) {
+        garden.update();
+        delay(10);
+    }
+}
+
+// Run until the reader shows the verdict; returns the time it took
+static long waitForVerdict(uint8_t readerIndex, ReaderVerdict verdict, unsigned long timeoutMs) {
+    unsigned long start = millis();
+    while (millis() - start < timeoutMs) {
+        if (garden.getReaderVerdict(readerIndex) == verdict) return millis() - start;
+        garden.update();
+        delay(10);
+    }
+    return -1;
+}
+
+static void expectVerdict(const char *when, uint8_t readerIndex, ReaderVerdict verdict, long latencyMs) {
+    if (latencyMs < 0) {
+        printf("  FAIL %s: reader %d shows '%s', expected '%s'\n", when, readerIndex + 1,
+               verdictNames[garden.getReaderVerdict(readerIndex)], verdictNames[verdict]);
+        failures++;
+    } else {
+        printf("%-24s reader %d -> %-8s after %4ld ms, %lu evaluations\n", when, readerIndex + 1,
+               verdictNames[verdict], latencyMs, garden.getEvaluationCount());
+    }
+}
+
+int main() {
+    simBank.attach(COMMON_SCK_PIN, COMMON_MOSI_PIN, COMMON_SS_PIN, COMMON_RST_PIN, misoPins, NUM_READERS);
+    Serial.setMuted(true);
+
+    garden.begin();
+    garden.changeGameMode();    // neighbors mode
+    runFor(1000);
+
+    simBank.chip(0).placeCard(tomatoUid);
+    simBank.chip(4).placeCard(onionUid);
+    expectVerdict("tomato + onion placed", 0, VERDICT_LIKES, waitForVerdict(0, VERDICT_LIKES, 1000));
+    expectVerdict("", 4, VERDICT_LIKES, waitForVerdict(4, VERDICT_LIKES, 1000));
+    runFor(2000);   // let the effects finish
+
+    unsigned long before = garden.getEvaluationCount();
+    simBank.chip(3).placeCard(potatoUid);
+    expectVerdict("potato placed", 0, VERDICT_DISLIKES, waitForVerdict(0, VERDICT_DISLIKES, 1000));
+    runFor(100);
+    if (garden.isRingAnimating(5) || garden.getReaderVerdict(4) != VERDICT_LIKES) {
+        printf("  FAIL reader 5 was redrawn although it is not next to reader 4\n");
+        failures++;
+    }
+    printf("  evaluations for the placement: %lu\n", garden.getEvaluationCount() - before);
+    runFor(2000);
+
+    before = garden.getEvaluationCount();
+    simBank.chip(3).removeCard();
+    expectVerdict("potato removed", 0, VERDICT_LIKES, waitForVerdict(0, VERDICT_LIKES, 2000));
+    printf("  evaluations for the removal: %lu\n", garden.getEvaluationCount() - before);
+    runFor(2000);
+
+    before = garden.getEvaluationCount();
+    runFor(STEADY_MS);
+    unsigned long steady = garden.getEvaluationCount() - before;
+    printf("Unchanged board for %d ms: %lu evaluations (periodic: %d)\n",
+           STEADY_MS, steady, 2 * STEADY_MS / OLD_EFFECT_INTERVAL);
+    if (steady != 0) {
+        printf("  FAIL the board was evaluated without a change\n");
+        failures++;
+    }
+
+    printf(failures ? "FAILED (%d)\n" : "OK\n", failures);
+    return failures ? 1 : 0;
+}
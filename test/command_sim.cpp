@@ -0,0 +1,174 @@
+/**
+ * Serial Command Reader Test (host)
+ *
+ * Feeds byte streams through CommandLine with a small command table and
+ * checks what it runs and what it answers:
+ * - a command split over many polls, a byte at a time
+ * - "\r\n", "\n" and "\r" line ends, blank lines and extra spaces
+ * - hex and number arguments, missing and extra arguments
+ * - unknown commands and lines longer than the buffer
+ * - a long session of 10000 commands
+ * The heap is counted for the whole run (operator new, and malloc with
+ * glibc): reading and running commands must not allocate a single byte.
+ *
+ * Build and run with: pio run -e command_sim && .pio/build/command_sim/program
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <new>
+#include "Arduino.h"
+#include "CommandLine.h"
+
+// Every heap allocation made by the program
+static unsigned long allocations = 0;
+
+void *operator new(size_t size) {
+    allocations++;
+    void *p = malloc(size ? size : 1);
+    if (!p) throw std::bad_alloc();
+    return p;
+}
+void *operator new[](size_t size) { return operator new(size); }
+void operator delete(void *p) noexcept { free(p); }
+void operator delete[](void *p) noexcept { free(p); }
+void operator delete(void *p, size_t) noexcept { free(p); }
+void operator delete[](void *p, size_t) noexcept { free(p); }
+
+#ifdef __GLIBC__
+extern "C" void *__libc_malloc(size_t size);
+extern "C" void *__libc_calloc(size_t count, size_t size);
+extern "C" void *__libc_realloc(void *p, size_t size);
+
+extern "C" void *malloc(size_t size) {
+    allocations++;
+    return __libc_malloc(size);
+}
+extern "C" void *calloc(size_t count, size_t size) {
+    allocations++;
+    return __libc_calloc(count, size);
+}
+extern "C" void *realloc(void *p, size_t size) {
+    allocations++;
+    return __libc_realloc(p, size);
+}
+#endif
+
+// What the handlers saw
+static char lastCommand[12];
+static char lastArgs[COMMAND_MAX_ARGS][COMMAND_LINE_LENGTH + 1];
+static uint8_t lastCount;
+static unsigned long runs;
+
+// What went out of the serial port
+static char reply[256];
+static size_t replyLength;
+
+static void onTx(uint8_t c) {
+    if (replyLength < sizeof(reply) - 1) reply[replyLength++] = c;
+    reply[replyLength] = '\0';
+}
+
+static void record(const char *name, const CommandArgs &args) {
+    strcpy(lastCommand, name);
+    lastCount = args.count();
+    for (uint8_t i = 0; i < args.count(); i++) strcpy(lastArgs[i], args.get(i));
+    runs++;
+}
+
+static void cmdMode(const CommandArgs &args) { record("mode", args); }
+
+static uint8_t registeredUid[4];
+static unsigned int registeredPlant;
+static bool registerOk;
+
+static void cmdRegister(const CommandArgs &args) {
+    record("register", args);
+    registerOk = args.getHex(0, registeredUid, 4) && args.getNumber(1, 8, &registeredPlant);
+}
+
+static void cmdTelemetry(const CommandArgs &args) { record("telemetry", args); }
+
+static const CommandEntry table[] PROGMEM = {
+    {"mode", "", "Change game mode", 0, cmdMode},
+    {"register", "[tag_id_hex] [plant_id]", "Register a new RFID tag", 2, cmdRegister},
+    {"telemetry", "on|off", "Binary frames", 1, cmdTelemetry},
+};
+
+static CommandLine commands(table, sizeof(table) / sizeof(table[0]));
+static int failures = 0;
+
+static void check(bool ok, const char *what) {
+    if (!ok) {
+        printf("  FAIL %s (reply \"%s\")\n", what, reply);
+        failures++;
+    }
+}
+
+// Feed a stream in chunks of 'chunk' bytes, the way poll() gets them
+static unsigned long feed(const char *stream, size_t chunk) {
+    unsigned long ranBefore = runs;
+    replyLength = 0;
+    reply[0] = '\0';
+    lastCommand[0] = '\0';
+
+    size_t length = strlen(stream);
+    for (size_t i = 0; i < length; i += chunk) {
+        for (size_t j = i; j < i + chunk && j < length; j++) commands.feed(stream[j]);
+    }
+    return runs - ranBefore;
+}
+
+int main() {
+    Serial.setMuted(true);
+    Serial.setTxHook(onTx);
+    printf("Serial command reader\n");    // stdout allocates its buffer here, before the count
+    unsigned long allocationsBefore = allocations;
+
+    // One command, a byte at a time and all at once, with every line end
+    check(feed("mode\n", 1) == 1 && strcmp(lastCommand, "mode") == 0, "mode, byte by byte");
+    check(feed("mode\r\n", 64) == 1, "mode with \\r\\n");
+    check(feed("mode\r", 64) == 1, "mode with \\r");
+    check(feed("\r\n\n  \n", 1) == 0 && replyLength == 0, "blank lines run nothing and say nothing");
+    check(feed("mod", 1) == 0 && feed("e\n", 1) == 1, "command split between two feeds");
+
+    // Arguments
+    check(feed("  register\t04E5121a   2 \r\n", 3) == 1 && registerOk && lastCount == 2, "register with spaces and tabs");
+    check(registeredUid[0] == 0x04 && registeredUid[1] == 0xE5 && registeredUid[2] == 0x12 &&
+          registeredUid[3] == 0x1A && registeredPlant == 2, "register arguments parsed");
+    check(feed("register 04E512 2\n", 5) == 1 && !registerOk, "short UID rejected");
+    check(feed("register 04E5121G 2\n", 5) == 1 && !registerOk, "bad hex digit rejected");
+    check(feed("register 04E5121A 9\n", 5) == 1 && !registerOk, "plant out of range rejected");
+    check(feed("register 04E5121A x2\n", 5) == 1 && !registerOk, "bad number rejected");
+    check(feed("register 04E5121A\n", 5) == 0 && strstr(reply, "Use: register [tag_id_hex] [plant_id]"),
+          "missing argument shows the usage");
+    check(feed("telemetry on\n", 2) == 1 && strcmp(lastArgs[0], "on") == 0, "telemetry on");
+    check(feed("telemetry a b c d e\n", 7) == 0 && strstr(reply, "Too many arguments"), "too many arguments");
+
+    // Unknown and overlong lines, and what comes after them
+    check(feed("modes\n", 4) == 0 && strstr(reply, "Unknown command"), "unknown command");
+    check(feed("MODE\n", 4) == 0, "names are case sensitive");
+    check(feed("register 04E5121A 2 xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx\n", 8) == 0 &&
+          strstr(reply, "Command too long"), "overlong line rejected as a whole");
+    check(feed("mode\n", 8) == 1, "next line after an overlong one");
+
+    // Help
+    replyLength = 0;
+    commands.printHelp();
+    check(strstr(reply, "register [tag_id_hex] [plant_id] - Register a new RFID tag\n") &&
+          strstr(reply, "mode - Change game mode\n"), "help lists the table");
+
+    // A long session
+    unsigned long ran = 0;
+    for (int i = 0; i < 10000; i++) {
+        ran += feed(i % 2 ? "register 04E5121A 2\r\n" : "telemetry off\n", 1 + i % 7);
+    }
+    check(ran == 10000, "every command of a long session ran");
+
+    unsigned long heap = allocations - allocationsBefore;
+    printf("%lu commands run, %lu heap allocations\n", runs, heap);
+    check(heap == 0, "heap allocations while reading commands");
+
+    printf(failures ? "FAILED (%d)\n" : "OK\n", failures);
+    return failures ? 1 : 0;
+}
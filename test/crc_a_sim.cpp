@@ -0,0 +1,119 @@
+/**
+ * CRC_A Test (host)
+ *
+ * Checks the software CRC_A of RFID1::calulateCRC():
+ * - against the examples of ISO 14443-3 and the HALT frame
+ * - against the CRC coprocessor of a simulated MFRC522 (PCD_CALCCRC, the
+ *   way the driver used to compute it) for random frames of every length
+ *   up to a WRITE data block
+ * and shows what a HALT costs on the reader bus now that the chip no
+ * longer computes its CRC.
+ *
+ * Build and run with: pio run -e crc_a_sim && .pio/build/crc_a_sim/program
+ */
+
+#include <stdio.h>
+#include "Arduino.h"
+#include "BoardConfig.h"
+#include "RFID1/rfid1.h"
+#include "mfrc522_sim.h"
+
+#define RANDOM_FRAMES 200
+#define MAX_FRAME 18
+
+static const uint8_t misoPins[NUM_READERS] = {
+    MISO_PIN1, MISO_PIN2, MISO_PIN3, MISO_PIN4, MISO_PIN5, MISO_PIN6
+};
+
+struct Vector {
+    uint8_t data[2];
+    uint8_t crc[2];     // as sent, low byte first
+};
+
+// ISO/IEC 14443-3 Annex B, and the HALT frame (50 00)
+static const Vector vectors[] = {
+    {{0x00, 0x00}, {0xA0, 0x1E}},
+    {{0x12, 0x34}, {0x26, 0xCF}},
+    {{PICC_HALT, 0x00}, {0x57, 0xCD}},
+};
+
+static int failures = 0;
+
+static void check(bool ok, const char *what) {
+    if (!ok) {
+        printf("  FAIL %s\n", what);
+        failures++;
+    }
+}
+
+// The CRC as the chip computes it
+static void chipCRC(RFID1 &reader, const uint8_t *data, uint8_t len, uint8_t *crc) {
+    reader.clearBitMask(DivIrqReg, 0x04);
+    reader.setBitMask(FIFOLevelReg, 0x80);
+    for (uint8_t i = 0; i < len; i++) {
+        reader.writeTo(FIFODataReg, data[i]);
+    }
+    reader.writeTo(CommandReg, PCD_CALCCRC);
+    uint8_t tries = 0xFF;
+    while (--tries && !(reader.readFrom(DivIrqReg) & 0x04)) {}
+    crc[0] = reader.readFrom(CRCResultRegL);
+    crc[1] = reader.readFrom(CRCResultRegM);
+}
+
+int main() {
+    simBank.attach(COMMON_SCK_PIN, COMMON_MOSI_PIN, COMMON_SS_PIN, COMMON_RST_PIN, misoPins, NUM_READERS);
+
+    uint8_t crc[2];
+    for (const Vector &v : vectors) {
+        RFID1::calulateCRC(v.data, 2, crc);
+        if (crc[0] != v.crc[0] || crc[1] != v.crc[1]) {
+            printf("  FAIL %02X %02X: %02X %02X, expected %02X %02X\n",
+                   v.data[0], v.data[1], crc[0], crc[1], v.crc[0], v.crc[1]);
+            failures++;
+        }
+    }
+
+    // Random frames against the chip
+    RFID1 reader;
+    reader.begin(COMMON_SS_PIN, COMMON_SCK_PIN, COMMON_MOSI_PIN, misoPins[0], COMMON_SS_PIN, COMMON_RST_PIN);
+    reader.init();
+    uint32_t seed = 2024;
+    uint8_t frame[MAX_FRAME], chip[2];
+    unsigned int mismatches = 0;
+    for (unsigned int n = 0; n < RANDOM_FRAMES; n++) {
+        uint8_t len = 1 + n % MAX_FRAME;
+        for (uint8_t i = 0; i < len; i++) {
+            seed = seed * 1103515245 + 12345;
+            frame[i] = seed >> 16;
+        }
+        RFID1::calulateCRC(frame, len, crc);
+        chipCRC(reader, frame, len, chip);
+        if (crc[0] != chip[0] || crc[1] != chip[1]) mismatches++;
+    }
+    printf("%d random frames of 1-%d bytes: %u differ from the chip's CRC\n", RANDOM_FRAMES, MAX_FRAME, mismatches);
+    check(mismatches == 0, "software CRC differs from the chip's");
+
+    // A HALT on the bank: the frame only
+    RFID1 bank;
+    bank.beginBank(COMMON_SCK_PIN, COMMON_MOSI_PIN, misoPins, NUM_READERS, COMMON_SS_PIN, COMMON_RST_PIN);
+    bank.startSession();
+    simBank.resetCounters();
+    uint64_t start = simNanos();
+    bank.startHalt((1 << NUM_READERS) - 1);
+    while (!bank.poll()) {}
+    double haltMs = (simNanos() - start) / 1e6;
+    unsigned long haltBytes = simBank.spiBytes();
+    unsigned long crcRuns = 0;
+    for (uint8_t i = 0; i < NUM_READERS; i++) crcRuns += simBank.chip(i).crcRuns;
+
+    simBank.resetCounters();
+    start = simNanos();
+    chipCRC(bank, vectors[2].data, 2, chip);
+    double chipMs = (simNanos() - start) / 1e6;
+    printf("HALT: %.2f ms, %lu SPI bytes; its CRC on the chip would add %.2f ms, %lu SPI bytes\n",
+           haltMs, haltBytes, chipMs, simBank.spiBytes());
+    check(crcRuns == 0, "HALT ran the chip's CRC coprocessor");
+
+    printf(failures ? "FAILED (%d)\n" : "OK\n", failures);
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,154 @@
+/**
+ * Learn Mode Simulation (host)
+ *
+ * Provisions a set of new tags by placement: learn mode is switched on for
+ * tomato, and 8 rounds of 6 new tags are placed on all six readers at once,
+ * 700 ms on and 700 ms off - about 250 tags a minute. One of them is a
+ * built-in potato tag. Checks that:
+ * - every new tag is captured and its ring lights up in tomato red
+ * - the built-in tag keeps its plant
+ * - the board never waits for the EEPROM and update() stays short while
+ *   batches are saved
+ * - after learn mode all captured tags are in EEPROM and survive a reset
+ * - the game is back on after learn mode
+ *
+ * Build and run with: pio run -e learn_sim && .pio/build/learn_sim/program
+ */
+
+#include <stdio.h>
+#include "Arduino.h"
+#include "EEPROM.h"
+#include "BoardConfig.h"
+#include "BoardController.h"
+#include "PlantDatabase.h"
+#include "TagStore.h"
+#include "mfrc522_sim.h"
+
+#define ROUNDS 8
+#define ON_MS 700
+#define OFF_MS 700
+
+static const uint8_t misoPins[NUM_READERS] = {
+    MISO_PIN1, MISO_PIN2, MISO_PIN3, MISO_PIN4, MISO_PIN5, MISO_PIN6
+};
+
+static const uint8_t potatoTag[4] = {0x04, 0xDA, 0x41, 0x3B};
+
+static BoardController garden;
+static int failures = 0;
+static double worstUpdateMs = 0;
+
+static void check(bool ok, const char *what) {
+    if (!ok) {
+        printf("  FAIL %s\n", what);
+        failures++;
+    }
+}
+
+static void newUid(uint8_t round, uint8_t reader, uint8_t *uid) {
+    uid[0] = 0x04;
+    uid[1] = 0xA0 + round;
+    uid[2] = 0x10 + reader;
+    uid[3] = 0x77;
+}
+
+static void runFor(unsigned long ms) {
+    unsigned long end = millis() + ms;
+    while (millis() < end) {
+        uint64_t start = simNanos();
+        garden.update();
+        double callMs = (simNanos() - start) / 1e6;
+        if (callMs > worstUpdateMs) worstUpdateMs = callMs;
+        delay(10);
+    }
+}
+
+static CRGB ringColor(uint8_t readerIndex) {
+    uint8_t chain = readerIndex < 4 ? 0 : 1;
+    uint8_t ring = readerIndex < 4 ? readerIndex : readerIndex - 4;
+    return FastLED[chain].leds()[ring * NUM_LEDS_PER_RING];
+}
+
+int main() {
+    simBank.attach(COMMON_SCK_PIN, COMMON_MOSI_PIN, COMMON_SS_PIN, COMMON_RST_PIN, misoPins, NUM_READERS);
+    Serial.setMuted(true);
+
+    garden.begin();
+    runFor(1000);
+
+    Plant tomato;
+    PlantDatabase::getPlantInfo(TOMATO, &tomato);
+    CRGB tomatoColor(tomato.color[0], tomato.color[1], tomato.color[2]);
+
+    check(garden.startLearning(TOMATO), "learn mode starts");
+    check(!garden.startLearning(UNKNOWN), "learn mode refuses UNKNOWN");
+    worstUpdateMs = 0;
+    uint64_t eepromWaitBefore = EEPROM.waitNs();
+    unsigned long start = millis();
+    unsigned long litRings = 0;
+
+    uint8_t uid[4];
+    for (uint8_t round = 0; round < ROUNDS; round++) {
+        for (uint8_t reader = 0; reader < NUM_READERS; reader++) {
+            if (round == 3 && reader == 0) {
+                simBank.chip(reader).placeCard(potatoTag);
+                continue;
+            }
+            newUid(round, reader, uid);
+            simBank.chip(reader).placeCard(uid);
+        }
+        runFor(ON_MS);
+        for (uint8_t reader = 0; reader < NUM_READERS; reader++) {
+            if (round == 3 && reader == 0) continue;
+            if (garden.getReaderState(reader)->currentPlant == TOMATO && ringColor(reader) == tomatoColor) {
+                litRings++;
+            }
+        }
+        for (uint8_t reader = 0; reader < NUM_READERS; reader++) {
+            simBank.chip(reader).removeCard();
+        }
+        runFor(OFF_MS);
+    }
+    double minutes = (millis() - start) / 60000.0;
+    unsigned int expected = ROUNDS * NUM_READERS - 1;
+
+    printf("%u new tags in %.1f s (%.0f tags/min): %u captured, %lu rings lit in tomato red\n",
+           expected, minutes * 60, expected / minutes, garden.getCapturedCount(), litRings);
+    printf("longest update() %.2f ms, waited for the EEPROM %.1f ms, %u tags not saved yet\n",
+           worstUpdateMs, (EEPROM.waitNs() - eepromWaitBefore) / 1e6, garden.getUnsavedCount());
+    check(garden.getCapturedCount() == expected, "every new tag captured");
+    check(litRings == expected, "every captured tag lit its ring in the plant color");
+    check(PlantDatabase::identifyPlantByTag((byte *)potatoTag) == POTATO, "built-in tag keeps its plant");
+    check(EEPROM.waitNs() == eepromWaitBefore, "the board waited for the EEPROM");
+    check(worstUpdateMs < 12, "update() too long while saving");
+
+    // Learn mode off: the rest is saved in the background
+    garden.stopLearning();
+    unsigned long saveStart = millis();
+    while (garden.getUnsavedCount() > 0 && millis() - saveStart < 5000) runFor(10);
+    printf("all saved %lu ms after learn mode ended, %lu EEPROM bytes written\n",
+           millis() - saveStart, EEPROM.totalWrites());
+    check(garden.getUnsavedCount() == 0, "captured tags still unsaved");
+
+    // Reset: the tags come back from EEPROM
+    PlantDatabase::initialize();
+    unsigned int found = 0;
+    for (uint8_t round = 0; round < ROUNDS; round++) {
+        for (uint8_t reader = 0; reader < NUM_READERS; reader++) {
+            newUid(round, reader, uid);
+            if (PlantDatabase::identifyPlantByTag(uid) == TOMATO) found++;
+        }
+    }
+    // Round 3 reader 1 got the potato tag, so its new UID was never seen
+    printf("after a reset: %u of %u tags are tomatoes, %u in the store\n", found, expected, TagStore::count());
+    check(found == expected && TagStore::count() == expected, "captured tags survive a reset");
+
+    // The game is back
+    newUid(0, 0, uid);
+    simBank.chip(0).placeCard(uid);
+    runFor(500);
+    check(garden.getReaderVerdict(0) != VERDICT_NONE, "verdict shown after learn mode");
+
+    printf(failures ? "FAILED (%d)\n" : "OK\n", failures);
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,139 @@
+/**
+ * LED Effect Scheduler Simulation (host)
+ *
+ * Runs the real BoardController with a registered plant tag on each of the
+ * six readers, so every ring plays its placement effect while the readers
+ * keep being scanned. Reports the longest update() call
+ * and checks that:
+ * - all six rings animate at the same time
+ * - no tag times out while the effects run
+ * - taking a tag away cuts its ring's effect short and turns the ring off
+ * - a LED chain is only pushed out when one of its rings changed
+ *
+ * Before the scheduler, a single dislike effect held update() for
+ * 3 x (18 x 20 ms + 100 ms) = 1380 ms.
+ *
+ * Build and run with: pio run -e led_effects_sim && .pio/build/led_effects_sim/program
+ */
+
+#include <stdio.h>
+#include "Arduino.h"
+#include "BoardConfig.h"
+#include "BoardController.h"
+#include "mfrc522_sim.h"
+
+#define RUN_MS 5000
+
+static const uint8_t misoPins[NUM_READERS] = {
+    MISO_PIN1, MISO_PIN2, MISO_PIN3, MISO_PIN4, MISO_PIN5, MISO_PIN6
+};
+
+// Tags registered in PlantDatabase (tomato, cucumber, potato, carrot, onion, pea)
+static const uint8_t cardUids[NUM_READERS][4] = {
+    {0x04, 0x53, 0x45, 0x3B}, {0x04, 0x5B, 0x2B, 0x3B}, {0x04, 0xDA, 0x41, 0x3B},
+    {0x04, 0xFF, 0x33, 0x3B}, {0x04, 0xCC, 0x25, 0x3B}, {0x04, 0xBD, 0x1B, 0x3B}
+};
+
+static BoardController garden;
+static int failures = 0;
+
+static uint8_t animatingMask() {
+    uint8_t mask = 0;
+    for (uint8_t i = 0; i < NUM_READERS; i++) {
+        if (garden.isRingAnimating(i + 1)) mask |= (1 << i);
+    }
+    return mask;
+}
+
+static uint8_t presentMask() {
+    uint8_t mask = 0;
+    for (uint8_t i = 0; i < NUM_READERS; i++) {
+        if (garden.getReaderState(i)->tagPresent) mask |= (1 << i);
+    }
+    return mask;
+}
+
+// Run loop() for 'ms' of simulated time; returns the longest update()
+static double runLoop(unsigned long ms, uint8_t *allAnimating, unsigned long *iterations) {
+    double worst = 0;
+    unsigned long end = millis() + ms;
+    while (millis() < end) {
+        uint64_t start = simNanos();
+        garden.update();
+        double callMs = (simNanos() - start) / 1e6;
+        if (callMs > worst) worst = callMs;
+        if (animatingMask() == 0x3F) *allAnimating = 1;
+        (*iterations)++;
+
+        // Same as the delay() at the end of loop()
+        delay(10);
+    }
+    return worst;
+}
+
+int main() {
+    simBank.attach(COMMON_SCK_PIN, COMMON_MOSI_PIN, COMMON_SS_PIN, COMMON_RST_PIN, misoPins, NUM_READERS);
+    Serial.setMuted(true);
+
+    garden.begin();
+    garden.changeGameMode();    // neighbors mode, so every placement has an effect
+
+    for (uint8_t i = 0; i < NUM_READERS; i++) {
+        simBank.chip(i).placeCard(cardUids[i]);
+    }
+
+    uint8_t allAnimating = 0;
+    unsigned long iterations = 0;
+    double worstMs = runLoop(RUN_MS, &allAnimating, &iterations);
+    printf("Six rings animating for %d ms: %lu loop iterations, longest update() %.2f ms\n",
+           RUN_MS, iterations, worstMs);
+
+    if (!allAnimating) {
+        printf("  FAIL the six rings never animated at the same time\n");
+        failures++;
+    }
+    if (presentMask() != 0x3F) {
+        printf("  FAIL tags lost while animating (present mask 0x%02X)\n", presentMask());
+        failures++;
+    }
+
+    const LedStats &stats = garden.getLedStats();
+    printf("LED output: %lu chain shows, %.1f ms in show during the run\n",
+           stats.shows, stats.showMicros / 1000.0);
+
+    // Readers 5 and 6 are the only rings on chain 2; once their tags are
+    // gone and the rings are off, chain 2 must not be pushed any more
+    simBank.chip(4).removeCard();
+    simBank.chip(5).removeCard();
+    runLoop(2000, &allAnimating, &iterations);
+    for (uint8_t ring = 1; ring <= 4; ring++) {
+        garden.rainbowEffect(ring, 200);
+    }
+    unsigned long chain1Before = FastLED[0].shows;
+    unsigned long chain2Before = FastLED[1].shows;
+    runLoop(3000, &allAnimating, &iterations);
+    unsigned long chain1Shows = FastLED[0].shows - chain1Before;
+    unsigned long chain2Shows = FastLED[1].shows - chain2Before;
+    printf("Only rings 1-4 animating for 3000 ms: chain 1 pushed %lu times, chain 2 %lu times\n",
+           chain1Shows, chain2Shows);
+    if (chain1Shows == 0 || chain2Shows != 0) {
+        printf("  FAIL idle chain 2 was pushed out\n");
+        failures++;
+    }
+
+    // Take the tag off reader 1 in the middle of an effect
+    garden.rainbowEffect(1, 200);
+    runLoop(100, &allAnimating, &iterations);
+    simBank.chip(0).removeCard();
+    iterations = 0;
+    runLoop(1000, &allAnimating, &iterations);
+    const CRGB *ring1 = &FastLED[0].leds()[0];
+    if (garden.isRingAnimating(1) || ring1[0] != CRGB(0, 0, 0)) {
+        printf("  FAIL ring 1 still lit after its tag was removed\n");
+        failures++;
+    }
+    printf("Tag removed from reader 1: ring stopped and cleared\n");
+
+    printf(failures ? "FAILED (%d)\n" : "OK\n", failures);
+    return failures ? 1 : 0;
+}
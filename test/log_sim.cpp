@@ -0,0 +1,112 @@
+/**
+ * Deferred Logging Simulation (host)
+ *
+ * Runs the real BoardController with the serial port at 9600 baud, the way
+ * the Uno is set up, in neighbors mode, where every placement explains its
+ * neighbors in the log. The simulated port has the Uno's 64 byte TX buffer
+ * and a write to a full buffer waits, like HardwareSerial does.
+ * Two runs: six registered tags placed one after the other, 500 ms apart,
+ * then all six taken off and put back at once. For both it reports the log
+ * bytes sent, the lines dropped and the longest update(), and checks that:
+ * - nothing ever waits for the serial port
+ * - every tag is detected
+ * - the log drains completely
+ *
+ * Build and run with: pio run -e log_sim && .pio/build/log_sim/program
+ */
+
+#include <stdio.h>
+#include "Arduino.h"
+#include "BoardConfig.h"
+#include "BoardController.h"
+#include "mfrc522_sim.h"
+
+#define BAUD 9600
+#define RUN_MS 8000
+
+static const uint8_t misoPins[NUM_READERS] = {
+    MISO_PIN1, MISO_PIN2, MISO_PIN3, MISO_PIN4, MISO_PIN5, MISO_PIN6
+};
+
+// Tags registered in PlantDatabase (tomato, cucumber, potato, carrot, onion, pea)
+static const uint8_t cardUids[NUM_READERS][4] = {
+    {0x04, 0x53, 0x45, 0x3B}, {0x04, 0x5B, 0x2B, 0x3B}, {0x04, 0xDA, 0x41, 0x3B},
+    {0x04, 0xFF, 0x33, 0x3B}, {0x04, 0xCC, 0x25, 0x3B}, {0x04, 0xBD, 0x1B, 0x3B}
+};
+
+static BoardController garden;
+static int failures = 0;
+
+// Run the board for 'ms', placing the tags 'spacingMs' apart (0: all at once)
+static void runPlacement(const char *name, unsigned long spacingMs, unsigned long ms) {
+    unsigned long txBefore = Serial.txBytes();
+    unsigned long droppedBefore = Log.getDropped();
+    uint64_t waitBefore = Serial.txWaitNs();
+    double worst = 0;
+
+    unsigned long start = millis();
+    uint8_t placed = 0;
+    while (millis() - start < ms) {
+        while (placed < NUM_READERS && millis() - start >= placed * spacingMs) {
+            simBank.chip(placed).placeCard(cardUids[placed]);
+            placed++;
+        }
+
+        uint64_t callStart = simNanos();
+        garden.update();
+        double callMs = (simNanos() - callStart) / 1e6;
+        if (callMs > worst) worst = callMs;
+        delay(10);
+    }
+
+    unsigned long sent = Serial.txBytes() - txBefore;
+    unsigned long dropped = Log.getDropped() - droppedBefore;
+    double waitMs = (Serial.txWaitNs() - waitBefore) / 1e6;
+    printf("%-22s %5lu bytes sent, %2lu lines dropped, longest update() %5.2f ms, "
+           "waited for serial %.1f ms\n", name, sent, dropped, worst, waitMs);
+
+    if (waitMs > 0) {
+        printf("  FAIL the board waited for the serial port\n");
+        failures++;
+    }
+    for (uint8_t i = 0; i < NUM_READERS; i++) {
+        if (!garden.getReaderState(i)->tagPresent) {
+            printf("  FAIL reader %d has no tag\n", i + 1);
+            failures++;
+        }
+    }
+    if (Log.pending() != 0) {
+        printf("  FAIL %d log bytes still waiting\n", Log.pending());
+        failures++;
+    }
+}
+
+static void runFor(unsigned long ms) {
+    unsigned long end = millis() + ms;
+    while (millis() < end) {
+        garden.update();
+        delay(10);
+    }
+}
+
+int main() {
+    simBank.attach(COMMON_SCK_PIN, COMMON_MOSI_PIN, COMMON_SS_PIN, COMMON_RST_PIN, misoPins, NUM_READERS);
+    Serial.setMuted(true);
+    Serial.begin(BAUD);
+
+    garden.begin();
+    garden.changeGameMode();    // neighbors mode
+    runFor(2000);               // let the startup output go out
+
+    printf("Placing six plant tags at %d baud\n", BAUD);
+    runPlacement("one by one, 500 ms", 500, RUN_MS);
+
+    for (uint8_t i = 0; i < NUM_READERS; i++) {
+        simBank.chip(i).removeCard();
+    }
+    runFor(3000);
+    runPlacement("all at once", 0, RUN_MS);
+
+    printf(failures ? "FAILED (%d)\n" : "OK\n", failures);
+    return failures ? 1 : 0;
+}
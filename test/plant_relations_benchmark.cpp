@@ -0,0 +1,154 @@
+/**
+ * Plant Relationship Benchmark (host)
+ *
+ * Compares the two ways of rating a plant's neighborhood:
+ * - matrix: look up relationships[plant][neighbor] for every neighbor,
+ *   stop at the first HATES (what applyContinuousEffect() used to do)
+ * - bitset: AND the plant's "hates" and "likes" sets with the set of
+ *   neighboring plants (PlantDatabase::getNeighborhoodRelationship())
+ *
+ * Catalogues of 8, 64 and 256 plants with random relationships are rated
+ * against random neighborhoods of up to 8 plants (a reader on the grid has
+ * at most 8 neighbors). Both paths must agree on every neighborhood. The
+ * "bitset" time includes building the neighbor set, since the board builds
+ * it from its readers every time; "AND only" rates a set built beforehand.
+ *
+ * Build and run with: pio run -e plant_relations_benchmark && .pio/build/plant_relations_benchmark/program
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <chrono>
+#include "PlantSet.h"
+
+#define NEIGHBORHOODS 4096
+#define ROUNDS 200
+#define MAX_NEIGHBORS 8
+
+enum { HATES = -1, NEUTRAL = 0, LIKES = 1 };
+
+static int failures = 0;
+
+template <uint16_t N>
+struct Catalogue {
+    int8_t matrix[N][N];
+    PlantBitset<N> likes[N];
+    PlantBitset<N> hates[N];
+
+    void generate() {
+        for (uint16_t i = 0; i < N; i++) {
+            likes[i].clear();
+            hates[i].clear();
+            for (uint16_t j = 0; j < N; j++) {
+                int r = rand() % 10;
+                matrix[i][j] = i == j ? NEUTRAL : (r < 2 ? HATES : (r < 5 ? LIKES : NEUTRAL));
+                if (matrix[i][j] == LIKES) likes[i].set(j);
+                if (matrix[i][j] == HATES) hates[i].set(j);
+            }
+        }
+    }
+
+    int rateMatrix(uint16_t plant, const uint16_t *neighbors, uint8_t count) const {
+        int outcome = NEUTRAL;
+        for (uint8_t k = 0; k < count; k++) {
+            int8_t relationship = matrix[plant][neighbors[k]];
+            if (relationship == HATES) return HATES;
+            if (relationship == LIKES) outcome = LIKES;
+        }
+        return outcome;
+    }
+
+    int rateBitset(uint16_t plant, const uint16_t *neighbors, uint8_t count) const {
+        PlantBitset<N> set;
+        set.clear();
+        for (uint8_t k = 0; k < count; k++) set.set(neighbors[k]);
+        return rateSet(plant, set);
+    }
+
+    int rateSet(uint16_t plant, const PlantBitset<N> &set) const {
+        if (hates[plant].intersects(set)) return HATES;
+        if (likes[plant].intersects(set)) return LIKES;
+        return NEUTRAL;
+    }
+};
+
+struct Neighborhood {
+    uint16_t plant;
+    uint8_t count;
+    uint16_t neighbors[MAX_NEIGHBORS];
+};
+
+static Neighborhood neighborhoods[NEIGHBORHOODS];
+
+template <uint16_t N>
+static void runBenchmark() {
+    typedef std::chrono::steady_clock Clock;
+    static Catalogue<N> catalogue;
+    static PlantBitset<N> sets[NEIGHBORHOODS];
+    catalogue.generate();
+
+    for (int i = 0; i < NEIGHBORHOODS; i++) {
+        neighborhoods[i].plant = rand() % N;
+        neighborhoods[i].count = 1 + rand() % MAX_NEIGHBORS;
+        for (uint8_t k = 0; k < neighborhoods[i].count; k++) {
+            neighborhoods[i].neighbors[k] = rand() % N;
+        }
+        sets[i].clear();
+        for (uint8_t k = 0; k < neighborhoods[i].count; k++) {
+            sets[i].set(neighborhoods[i].neighbors[k]);
+        }
+    }
+
+    for (int i = 0; i < NEIGHBORHOODS; i++) {
+        const Neighborhood &n = neighborhoods[i];
+        if (catalogue.rateMatrix(n.plant, n.neighbors, n.count) !=
+            catalogue.rateBitset(n.plant, n.neighbors, n.count)) {
+            failures++;
+        }
+    }
+
+    volatile int sink = 0;
+    Clock::time_point start = Clock::now();
+    for (int r = 0; r < ROUNDS; r++) {
+        for (int i = 0; i < NEIGHBORHOODS; i++) {
+            const Neighborhood &n = neighborhoods[i];
+            sink += catalogue.rateMatrix(n.plant, n.neighbors, n.count);
+        }
+    }
+    double matrixNs = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+
+    start = Clock::now();
+    for (int r = 0; r < ROUNDS; r++) {
+        for (int i = 0; i < NEIGHBORHOODS; i++) {
+            const Neighborhood &n = neighborhoods[i];
+            sink += catalogue.rateBitset(n.plant, n.neighbors, n.count);
+        }
+    }
+    double bitsetNs = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+
+    start = Clock::now();
+    for (int r = 0; r < ROUNDS; r++) {
+        for (int i = 0; i < NEIGHBORHOODS; i++) {
+            sink += catalogue.rateSet(neighborhoods[i].plant, sets[i]);
+        }
+    }
+    double andNs = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+    (void)sink;
+
+    double lookups = (double)ROUNDS * NEIGHBORHOODS;
+    printf("%4u plants   matrix %5.1f ns %6lu B | bitset %5.1f ns, AND only %5.1f ns %6lu B\n",
+           (unsigned)N, matrixNs / lookups, (unsigned long)sizeof(catalogue.matrix),
+           bitsetNs / lookups, andNs / lookups,
+           (unsigned long)(sizeof(catalogue.likes) + sizeof(catalogue.hates)));
+}
+
+int main() {
+    srand(42);
+    printf("Neighborhood rating, time per neighborhood and table size\n");
+    runBenchmark<8>();
+    runBenchmark<64>();
+    runBenchmark<256>();
+
+    printf(failures ? "FAILED (%d mismatches)\n" : "OK\n", failures);
+    return failures ? 1 : 0;
+}
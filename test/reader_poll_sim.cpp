@@ -0,0 +1,267 @@
+/**
+ * Adaptive Reader Polling Simulation (host)
+ *
+ * Runs the real BoardController against six simulated MFRC522 chips, with
+ * update() called about once a millisecond, and measures the reader bus:
+ * - bus time, scans and RF frames per second on an empty board, on a
+ *   board with six tags that stay put and on one with three tags and three
+ *   empty readers, with the RF transactions of a steady-state scan (one
+ *   that reads no UID)
+ * - detection latency of tags placed on empty readers while the other
+ *   readers hold tags: from the placement to tagPresent, next to the
+ *   board's own bound (from the last poll that found no tag). The
+ *   removals and placements keep readers in bursts, so the bus budget
+ *   holds some scans back here.
+ * - how long it takes to notice a removed tag and a tag swapped for
+ *   another one between two presence checks
+ * - a small bus budget: bus time per second stays under it, tags are
+ *   still found
+ * - tags that stay put for 20 s under budgets of 20 and 10 ms/s: scans
+ *   held back by the budget never time a tag out, a removed one still
+ *   goes
+ *
+ * Build and run with: pio run -e reader_poll_sim && .pio/build/reader_poll_sim/program
+ */
+
+#include <stdio.h>
+#include "Arduino.h"
+#include "BoardConfig.h"
+#include "BoardController.h"
+#include "mfrc522_sim.h"
+
+#define PLACEMENTS 60
+#define SMALL_BUDGET_US 40000
+#define HELD_SECONDS 20
+
+static const uint8_t misoPins[NUM_READERS] = {
+    MISO_PIN1, MISO_PIN2, MISO_PIN3, MISO_PIN4, MISO_PIN5, MISO_PIN6
+};
+
+static BoardController garden;
+static int failures = 0;
+
+static void check(bool ok, const char *what) {
+    if (!ok) {
+        printf("  FAIL %s\n", what);
+        failures++;
+    }
+}
+
+static void makeUid(uint8_t reader, uint8_t n, uint8_t *uid) {
+    uid[0] = 0x1B;
+    uid[1] = reader;
+    uid[2] = n;
+    uid[3] = 0x42;
+}
+
+static void step() {
+    garden.update();
+    delayMicroseconds(1000);
+}
+
+static void runFor(unsigned long ms) {
+    unsigned long end = millis() + ms;
+    while (millis() < end) step();
+}
+
+// Run until the reader's tag state is 'present' (and, when given, holds
+// 'uid'); the time it took in ms, or -1
+static long waitFor(uint8_t reader, bool present, const uint8_t *uid, unsigned long limitMs) {
+    unsigned long start = millis();
+    while (millis() - start < limitMs) {
+        step();
+        const ReaderState *state = garden.getReaderState(reader);
+        if (state->tagPresent == present && (!uid || memcmp(state->tagUID, uid, 4) == 0)) {
+            return millis() - start;
+        }
+    }
+    return -1;
+}
+
+static double steadyTransactions;
+
+// Bus time, scans and RF frames per second over 'ms'; the RF transactions
+// per steady-state scan go to steadyTransactions
+static void measure(unsigned long ms, double *busUs, double *scans, double *frames) {
+    // The board's per-second window is not lined up with this one
+    ScanStats before = garden.getScanStats();
+    simBank.resetCounters();
+    runFor(ms);
+    const ScanStats &after = garden.getScanStats();
+    *busUs = (after.busMicros - before.busMicros) * 1000.0 / ms;
+    *scans = (after.scans - before.scans) * 1000.0 / ms;
+    *frames = simBank.transceives() * 1000.0 / ms / NUM_READERS;
+    unsigned long steadyScans = after.steadyScans - before.steadyScans;
+    steadyTransactions = steadyScans ?
+        (double)(after.steadyTransactions - before.steadyTransactions) / steadyScans : 0;
+}
+
+int main() {
+    simBank.attach(COMMON_SCK_PIN, COMMON_MOSI_PIN, COMMON_SS_PIN, COMMON_RST_PIN, misoPins, NUM_READERS);
+    Serial.setMuted(true);
+
+    garden.begin();
+    runFor(1500);
+
+    double busUs, scans, frames;
+    uint8_t uid[4];
+
+    // An empty board
+    measure(5000, &busUs, &scans, &frames);
+    printf("empty board:   %6.1f ms bus/s, %5.1f scans/s, %5.1f RF frames/s per reader, "
+           "%.2f RF transactions per scan\n",
+           busUs / 1000, scans, frames, steadyTransactions);
+    check(busUs <= RFID_BUS_BUDGET_US, "empty board over the bus budget");
+    check(steadyTransactions == 1, "a scan of empty readers is one REQA");
+
+    // Six tags that stay put: presence checks, now and then a UID read
+    for (uint8_t i = 0; i < NUM_READERS; i++) {
+        makeUid(i, 0, uid);
+        simBank.chip(i).placeCard(uid);
+    }
+    runFor(1500);
+    for (uint8_t i = 0; i < NUM_READERS; i++) {
+        check(garden.getPollMode(i) == POLL_STABLE, "reader with a tag settles to stable");
+    }
+    unsigned long uidReadsBefore = garden.getPollStats(0)->uidReads;
+    unsigned long pollsBefore = garden.getPollStats(0)->polls;
+    measure(5000, &busUs, &scans, &frames);
+    double uidShare = (double)(garden.getPollStats(0)->uidReads - uidReadsBefore) /
+                      (garden.getPollStats(0)->polls - pollsBefore);
+    printf("six tags kept: %6.1f ms bus/s, %5.1f scans/s, %5.1f RF frames/s per reader, "
+           "%.2f RF transactions per scan, UID read on %.0f%% of polls\n",
+           busUs / 1000, scans, frames, steadyTransactions, uidShare * 100);
+    check(busUs <= RFID_BUS_BUDGET_US, "stable board over the bus budget");
+    bool allKept = true;
+    for (uint8_t i = 0; i < NUM_READERS; i++) {
+        if (!garden.getReaderState(i)->tagPresent || garden.getPollStats(i)->detections != 1) allKept = false;
+    }
+    check(allKept, "tags that stay put are never lost");
+
+    // Three tags kept, three empty readers: the empty ones are polled with
+    // REQA, which leaves the halted tags alone
+    for (uint8_t i = 3; i < NUM_READERS; i++) {
+        simBank.chip(i).removeCard();
+        check(waitFor(i, false, nullptr, 2000) >= 0, "removed tag noticed");
+    }
+    runFor(1500);
+    measure(5000, &busUs, &scans, &frames);
+    printf("three tags:    %6.1f ms bus/s, %5.1f scans/s, %5.1f RF frames/s per reader, "
+           "%.2f RF transactions per scan\n",
+           busUs / 1000, scans, frames, steadyTransactions);
+    check(steadyTransactions < 2, "scans of empty readers left the halted tags asleep");
+    allKept = true;
+    for (uint8_t i = 0; i < 3; i++) {
+        if (!garden.getReaderState(i)->tagPresent || garden.getPollStats(i)->detections != 1) allKept = false;
+    }
+    check(allKept, "tags kept next to empty readers are never lost");
+    for (uint8_t i = 3; i < NUM_READERS; i++) {
+        makeUid(i, 0, uid);
+        simBank.chip(i).placeCard(uid);
+        check(waitFor(i, true, uid, 1000) >= 0, "tag put back found");
+    }
+    runFor(1500);
+
+    // Placements on an empty reader while the others hold their tags
+    uint32_t seed = 12345;
+    double latencySum = 0;
+    long latencyMax = 0;
+    unsigned long detectionsBefore = 0, latencySumBefore = 0;
+    for (uint8_t i = 0; i < NUM_READERS; i++) {
+        detectionsBefore += garden.getPollStats(i)->detections;
+        latencySumBefore += garden.getPollStats(i)->latencySumMs;
+    }
+    for (uint8_t n = 1; n <= PLACEMENTS; n++) {
+        seed = seed * 1103515245 + 12345;
+        uint8_t reader = (seed >> 16) % NUM_READERS;
+        simBank.chip(reader).removeCard();
+        check(waitFor(reader, false, nullptr, 2000) >= 0, "removed tag noticed");
+        // Place at a random point of the reader's schedule
+        runFor(200 + (seed >> 8) % 97);
+        makeUid(reader, n, uid);
+        simBank.chip(reader).placeCard(uid);
+        long latency = waitFor(reader, true, uid, 1000);
+        if (latency < 0) {
+            printf("  FAIL tag %u on reader %u not found\n", n, reader + 1);
+            failures++;
+            continue;
+        }
+        latencySum += latency;
+        if (latency > latencyMax) latencyMax = latency;
+    }
+    unsigned long detections = 0, boardLatencySum = 0, boardLatencyMax = 0;
+    for (uint8_t i = 0; i < NUM_READERS; i++) {
+        detections += garden.getPollStats(i)->detections;
+        boardLatencySum += garden.getPollStats(i)->latencySumMs;
+        if (garden.getPollStats(i)->latencyMaxMs > boardLatencyMax) boardLatencyMax = garden.getPollStats(i)->latencyMaxMs;
+    }
+    detections -= detectionsBefore;
+    boardLatencySum -= latencySumBefore;
+    printf("%d placements:  found after %.1f ms avg, %ld ms max (board's bound %.1f ms avg, %lu ms max), "
+           "budget ran out in %lu s\n",
+           PLACEMENTS, latencySum / PLACEMENTS, latencyMax,
+           detections ? (double)boardLatencySum / detections : 0.0, boardLatencyMax,
+           garden.getScanStats().budgetHits);
+    check(detections == PLACEMENTS, "every placement counted once");
+    check(boardLatencySum >= latencySum, "board's bound below the real latency");
+    check(latencySum / PLACEMENTS <= POLL_EMPTY_MS + 40, "placement found within an empty-reader poll and a scan");
+
+    // Removal: the missed check starts a burst, the tag times out
+    simBank.chip(0).removeCard();
+    long removal = waitFor(0, false, nullptr, 2000);
+    printf("removal noticed after %ld ms\n", removal);
+    check(removal >= 0 && removal <= 500 + POLL_STABLE_MS + 50, "removal noticed within the timeout and a stable poll");
+
+    // A tag swapped between two presence checks: found by the next UID read,
+    // or sooner by a REQA that reader 1 listens in on (the new tag is not halted)
+    makeUid(1, 200, uid);
+    runFor(3000);
+    simBank.chip(1).removeCard();
+    simBank.chip(1).placeCard(uid);
+    long swap = waitFor(1, true, uid, 3000);
+    printf("swapped tag found after %ld ms\n", swap);
+    check(swap >= 0 && swap <= POLL_STABLE_MS * POLL_UID_EVERY + 100, "swapped tag found by a UID read");
+
+    // A small bus budget
+    garden.setBusBudget(SMALL_BUDGET_US);
+    runFor(2000);
+    unsigned long worstSecond = 0;
+    for (int second = 0; second < 5; second++) {
+        runFor(1000);
+        if (garden.getScanStats().busMicrosPerSecond > worstSecond) worstSecond = garden.getScanStats().busMicrosPerSecond;
+    }
+    makeUid(0, 201, uid);
+    simBank.chip(0).placeCard(uid);
+    long slowLatency = waitFor(0, true, uid, 3000);
+    printf("budget %d ms/s: at most %.1f ms bus/s, a placement found after %ld ms\n",
+           SMALL_BUDGET_US / 1000, worstSecond / 1000.0, slowLatency);
+    check(worstSecond <= SMALL_BUDGET_US, "bus time over the budget");
+    check(slowLatency >= 0, "tag found with a small budget");
+
+    // Budgets that hold the scans back for most of every second
+    static const unsigned long heldBudgets[] = {20000, 10000};
+    for (uint8_t b = 0; b < 2; b++) {
+        garden.setBusBudget(heldBudgets[b]);
+        unsigned long detectionsBefore = 0;
+        for (uint8_t i = 0; i < NUM_READERS; i++) detectionsBefore += garden.getPollStats(i)->detections;
+        unsigned long budgetHitsBefore = garden.getScanStats().budgetHits;
+        runFor(HELD_SECONDS * 1000UL);
+        unsigned long redetections = 0;
+        bool present = true;
+        for (uint8_t i = 0; i < NUM_READERS; i++) {
+            redetections += garden.getPollStats(i)->detections;
+            if (!garden.getReaderState(i)->tagPresent) present = false;
+        }
+        redetections -= detectionsBefore;
+        printf("budget %lu ms/s, six tags kept for %d s: budget ran out in %lu s, %lu tags detected again\n",
+               heldBudgets[b] / 1000, HELD_SECONDS, garden.getScanStats().budgetHits - budgetHitsBefore, redetections);
+        check(present && redetections == 0, "scans held back by the budget timed out tags that stayed put");
+    }
+    simBank.chip(0).removeCard();
+    long heldRemoval = waitFor(0, false, nullptr, 3000);
+    printf("budget 10 ms/s: removal noticed after %ld ms\n", heldRemoval);
+    check(heldRemoval >= 0, "removal noticed while the budget holds scans back");
+
+    printf(failures ? "FAILED (%d)\n" : "OK\n", failures);
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,124 @@
+/**
+ * Non-blocking Reader Scan Simulation (host)
+ *
+ * Runs the real BoardController against six simulated MFRC522 chips and
+ * measures how long a single loop() iteration can take while the readers
+ * are scanned. The cards answer with a configurable latency, which is what
+ * a slow or badly coupled tag looks like to the driver. The blocking scan
+ * (request, anticollision and halt back to back, as update() used to do it)
+ * is measured on the same bank for comparison.
+ *
+ * The tags are not registered to any plant and are placed once the game
+ * mode flash of begin() and the tags of the previous run are gone, so no
+ * LED effect runs and the loop time is the scan alone.
+ *
+ * Build and run with: pio run -e rfid_async_sim && .pio/build/rfid_async_sim/program
+ */
+
+#include <stdio.h>
+#include "Arduino.h"
+#include "BoardConfig.h"
+#include "BoardController.h"
+#include "mfrc522_sim.h"
+
+#define RUN_MS 2000
+
+static const uint8_t misoPins[NUM_READERS] = {
+    MISO_PIN1, MISO_PIN2, MISO_PIN3, MISO_PIN4, MISO_PIN5, MISO_PIN6
+};
+
+static const uint8_t cardUids[NUM_READERS][4] = {
+    {0x1A, 0x00, 0x00, 0x01}, {0x1A, 0x00, 0x00, 0x02}, {0x1A, 0x00, 0x00, 0x03},
+    {0x1A, 0x00, 0x00, 0x04}, {0x1A, 0x00, 0x00, 0x05}, {0x1A, 0x00, 0x00, 0x06}
+};
+
+static BoardController garden;
+static int failures = 0;
+
+static void placeCards(uint32_t responseUs) {
+    for (uint8_t i = 0; i < NUM_READERS; i++) {
+        simBank.chip(i).placeCard(cardUids[i], responseUs);
+    }
+}
+
+// Longest blocking scan on the bank, the way update() used to scan
+static double blockingScanMs(uint32_t responseUs) {
+    RFID1 bank;
+    uchar uids[NUM_READERS][5];
+    double worst = 0;
+
+    placeCards(responseUs);
+    bank.beginBank(COMMON_SCK_PIN, COMMON_MOSI_PIN, misoPins, NUM_READERS, COMMON_SS_PIN, COMMON_RST_PIN);
+    bank.startSession();
+    for (int i = 0; i < 5; i++) {
+        uint64_t start = simNanos();
+        uint8_t mask = bank.checkSession((1 << NUM_READERS) - 1);
+        uint8_t present = bank.requestAll(PICC_REQALL, mask);
+        if (present && bank.anticollAll(present, uids)) bank.halt();
+        double ms = (simNanos() - start) / 1e6;
+        if (ms > worst) worst = ms;
+    }
+    return worst;
+}
+
+// Longest update() call on the board while it scans for RUN_MS
+static double asyncLoopMs(uint32_t responseUs, uint8_t *detected) {
+    // Let the board settle with no tags on it
+    for (uint8_t i = 0; i < NUM_READERS; i++) simBank.chip(i).removeCard();
+    unsigned long end = millis() + 1000;
+    while (millis() < end) {
+        garden.update();
+        delayMicroseconds(50);
+    }
+    placeCards(responseUs);
+
+    double worst = 0;
+    end = millis() + RUN_MS;
+    while (millis() < end) {
+        uint64_t start = simNanos();
+        garden.update();
+        double ms = (simNanos() - start) / 1e6;
+        if (ms > worst) worst = ms;
+
+        // The rest of loop() - button, serial - takes a little time too
+        delayMicroseconds(50);
+    }
+
+    *detected = 0;
+    for (uint8_t i = 0; i < NUM_READERS; i++) {
+        const ReaderState *state = garden.getReaderState(i);
+        if (state->tagPresent && memcmp(state->tagUID, cardUids[i], 4) == 0) {
+            *detected |= (1 << i);
+        }
+    }
+    return worst;
+}
+
+static void runLatency(uint32_t responseUs) {
+    uint8_t detected;
+    double blockingMs = blockingScanMs(responseUs);
+    double asyncMs = asyncLoopMs(responseUs, &detected);
+
+    printf("card latency %6.1f ms   blocking scan %6.2f ms | longest update() %5.2f ms\n",
+           responseUs / 1000.0, blockingMs, asyncMs);
+    if (detected != 0x3F) {
+        printf("  FAIL tags detected on mask 0x%02X, expected 0x3F\n", detected);
+        failures++;
+    }
+}
+
+int main() {
+    simBank.attach(COMMON_SCK_PIN, COMMON_MOSI_PIN, COMMON_SS_PIN, COMMON_RST_PIN, misoPins, NUM_READERS);
+    Serial.setMuted(true);
+
+    garden.begin();
+
+    printf("Reader scan vs. loop time, %d readers with tags\n", NUM_READERS);
+    runLatency(300);
+    runLatency(2000);
+    runLatency(8000);
+    runLatency(14000);
+
+    printf(failures ? "FAILED (%d)\n" : "OK\n", failures);
+    return failures ? 1 : 0;
+}
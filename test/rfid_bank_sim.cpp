@@ -0,0 +1,236 @@
+/**
+ * RFID Bank Scan Simulation (host)
+ *
+ * Runs the RFID1 driver against six simulated MFRC522 chips wired like the
+ * board (shared SCK/MOSI/SS/RST, one MISO line per reader) and compares
+ * a full board scan done reader by reader - the way checkReader() used to
+ * do it - with a single bank-mode scan that broadcasts every write and
+ * samples all MISO lines on the same SCK edge. A third column shows the
+ * steady-state scan with a persistent reader session (no soft reset and
+ * no settle delay per scan), followed by a chip reset/brownout check and
+ * a presence check with readers left empty on the long and on the short
+ * chip timer.
+ *
+ * Build and run with: pio run -e rfid_bank_sim && .pio/build/rfid_bank_sim/program
+ */
+
+#include <stdio.h>
+#include "Arduino.h"
+#include "BoardConfig.h"
+#include "RFID1/rfid1.h"
+#include "mfrc522_sim.h"
+
+static const uint8_t misoPins[NUM_READERS] = {
+    MISO_PIN1, MISO_PIN2, MISO_PIN3, MISO_PIN4, MISO_PIN5, MISO_PIN6
+};
+
+static const uint8_t cardUids[NUM_READERS][4] = {
+    {0x04, 0x53, 0x45, 0x3B}, {0x04, 0x5B, 0x2B, 0x3B}, {0x04, 0xDA, 0x41, 0x3B},
+    {0x04, 0xFF, 0x33, 0x3B}, {0x04, 0xCC, 0x25, 0x3B}, {0x04, 0xBD, 0x1B, 0x3B}
+};
+
+static int failures = 0;
+
+// Scan the way the old BoardController::checkReader() did, one reader at a time
+static uint8_t scanSequential(uint8_t uids[NUM_READERS][5]) {
+    uint8_t found = 0;
+    for (uint8_t i = 0; i < NUM_READERS; i++) {
+        RFID1 reader;
+        uchar str[MAX_LEN];
+
+        reader.begin(COMMON_SS_PIN, COMMON_SCK_PIN, COMMON_MOSI_PIN, misoPins[i], COMMON_SS_PIN, COMMON_RST_PIN);
+        reader.init();
+        delay(50);
+        if (reader.request(PICC_REQIDL, str) != MI_OK) continue;
+        if (reader.anticoll(str) != MI_OK) continue;
+        memcpy(uids[i], str, 5);
+        found |= (1 << i);
+        reader.halt();
+    }
+    return found;
+}
+
+// Scan the way BoardController::scanReaders() does it, all readers at once
+static uint8_t scanBank(RFID1 &bank, uint8_t uids[NUM_READERS][5]) {
+    bank.init();
+    delay(50);
+    uint8_t present = bank.requestAll(PICC_REQIDL, (1 << NUM_READERS) - 1);
+    if (!present) return 0;
+    uint8_t found = bank.anticollAll(present, uids);
+    bank.halt();
+    return found;
+}
+
+// Scan the way BoardController::scanReaders() does it with a reader session
+static uint8_t scanSession(RFID1 &bank, uint8_t uids[NUM_READERS][5]) {
+    uint8_t mask = bank.checkSession((1 << NUM_READERS) - 1);
+    uint8_t present = mask ? bank.requestAll(PICC_REQALL, mask) : 0;
+    if (!present) return 0;
+    uint8_t found = bank.anticollAll(present, uids);
+    bank.halt();
+    return found;
+}
+
+static void startBankSession(RFID1 &bank) {
+    bank.beginBank(COMMON_SCK_PIN, COMMON_MOSI_PIN, misoPins, NUM_READERS, COMMON_SS_PIN, COMMON_RST_PIN);
+    bank.startSession();
+    bank.setConfig(RFCfgReg, 0x70);
+}
+
+static void check(const char *what, uint8_t found, uint8_t expected, uint8_t uids[NUM_READERS][5]) {
+    if (found != expected) {
+        printf("  FAIL %s: found mask 0x%02X, expected 0x%02X\n", what, found, expected);
+        failures++;
+        return;
+    }
+    for (uint8_t i = 0; i < NUM_READERS; i++) {
+        if ((found & (1 << i)) && memcmp(uids[i], cardUids[i], 4) != 0) {
+            printf("  FAIL %s: wrong UID on reader %d\n", what, i + 1);
+            failures++;
+        }
+    }
+}
+
+static void runScenario(const char *name, uint8_t cardMask) {
+    uint8_t uids[NUM_READERS][5];
+    RFID1 bank;
+
+    for (uint8_t i = 0; i < NUM_READERS; i++) {
+        if (cardMask & (1 << i)) {
+            simBank.chip(i).placeCard(cardUids[i]);
+        } else {
+            simBank.chip(i).removeCard();
+        }
+    }
+
+    simBank.resetCounters();
+    uint64_t start = simNanos();
+    memset(uids, 0, sizeof(uids));
+    uint8_t found = scanSequential(uids);
+    double seqMs = (simNanos() - start) / 1e6;
+    unsigned long seqBytes = simBank.spiBytes();
+    check("sequential", found, cardMask, uids);
+
+    bank.beginBank(COMMON_SCK_PIN, COMMON_MOSI_PIN, misoPins, NUM_READERS, COMMON_SS_PIN, COMMON_RST_PIN);
+    simBank.resetCounters();
+    start = simNanos();
+    memset(uids, 0, sizeof(uids));
+    found = scanBank(bank, uids);
+    double bankMs = (simNanos() - start) / 1e6;
+    unsigned long bankBytes = simBank.spiBytes();
+    check("bank", found, cardMask, uids);
+
+    // Steady state: the session is already up and the cards were halted once
+    RFID1 session;
+    startBankSession(session);
+    scanSession(session, uids);
+    simBank.resetCounters();
+    start = simNanos();
+    memset(uids, 0, sizeof(uids));
+    found = scanSession(session, uids);
+    double sessionMs = (simNanos() - start) / 1e6;
+    unsigned long sessionBytes = simBank.spiBytes();
+    check("session", found, cardMask, uids);
+
+    printf("%-20s sequential %7.2f ms %5lu B | bank %6.2f ms %4lu B | session %6.2f ms %4lu B\n",
+           name, seqMs, seqBytes, bankMs, bankBytes, sessionMs, sessionBytes);
+}
+
+// A chip that resets or browns out must get its configuration back
+static void runSessionRecovery() {
+    uint8_t uids[NUM_READERS][5];
+    RFID1 session;
+
+    for (uint8_t i = 0; i < NUM_READERS; i++) simBank.chip(i).placeCard(cardUids[i]);
+    startBankSession(session);
+    scanSession(session, uids);
+
+    simBank.chip(2).powerOn();   // brownout on reader 3
+    memset(uids, 0, sizeof(uids));
+    uint8_t found = scanSession(session, uids);
+    found |= scanSession(session, uids);
+    check("after brownout", found, 0x3F, uids);
+    if (session.sessionReinits() != 1 || simBank.chip(2).peek(RFCfgReg) != 0x70) {
+        printf("  FAIL reader 3 config not restored (reinits %u, RFCfgReg 0x%02X)\n",
+               session.sessionReinits(), simBank.chip(2).peek(RFCfgReg));
+        failures++;
+    }
+
+    simBank.chip(4).setPowered(false);   // reader 5 drops off the bus
+    found = scanSession(session, uids);
+    if (found != 0x2F) {
+        printf("  FAIL offline reader 5 still reported (mask 0x%02X)\n", found);
+        failures++;
+    }
+    simBank.chip(4).setPowered(true);
+
+    printf("Session recovery: %u re-init(s), reader 3 gain 0x%02X after brownout\n",
+           session.sessionReinits(), simBank.chip(2).peek(RFCfgReg));
+}
+
+// A presence check lasts until the last empty reader gives up: compare
+// the long timer with the short one requestAll() switches to. The switch
+// must not reset the chips or look like lost configuration.
+static void runTimerProfiles() {
+    uint8_t uids[NUM_READERS][5];
+    uint8_t wupa = PICC_REQALL;
+    uint8_t back[NUM_READERS][5];
+    uint bits[NUM_READERS];
+    RFID1 session;
+
+    for (uint8_t i = 0; i < NUM_READERS; i++) {
+        if (i < 3) simBank.chip(i).placeCard(cardUids[i]);
+        else simBank.chip(i).removeCard();
+    }
+    startBankSession(session);
+    unsigned long resetsBefore = simBank.chip(0).softResets;
+
+    session.setTimerProfile(RFID1_TIMER_LONG);
+    session.writeTo(BitFramingReg, 0x07);
+    uint64_t start = simNanos();
+    uint8_t longFound = session.toCardAll(PCD_TRANSCEIVE, &wupa, 1, 0x3F, &back[0][0], 5, bits);
+    double longMs = (simNanos() - start) / 1e6;
+    session.anticollAll(longFound, uids);
+    session.halt();
+
+    start = simNanos();
+    uint8_t shortFound = session.requestAll(PICC_REQALL, 0x3F);
+    double shortMs = (simNanos() - start) / 1e6;
+    uint8_t read = session.anticollAll(shortFound, uids);
+    session.halt();
+    check("anticollision after the switch", read, 0x07, uids);
+    if (session.timerProfile() != RFID1_TIMER_LONG) {
+        printf("  FAIL anticollision left on the short timer\n");
+        failures++;
+    }
+    session.checkSession(0x3F);
+
+    printf("Presence check, tags on 1-3: long timer %5.2f ms, short timer %4.2f ms\n", longMs, shortMs);
+    if (longFound != 0x07 || shortFound != 0x07) {
+        printf("  FAIL presence found 0x%02X / 0x%02X, expected 0x07\n", longFound, shortFound);
+        failures++;
+    }
+    // Both include the same register traffic; the wait goes from 15 ms to 0.54 ms
+    if (longMs - shortMs < 14) {
+        printf("  FAIL short timer not 14 ms quicker\n");
+        failures++;
+    }
+    if (session.sessionReinits() != 0 || simBank.chip(0).softResets != resetsBefore) {
+        printf("  FAIL timer switch reset the chips (reinits %u)\n", session.sessionReinits());
+        failures++;
+    }
+}
+
+int main() {
+    simBank.attach(COMMON_SCK_PIN, COMMON_MOSI_PIN, COMMON_SS_PIN, COMMON_RST_PIN, misoPins, NUM_READERS);
+
+    printf("Full board scan, %d readers\n", NUM_READERS);
+    runScenario("no tags", 0x00);
+    runScenario("tags on 1, 3, 6", 0x25);
+    runScenario("tags on all readers", 0x3F);
+    runSessionRecovery();
+    runTimerProfiles();
+
+    printf(failures ? "FAILED (%d)\n" : "OK\n", failures);
+    return failures ? 1 : 0;
+}
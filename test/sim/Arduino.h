@@ -0,0 +1,130 @@
+/**
+ * Minimal Arduino core for host-side simulations
+ *
+ * Provides just enough of the Arduino API for the firmware libraries in
+ * lib/ to compile and run on a PC. Pin I/O is routed to a simulated
+ * peripheral (see mfrc522_sim.h) and time is a virtual clock that advances
+ * by the approximate cost of each call on an ATmega328P at 16 MHz, so the
+ * simulations report timings that are comparable to the real board.
+ */
+
+#ifndef ARDUINO_SIM_H
+#define ARDUINO_SIM_H
+
+// rfid1.h/softspi.h define 'uint' as a macro, which clashes with the libc
+// typedef - keep it out of the way while pulling in the system headers
+#pragma push_macro("uint")
+#undef uint
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#pragma pop_macro("uint")
+
+typedef uint8_t byte;
+typedef bool boolean;
+
+#define HIGH 0x1
+#define LOW  0x0
+
+#define INPUT 0x0
+#define OUTPUT 0x1
+#define INPUT_PULLUP 0x2
+
+#define A0 14
+#define A1 15
+#define A2 16
+#define A3 17
+#define A4 18
+#define A5 19
+
+#define DEC 10
+#define HEX 16
+#define OCT 8
+#define BIN 2
+
+#define PROGMEM
+#define pgm_read_byte(addr) (*(const uint8_t *)(addr))
+#define pgm_read_word(addr) (*(const uint16_t *)(addr))
+#define pgm_read_dword(addr) (*(const uint32_t *)(addr))
+#define pgm_read_ptr(addr) (*(void * const *)(addr))
+#define memcpy_P memcpy
+#define memcmp_P memcmp
+#define strcmp_P strcmp
+
+class __FlashStringHelper;
+#define F(string_literal) (reinterpret_cast<const __FlashStringHelper *>(string_literal))
+
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t val);
+int digitalRead(uint8_t pin);
+
+unsigned long millis(void);
+unsigned long micros(void);
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+
+// Serial output goes to stdout unless muted
+// Once begin() is called, the TX side behaves like the Uno's: a 64 byte
+// buffer that drains at the baud rate, and a write to a full buffer waits
+// (on the virtual clock) until there is room.
+class SimSerial {
+public:
+    void begin(unsigned long baud) { _baud = baud; }
+    operator bool() { return true; }
+    int available() { return 0; }
+    int read() { return -1; }
+    void setMuted(bool muted) { _muted = muted; }
+    void setTxHook(void (*hook)(uint8_t c)) { _txHook = hook; }    // sees every byte written
+
+    int availableForWrite();
+    size_t write(uint8_t c);
+    size_t write(const uint8_t *buffer, size_t size);
+    unsigned long txBytes() { return _txBytes; }
+    uint64_t txWaitNs() { return _txWaitNs; }      // time writes spent waiting for room
+
+    size_t print(const char *s);
+    size_t print(const __FlashStringHelper *s) { return print(reinterpret_cast<const char *>(s)); }
+    size_t print(char c);
+    size_t print(unsigned char n, int base = DEC) { return print((unsigned long)n, base); }
+    size_t print(int n, int base = DEC) { return print((long)n, base); }
+    size_t print(unsigned int n, int base = DEC) { return print((unsigned long)n, base); }
+    size_t print(long n, int base = DEC);
+    size_t print(unsigned long n, int base = DEC);
+    size_t print(double n, int digits = 2);
+
+    size_t println(void) { return print("\n"); }
+    template <typename T> size_t println(T value) { size_t n = print(value); return n + println(); }
+    template <typename T> size_t println(T value, int mod) { size_t n = print(value, mod); return n + println(); }
+
+private:
+    bool _muted = false;
+    unsigned long _baud = 0;
+    uint16_t _txQueued = 0;
+    uint64_t _txDrainNs = 0;    // when the byte at the front of the queue has gone out
+    unsigned long _txBytes = 0;
+    uint64_t _txWaitNs = 0;
+    void (*_txHook)(uint8_t c) = nullptr;
+
+    void drainTx();
+};
+
+extern SimSerial Serial;
+
+// Hooks for simulated peripherals and the virtual clock
+typedef void (*SimPinWriteHook)(uint8_t pin, uint8_t val);
+typedef int (*SimPinReadHook)(uint8_t pin, int *handled);
+
+struct SimCostModel {
+    uint32_t digitalWriteNs;   // digitalWrite() incl. pin table lookup
+    uint32_t digitalReadNs;    // digitalRead() incl. pin table lookup
+};
+
+extern SimCostModel simCost;
+
+void simSetPinHooks(SimPinWriteHook writeHook, SimPinReadHook readHook);
+uint64_t simNanos(void);
+void simAdvanceNs(uint64_t ns);
+uint8_t simPinLevel(uint8_t pin);
+
+#endif // ARDUINO_SIM_H
@@ -0,0 +1,49 @@
+/**
+ * EEPROM for host-side simulations: the 1 KB of the ATmega328P, starting
+ * out erased (0xFF). Like on the AVR, a write starts the 3.4 ms cell write
+ * and returns; the next read or write waits on the virtual clock until it
+ * is done. Writes are counted per cell, so tests can check wear.
+ */
+
+#ifndef EEPROM_SIM_H
+#define EEPROM_SIM_H
+
+#include <stdint.h>
+
+#define SIM_EEPROM_SIZE 1024
+
+class EEPROMClass {
+public:
+    uint8_t read(int idx);
+    void write(int idx, uint8_t val);
+    void update(int idx, uint8_t val) { if (read(idx) != val) write(idx, val); }
+    uint16_t length() { return SIM_EEPROM_SIZE; }
+    bool ready();                                   // no write in progress
+
+    // Test helpers
+    void erase();                                   // back to a new chip
+    unsigned long cellWrites(int idx) { return _writes[idx]; }
+    unsigned long totalWrites() { return _totalWrites; }
+    unsigned long totalReads() { return _totalReads; }
+    uint64_t waitNs() { return _waitNs; }           // time spent waiting for a write
+    void corrupt(int idx, uint8_t val) { init(); _data[idx] = val; }     // no cost, not counted
+
+private:
+    uint8_t _data[SIM_EEPROM_SIZE];
+    unsigned long _writes[SIM_EEPROM_SIZE];
+    unsigned long _totalWrites = 0;
+    unsigned long _totalReads = 0;
+    uint64_t _busyUntilNs = 0;
+    uint64_t _waitNs = 0;
+    bool _initialized = false;
+
+    void init();
+    void waitReady();
+};
+
+extern EEPROMClass EEPROM;
+
+// avr/eeprom.h
+inline bool eeprom_is_ready() { return EEPROM.ready(); }
+
+#endif // EEPROM_SIM_H
@@ -0,0 +1,88 @@
+/**
+ * Minimal FastLED for host-side simulations
+ *
+ * Covers the parts of the FastLED API the firmware uses. The pixel data is
+ * kept so tests can inspect it, and show() advances the virtual clock by
+ * the time a WS2812B chain needs for the data (30 us per LED plus latch),
+ * during which the real library also keeps interrupts off.
+ */
+
+#ifndef FASTLED_SIM_H
+#define FASTLED_SIM_H
+
+#include "Arduino.h"
+
+#define SIM_MAX_CONTROLLERS 4
+
+enum { WS2812B = 0 };
+enum EOrder { RGB = 0, GRB };
+
+struct CRGB {
+    uint8_t r, g, b;
+
+    enum HTMLColorCode {
+        Black = 0x000000,
+        White = 0xFFFFFF
+    };
+
+    CRGB() : r(0), g(0), b(0) {}
+    CRGB(uint8_t ir, uint8_t ig, uint8_t ib) : r(ir), g(ig), b(ib) {}
+    CRGB(uint32_t colorcode) : r(colorcode >> 16), g(colorcode >> 8), b(colorcode) {}
+    CRGB(const struct CHSV &hsv);
+
+    bool operator==(const CRGB &o) const { return r == o.r && g == o.g && b == o.b; }
+    bool operator!=(const CRGB &o) const { return !(*this == o); }
+};
+
+struct CHSV {
+    uint8_t h, s, v;
+    CHSV(uint8_t ih, uint8_t is, uint8_t iv) : h(ih), s(is), v(iv) {}
+};
+
+class CLEDController {
+public:
+    void showLeds(uint8_t brightness);
+    CRGB *leds() { return _leds; }
+    int size() const { return _count; }
+
+    // Frames pushed out on this chain
+    unsigned long shows;
+
+private:
+    friend class CFastLED;
+    CRGB *_leds;
+    int _count;
+};
+
+class CFastLED {
+public:
+    template <int CHIPSET, uint8_t DATA_PIN, EOrder RGB_ORDER>
+    CLEDController &addLeds(CRGB *data, int offset, int count) {
+        if (_count == SIM_MAX_CONTROLLERS) abort();
+        CLEDController &c = _controllers[_count++];
+        c._leds = data + offset;
+        c._count = count;
+        c.shows = 0;
+        return c;
+    }
+
+    void show();
+    void clear(bool writeData = false);
+    void setBrightness(uint8_t scale) { _brightness = scale; }
+    uint8_t getBrightness() const { return _brightness; }
+
+    int count() const { return _count; }
+    CLEDController &operator[](int x) { return _controllers[x]; }
+
+    // Time spent pushing data out, summed over all chains
+    uint64_t showNs;
+
+private:
+    CLEDController _controllers[SIM_MAX_CONTROLLERS];
+    int _count;
+    uint8_t _brightness = 255;
+};
+
+extern CFastLED FastLED;
+
+#endif // FASTLED_SIM_H
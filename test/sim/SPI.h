@@ -0,0 +1,16 @@
+/**
+ * Minimal SPI for host-side simulations - the readers use soft-SPI, so
+ * this only has to satisfy SPI.begin()
+ */
+
+#ifndef SPI_SIM_H
+#define SPI_SIM_H
+
+class SPIClass {
+public:
+    void begin() {}
+};
+
+extern SPIClass SPI;
+
+#endif // SPI_SIM_H
@@ -0,0 +1,145 @@
+#include "Arduino.h"
+#include <stdio.h>
+
+// Typical figures for digitalWrite()/digitalRead() on an Uno at 16 MHz
+SimCostModel simCost = {3400, 3600};
+
+SimSerial Serial;
+
+static uint64_t nowNs = 0;
+static uint8_t pinLevels[32];
+static SimPinWriteHook pinWriteHook = nullptr;
+static SimPinReadHook pinReadHook = nullptr;
+
+void simSetPinHooks(SimPinWriteHook writeHook, SimPinReadHook readHook) {
+    pinWriteHook = writeHook;
+    pinReadHook = readHook;
+}
+
+uint64_t simNanos(void) {
+    return nowNs;
+}
+
+void simAdvanceNs(uint64_t ns) {
+    nowNs += ns;
+}
+
+uint8_t simPinLevel(uint8_t pin) {
+    return pin < sizeof(pinLevels) ? pinLevels[pin] : LOW;
+}
+
+void pinMode(uint8_t pin, uint8_t mode) {
+    if (pin < sizeof(pinLevels) && mode == INPUT_PULLUP) {
+        pinLevels[pin] = HIGH;
+    }
+}
+
+void digitalWrite(uint8_t pin, uint8_t val) {
+    nowNs += simCost.digitalWriteNs;
+    if (pin >= sizeof(pinLevels)) return;
+    pinLevels[pin] = val ? HIGH : LOW;
+    if (pinWriteHook) pinWriteHook(pin, pinLevels[pin]);
+}
+
+int digitalRead(uint8_t pin) {
+    nowNs += simCost.digitalReadNs;
+    if (pinReadHook) {
+        int handled = 0;
+        int level = pinReadHook(pin, &handled);
+        if (handled) return level;
+    }
+    return simPinLevel(pin);
+}
+
+unsigned long millis(void) {
+    return (unsigned long)(nowNs / 1000000ULL);
+}
+
+unsigned long micros(void) {
+    return (unsigned long)(nowNs / 1000ULL);
+}
+
+void delay(unsigned long ms) {
+    nowNs += (uint64_t)ms * 1000000ULL;
+}
+
+void delayMicroseconds(unsigned int us) {
+    nowNs += (uint64_t)us * 1000ULL;
+}
+
+#define SIM_SERIAL_TX_BUFFER 64
+
+void SimSerial::drainTx() {
+    uint64_t byteNs = 10000000000ULL / _baud;   // start + 8 data + stop bits
+    while (_txQueued && nowNs >= _txDrainNs) {
+        _txQueued--;
+        _txDrainNs += byteNs;
+    }
+}
+
+int SimSerial::availableForWrite() {
+    if (!_baud) return SIM_SERIAL_TX_BUFFER - 1;
+    drainTx();
+    return SIM_SERIAL_TX_BUFFER - 1 - _txQueued;
+}
+
+size_t SimSerial::write(uint8_t c) {
+    if (_baud) {
+        drainTx();
+        if (_txQueued >= SIM_SERIAL_TX_BUFFER - 1) {
+            // Wait for the UART to send the byte at the front
+            _txWaitNs += _txDrainNs - nowNs;
+            nowNs = _txDrainNs;
+            drainTx();
+        }
+        if (_txQueued++ == 0) _txDrainNs = nowNs + 10000000000ULL / _baud;
+    }
+    _txBytes++;
+    if (_txHook) _txHook(c);
+    if (!_muted) fputc(c, stdout);
+    return 1;
+}
+
+size_t SimSerial::write(const uint8_t *buffer, size_t size) {
+    for (size_t i = 0; i < size; i++) write(buffer[i]);
+    return size;
+}
+
+size_t SimSerial::print(const char *s) {
+    size_t n = 0;
+    while (*s) n += write((uint8_t)*s++);
+    return n;
+}
+
+size_t SimSerial::print(char c) {
+    char s[2] = {c, 0};
+    return print(s);
+}
+
+size_t SimSerial::print(long n, int base) {
+    if (base == DEC) {
+        char buf[24];
+        snprintf(buf, sizeof(buf), "%ld", n);
+        return print(buf);
+    }
+    return print((unsigned long)n, base);
+}
+
+size_t SimSerial::print(unsigned long n, int base) {
+    char buf[72];
+    char *p = &buf[sizeof(buf) - 1];
+    *p = '\0';
+    if (base < 2) base = 10;
+    do {
+        unsigned long digit = n % base;
+        *--p = (char)(digit < 10 ? '0' + digit : 'A' + digit - 10);
+        n /= base;
+    } while (n);
+    return print(p);
+}
+
+size_t SimSerial::print(double n, int digits) {
+    char buf[48];
+    snprintf(buf, sizeof(buf), "%.*f", digits, n);
+    return print(buf);
+}
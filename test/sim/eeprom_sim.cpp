@@ -0,0 +1,54 @@
+#include <string.h>
+#include "Arduino.h"
+#include "EEPROM.h"
+
+// Erase/write cycle of the ATmega328P EEPROM
+#define SIM_EEPROM_WRITE_NS 3400000ULL
+#define SIM_EEPROM_READ_NS 500
+
+EEPROMClass EEPROM;
+
+void EEPROMClass::init() {
+    if (_initialized) return;
+    erase();
+}
+
+void EEPROMClass::erase() {
+    memset(_data, 0xFF, sizeof(_data));
+    memset(_writes, 0, sizeof(_writes));
+    _totalWrites = 0;
+    _totalReads = 0;
+    _busyUntilNs = 0;
+    _waitNs = 0;
+    _initialized = true;
+}
+
+bool EEPROMClass::ready() {
+    return simNanos() >= _busyUntilNs;
+}
+
+void EEPROMClass::waitReady() {
+    uint64_t now = simNanos();
+    if (now < _busyUntilNs) {
+        _waitNs += _busyUntilNs - now;
+        simAdvanceNs(_busyUntilNs - now);
+    }
+}
+
+uint8_t EEPROMClass::read(int idx) {
+    init();
+    waitReady();
+    simAdvanceNs(SIM_EEPROM_READ_NS);
+    _totalReads++;
+    return idx >= 0 && idx < SIM_EEPROM_SIZE ? _data[idx] : 0xFF;
+}
+
+void EEPROMClass::write(int idx, uint8_t val) {
+    init();
+    if (idx < 0 || idx >= SIM_EEPROM_SIZE) return;
+    waitReady();
+    _busyUntilNs = simNanos() + SIM_EEPROM_WRITE_NS;
+    _data[idx] = val;
+    _writes[idx]++;
+    _totalWrites++;
+}
@@ -0,0 +1,47 @@
+#include "FastLED.h"
+#include "SPI.h"
+
+// WS2812B: 24 bits at 800 kHz per LED, then the >50 us latch
+#define SIM_WS2812_NS_PER_LED 30000
+#define SIM_WS2812_LATCH_NS 50000
+
+CFastLED FastLED;
+SPIClass SPI;
+
+CRGB::CRGB(const CHSV &hsv) {
+    // Plain six-sector HSV conversion, close enough for tests
+    uint8_t region = hsv.h / 43;
+    uint8_t rem = (hsv.h - region * 43) * 6;
+    uint8_t p = (hsv.v * (255 - hsv.s)) >> 8;
+    uint8_t q = (hsv.v * (255 - ((hsv.s * rem) >> 8))) >> 8;
+    uint8_t t = (hsv.v * (255 - ((hsv.s * (255 - rem)) >> 8))) >> 8;
+    switch (region) {
+        case 0:  r = hsv.v; g = t; b = p; break;
+        case 1:  r = q; g = hsv.v; b = p; break;
+        case 2:  r = p; g = hsv.v; b = t; break;
+        case 3:  r = p; g = q; b = hsv.v; break;
+        case 4:  r = t; g = p; b = hsv.v; break;
+        default: r = hsv.v; g = p; b = q; break;
+    }
+}
+
+void CLEDController::showLeds(uint8_t brightness) {
+    (void)brightness;
+    uint64_t ns = (uint64_t)_count * SIM_WS2812_NS_PER_LED + SIM_WS2812_LATCH_NS;
+    simAdvanceNs(ns);
+    FastLED.showNs += ns;
+    shows++;
+}
+
+void CFastLED::show() {
+    for (int i = 0; i < _count; i++) {
+        _controllers[i].showLeds(_brightness);
+    }
+}
+
+void CFastLED::clear(bool writeData) {
+    for (int i = 0; i < _count; i++) {
+        for (int j = 0; j < _controllers[i].size(); j++) _controllers[i].leds()[j] = CRGB();
+    }
+    if (writeData) show();
+}
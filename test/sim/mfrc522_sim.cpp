@@ -0,0 +1,431 @@
+#include "mfrc522_sim.h"
+
+// Register addresses and commands used by the model (see rfid1.h)
+#define SIM_CommandReg     0x01
+#define SIM_CommIEnReg     0x02
+#define SIM_CommIrqReg     0x04
+#define SIM_DivIrqReg      0x05
+#define SIM_ErrorReg       0x06
+#define SIM_FIFODataReg    0x09
+#define SIM_FIFOLevelReg   0x0A
+#define SIM_ControlReg     0x0C
+#define SIM_BitFramingReg  0x0D
+#define SIM_TxControlReg   0x14
+#define SIM_CRCResultRegM  0x21
+#define SIM_CRCResultRegL  0x22
+#define SIM_TModeReg       0x2A
+#define SIM_TPrescalerReg  0x2B
+#define SIM_TReloadRegH    0x2C
+#define SIM_TReloadRegL    0x2D
+#define SIM_VersionReg     0x37
+
+#define SIM_PCD_IDLE       0x00
+#define SIM_PCD_CALCCRC    0x03
+#define SIM_PCD_TRANSCEIVE 0x0C
+#define SIM_PCD_RESETPHASE 0x0F
+
+#define SIM_MODE_NONE  0
+#define SIM_MODE_READ  1
+#define SIM_MODE_WRITE 2
+
+SimMFRC522Bank simBank;
+
+// Reset values from the MFRC522 datasheet, section 9.2
+static const uint8_t resetValues[64] = {
+    0x00, 0x20, 0x80, 0x00, 0x14, 0x00, 0x00, 0x21,  // 0x00
+    0x00, 0x00, 0x00, 0x08, 0x10, 0x00, 0x80, 0x00,  // 0x08
+    0x00, 0x3F, 0x00, 0x00, 0x80, 0x00, 0x10, 0x84,  // 0x10
+    0x84, 0x4D, 0x00, 0x00, 0x62, 0x00, 0x00, 0xEB,  // 0x18
+    0x00, 0xFF, 0xFF, 0x00, 0x26, 0x00, 0x48, 0x88,  // 0x20
+    0x20, 0x20, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,  // 0x28
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x92,  // 0x30
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00   // 0x38
+};
+
+SimMFRC522::SimMFRC522()
+    : transceives(0), crcRuns(0), softResets(0), _powered(false) {
+    memset(&_card, 0, sizeof(_card));
+    powerOn();
+    _powered = false;
+}
+
+void SimMFRC522::powerOn() {
+    memcpy(_regs, resetValues, sizeof(_regs));
+    _fifoLen = 0;
+    _command = SIM_PCD_IDLE;
+    _busy = false;
+    _powered = true;
+    select();
+    fieldChanged(false);
+}
+
+void SimMFRC522::setPowered(bool powered) {
+    if (powered && !_powered) {
+        powerOn();
+    } else if (!powered) {
+        _powered = false;
+        fieldChanged(false);
+    }
+}
+
+void SimMFRC522::placeCard(const uint8_t uid[4], uint32_t responseUs) {
+    _card.present = true;
+    memcpy(_card.uid, uid, 4);
+    _card.state = SIM_CARD_IDLE;
+    _card.wokenFromHalt = false;
+    _card.writePending = false;
+    _card.responseUs = responseUs;
+}
+
+void SimMFRC522::removeCard() {
+    _card.present = false;
+}
+
+uint16_t SimMFRC522::crcA(const uint8_t *data, uint8_t len) {
+    uint16_t crc = 0x6363;
+    for (uint8_t i = 0; i < len; i++) {
+        uint8_t b = data[i] ^ (uint8_t)(crc & 0xFF);
+        b ^= (uint8_t)(b << 4);
+        crc = (crc >> 8) ^ ((uint16_t)b << 8) ^ ((uint16_t)b << 3) ^ (b >> 4);
+    }
+    return crc;
+}
+
+void SimMFRC522::select() {
+    _rises = 0;
+    _falls = 0;
+    _inShift = 0;
+    _mode = SIM_MODE_NONE;
+    _curOut = 0;
+    _nextOut = 0;
+}
+
+void SimMFRC522::clockRise(uint8_t mosi) {
+    if (!_powered) return;
+    _inShift = (uint8_t)((_inShift << 1) | (mosi ? 1 : 0));
+    _rises++;
+    if ((_rises & 7) == 0) {
+        byteDone(_inShift);
+    }
+}
+
+void SimMFRC522::clockFall() {
+    if (!_powered) return;
+    _falls++;
+    if ((_falls & 7) == 0) {
+        _curOut = _nextOut;
+        _nextOut = 0;
+    }
+}
+
+uint8_t SimMFRC522::miso() const {
+    if (!_powered) return LOW;
+    return (_curOut >> (7 - (_falls & 7))) & 0x01;
+}
+
+void SimMFRC522::byteDone(uint8_t b) {
+    if (_rises == 8) {
+        // Address byte: 1XXXXXX0 reads, 0XXXXXX0 writes
+        _addr = (b >> 1) & 0x3F;
+        if (b & 0x80) {
+            _mode = SIM_MODE_READ;
+            _nextOut = readReg(_addr);
+        } else {
+            _mode = SIM_MODE_WRITE;
+        }
+        return;
+    }
+    if (_mode == SIM_MODE_WRITE) {
+        writeReg(_addr, b);
+    } else if (_mode == SIM_MODE_READ && b != 0x00) {
+        // Consecutive reads: every further byte is the next address
+        _addr = (b >> 1) & 0x3F;
+        _nextOut = readReg(_addr);
+    }
+}
+
+uint8_t SimMFRC522::readReg(uint8_t addr) {
+    update();
+    switch (addr) {
+        case SIM_CommandReg:
+            return (uint8_t)((_regs[addr] & 0xF0) | _command);
+        case SIM_FIFODataReg: {
+            if (_fifoLen == 0) return 0;
+            uint8_t val = _fifo[0];
+            memmove(_fifo, _fifo + 1, --_fifoLen);
+            return val;
+        }
+        case SIM_FIFOLevelReg:
+            return _fifoLen;
+        default:
+            return _regs[addr];
+    }
+}
+
+void SimMFRC522::writeReg(uint8_t addr, uint8_t val) {
+    update();
+    switch (addr) {
+        case SIM_CommandReg:
+            _command = val & 0x0F;
+            _regs[addr] = val & 0x30;
+            if (_command == SIM_PCD_RESETPHASE) {
+                softResets++;
+                powerOn();
+            } else if (_command == SIM_PCD_IDLE) {
+                _busy = false;
+            } else if (_command == SIM_PCD_CALCCRC) {
+                uint16_t crc = crcA(_fifo, _fifoLen);
+                crcRuns++;
+                _fifoLen = 0;
+                _regs[SIM_CRCResultRegL] = crc & 0xFF;
+                _regs[SIM_CRCResultRegM] = crc >> 8;
+                _regs[SIM_DivIrqReg] |= 0x04;
+            } else if (_command == SIM_PCD_TRANSCEIVE && (_regs[SIM_BitFramingReg] & 0x80)) {
+                startTransceive();
+            }
+            break;
+        case SIM_CommIrqReg:
+        case SIM_DivIrqReg:
+            // Set1 selects whether the marked bits are set or cleared
+            if (val & 0x80) {
+                _regs[addr] |= (val & 0x7F);
+            } else {
+                _regs[addr] &= (uint8_t)~(val & 0x7F);
+            }
+            break;
+        case SIM_FIFOLevelReg:
+            if (val & 0x80) _fifoLen = 0;
+            break;
+        case SIM_FIFODataReg:
+            if (_fifoLen < sizeof(_fifo)) _fifo[_fifoLen++] = val;
+            break;
+        case SIM_BitFramingReg: {
+            bool startSend = (val & 0x80) && !(_regs[addr] & 0x80);
+            _regs[addr] = val;
+            if (startSend && _command == SIM_PCD_TRANSCEIVE) {
+                startTransceive();
+            }
+            break;
+        }
+        case SIM_TxControlReg: {
+            bool wasOn = (_regs[addr] & 0x03) != 0;
+            _regs[addr] = val;
+            bool isOn = (val & 0x03) != 0;
+            if (wasOn != isOn) fieldChanged(isOn);
+            break;
+        }
+        case SIM_VersionReg:
+            break;
+        default:
+            _regs[addr] = val;
+            break;
+    }
+}
+
+void SimMFRC522::fieldChanged(bool on) {
+    // Passive cards lose power with the field and come back in IDLE
+    (void)on;
+    _card.state = SIM_CARD_IDLE;
+    _card.wokenFromHalt = false;
+    _card.writePending = false;
+}
+
+uint64_t SimMFRC522::timerNs() const {
+    uint32_t prescaler = ((uint32_t)(_regs[SIM_TModeReg] & 0x0F) << 8) | _regs[SIM_TPrescalerReg];
+    uint32_t reload = ((uint32_t)_regs[SIM_TReloadRegH] << 8) | _regs[SIM_TReloadRegL];
+    // t = (2 * TPrescaler + 1) * (TReload + 1) / 13.56 MHz
+    return (uint64_t)(2 * prescaler + 1) * (reload + 1) * 1000000000ULL / 13560000ULL;
+}
+
+void SimMFRC522::startTransceive() {
+    uint8_t frame[64];
+    uint8_t len = _fifoLen;
+    uint8_t lastBits = _regs[SIM_BitFramingReg] & 0x07;
+
+    memcpy(frame, _fifo, len);
+    _fifoLen = 0;
+    transceives++;
+    _regs[SIM_CommIrqReg] |= 0x40;   // TxIRq: frame sent
+
+    bool fieldOn = (_regs[SIM_TxControlReg] & 0x03) != 0;
+    _willRespond = fieldOn && cardRespond(frame, len, lastBits);
+    _busy = true;
+    if (_willRespond) {
+        // The ATQA comes after the fixed ISO 14443 frame delay; the card's
+        // own latency only shows on the frames it has to work on
+        bool request = len == 1 && lastBits == 7;
+        uint64_t responseNs = request ? SIM_ATQA_US * 1000ULL : (uint64_t)_card.responseUs * 1000ULL;
+        _doneAtNs = simNanos() + responseNs;
+    } else if (_regs[SIM_TModeReg] & 0x80) {
+        _doneAtNs = simNanos() + timerNs();  // TAuto: timer starts after sending
+    } else {
+        _doneAtNs = UINT64_MAX;
+    }
+}
+
+void SimMFRC522::update() {
+    if (!_busy || simNanos() < _doneAtNs) return;
+    _busy = false;
+    if (_willRespond) {
+        memcpy(_fifo, _resp, _respLen);
+        _fifoLen = _respLen;
+        _regs[SIM_ControlReg] = (uint8_t)((_regs[SIM_ControlReg] & ~0x07) | _respLastBits);
+        _regs[SIM_ErrorReg] = 0;
+        _regs[SIM_CommIrqReg] |= 0x30;   // RxIRq | IdleIRq
+    } else {
+        _regs[SIM_CommIrqReg] |= 0x01;   // TimerIRq
+    }
+}
+
+void SimMFRC522::cardReject() {
+    // Any unexpected frame sends the card back to IDLE (or HALT)
+    if (_card.state == SIM_CARD_READY || _card.state == SIM_CARD_ACTIVE) {
+        _card.state = _card.wokenFromHalt ? SIM_CARD_HALT : SIM_CARD_IDLE;
+    }
+    _card.writePending = false;
+}
+
+bool SimMFRC522::cardRespond(const uint8_t *frame, uint8_t len, uint8_t lastBits) {
+    if (!_card.present) return false;
+
+    _respLen = 0;
+    _respLastBits = 0;
+
+    // REQA / WUPA short frames
+    if (len == 1 && lastBits == 7) {
+        bool wupa = frame[0] == 0x52;
+        if (frame[0] == 0x26 && _card.state == SIM_CARD_IDLE) {
+            _card.wokenFromHalt = false;
+        } else if (wupa && (_card.state == SIM_CARD_IDLE || _card.state == SIM_CARD_HALT)) {
+            _card.wokenFromHalt = _card.state == SIM_CARD_HALT;
+        } else {
+            cardReject();
+            return false;
+        }
+        _card.state = SIM_CARD_READY;
+        _resp[0] = 0x44;   // ATQA of an NTAG/Ultralight
+        _resp[1] = 0x00;
+        _respLen = 2;
+        return true;
+    }
+
+    bool crcOk = len >= 3 && crcA(frame, len - 2) == (uint16_t)(frame[len - 2] | (frame[len - 1] << 8));
+    uint8_t bcc = _card.uid[0] ^ _card.uid[1] ^ _card.uid[2] ^ _card.uid[3];
+
+    // Anticollision cascade level 1
+    if (len == 2 && frame[0] == 0x93 && frame[1] == 0x20 && _card.state == SIM_CARD_READY) {
+        memcpy(_resp, _card.uid, 4);
+        _resp[4] = bcc;
+        _respLen = 5;
+        return true;
+    }
+
+    // SELECT cascade level 1
+    if (len == 9 && frame[0] == 0x93 && frame[1] == 0x70 && crcOk &&
+        _card.state == SIM_CARD_READY && memcmp(frame + 2, _card.uid, 4) == 0 && frame[6] == bcc) {
+        _card.state = SIM_CARD_ACTIVE;
+        _resp[0] = 0x08;
+        uint16_t crc = crcA(_resp, 1);
+        _resp[1] = crc & 0xFF;
+        _resp[2] = crc >> 8;
+        _respLen = 3;
+        return true;
+    }
+
+    // HLTA never gets an answer
+    if (len == 4 && frame[0] == 0x50 && frame[1] == 0x00 && crcOk &&
+        (_card.state == SIM_CARD_READY || _card.state == SIM_CARD_ACTIVE)) {
+        _card.state = SIM_CARD_HALT;
+        return false;
+    }
+
+    // WRITE: command frame and data frame are both ACKed with 0xA (4 bits)
+    if (_card.state == SIM_CARD_ACTIVE && crcOk &&
+        ((len == 4 && frame[0] == 0xA0) || (len == 18 && _card.writePending))) {
+        _card.writePending = len == 4;
+        _resp[0] = 0x0A;
+        _respLen = 1;
+        _respLastBits = 4;
+        return true;
+    }
+
+    cardReject();
+    return false;
+}
+
+void SimMFRC522Bank::attach(uint8_t sckPin, uint8_t mosiPin, uint8_t ssPin, uint8_t rstPin,
+                            const uint8_t *misoPins, uint8_t count) {
+    if (count > SIM_MAX_CHIPS) count = SIM_MAX_CHIPS;
+    _count = count;
+    memcpy(_misoPins, misoPins, count);
+    _sckPin = sckPin;
+    _mosiPin = mosiPin;
+    _ssPin = ssPin;
+    _rstPin = rstPin;
+    _sck = simPinLevel(sckPin);
+    _ss = simPinLevel(ssPin);
+    _rst = simPinLevel(rstPin);
+    for (uint8_t i = 0; i < count; i++) {
+        _chips[i].setPowered(_rst == HIGH);
+    }
+    resetCounters();
+    simSetPinHooks(onPinWrite, onPinRead);
+}
+
+unsigned long SimMFRC522Bank::transceives() const {
+    unsigned long total = 0;
+    for (uint8_t i = 0; i < _count; i++) total += _chips[i].transceives;
+    return total;
+}
+
+void SimMFRC522Bank::resetCounters() {
+    _sckRises = 0;
+    _transactions = 0;
+    for (uint8_t i = 0; i < _count; i++) {
+        _chips[i].transceives = 0;
+        _chips[i].crcRuns = 0;
+        _chips[i].softResets = 0;
+    }
+}
+
+void SimMFRC522Bank::onPinWrite(uint8_t pin, uint8_t val) {
+    SimMFRC522Bank &bank = simBank;
+
+    if (pin == bank._rstPin) {
+        // NRSTPD low powers the chips down, the rising edge is a hard reset
+        if (val != bank._rst) {
+            for (uint8_t i = 0; i < bank._count; i++) bank._chips[i].setPowered(val == HIGH);
+        }
+        bank._rst = val;
+    }
+    if (pin == bank._ssPin) {
+        if (val != bank._ss) {
+            if (val == LOW) bank._transactions++;
+            for (uint8_t i = 0; i < bank._count; i++) bank._chips[i].select();
+        }
+        bank._ss = val;
+    }
+    if (pin == bank._sckPin) {
+        if (val != bank._sck && bank._ss == LOW) {
+            if (val == HIGH) {
+                uint8_t mosi = simPinLevel(bank._mosiPin);
+                bank._sckRises++;
+                for (uint8_t i = 0; i < bank._count; i++) bank._chips[i].clockRise(mosi);
+            } else {
+                for (uint8_t i = 0; i < bank._count; i++) bank._chips[i].clockFall();
+            }
+        }
+        bank._sck = val;
+    }
+}
+
+int SimMFRC522Bank::onPinRead(uint8_t pin, int *handled) {
+    SimMFRC522Bank &bank = simBank;
+    for (uint8_t i = 0; i < bank._count; i++) {
+        if (bank._misoPins[i] == pin) {
+            *handled = 1;
+            return bank._ss == LOW ? bank._chips[i].miso() : LOW;
+        }
+    }
+    return LOW;
+}
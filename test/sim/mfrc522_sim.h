@@ -0,0 +1,136 @@
+/**
+ * Simulated MFRC522 bank for host-side tests
+ *
+ * Models the board's reader wiring: SCK, MOSI, SS and RST are shared and
+ * every chip drives its own MISO pin. The chips are driven purely through
+ * the pin hooks of the simulated Arduino core, so the real RFID1/SOFTSPI
+ * code runs unchanged on top of it. Each chip implements the registers the
+ * driver touches (FIFO, IRQ, timer, CRC coprocessor, antenna) and talks to
+ * at most one ISO 14443A card with a configurable response latency (the
+ * ATQA always comes after the ISO frame delay).
+ */
+
+#ifndef MFRC522_SIM_H
+#define MFRC522_SIM_H
+
+#include "Arduino.h"
+
+#define SIM_MAX_CHIPS 8
+
+// From the end of REQA/WUPA until the ATQA is in the FIFO: the frame delay
+// of ISO 14443-3 (86 us) and the two ATQA bytes
+#define SIM_ATQA_US 260
+
+// ISO 14443-3 card states
+enum SimCardState {
+    SIM_CARD_IDLE = 0,
+    SIM_CARD_READY,
+    SIM_CARD_ACTIVE,
+    SIM_CARD_HALT
+};
+
+struct SimCard {
+    bool present;
+    uint8_t uid[4];
+    uint8_t state;
+    bool wokenFromHalt;     // READY*/ACTIVE* fall back to HALT, not IDLE
+    bool writePending;      // second half of a WRITE is expected
+    uint32_t responseUs;    // time from StartSend until the answer is in the FIFO (not for REQA/WUPA)
+};
+
+class SimMFRC522 {
+public:
+    SimMFRC522();
+
+    // Register state as after power-on (also used to simulate a brownout)
+    void powerOn();
+    void setPowered(bool powered);
+
+    void placeCard(const uint8_t uid[4], uint32_t responseUs = 300);
+    void removeCard();
+    SimCard &card() { return _card; }
+
+    // Register value without side effects
+    uint8_t peek(uint8_t addr) const { return _regs[addr & 0x3F]; }
+
+    // Counters
+    unsigned long transceives;   // frames sent to the card
+    unsigned long crcRuns;       // PCD_CALCCRC commands executed
+    unsigned long softResets;    // PCD_RESETPHASE commands executed
+
+    // Bus side, called by the bank
+    void select();
+    void clockRise(uint8_t mosi);
+    void clockFall();
+    uint8_t miso() const;
+
+    static uint16_t crcA(const uint8_t *data, uint8_t len);
+
+private:
+    uint8_t _regs[64];
+    uint8_t _fifo[64];
+    uint8_t _fifoLen;
+    uint8_t _command;
+    bool _powered;
+
+    // SPI transaction state
+    uint16_t _rises;
+    uint16_t _falls;
+    uint8_t _inShift;
+    uint8_t _mode;
+    uint8_t _addr;
+    uint8_t _curOut;
+    uint8_t _nextOut;
+
+    // Running transceive
+    bool _busy;
+    bool _willRespond;
+    uint64_t _doneAtNs;
+    uint8_t _resp[18];
+    uint8_t _respLen;
+    uint8_t _respLastBits;
+
+    SimCard _card;
+
+    void byteDone(uint8_t b);
+    uint8_t readReg(uint8_t addr);
+    void writeReg(uint8_t addr, uint8_t val);
+    void update();
+    void startTransceive();
+    void fieldChanged(bool on);
+    uint64_t timerNs() const;
+    bool cardRespond(const uint8_t *frame, uint8_t len, uint8_t lastBits);
+    void cardReject();
+};
+
+class SimMFRC522Bank {
+public:
+    // Connect 'count' chips to the given pins and install the pin hooks
+    void attach(uint8_t sckPin, uint8_t mosiPin, uint8_t ssPin, uint8_t rstPin,
+                const uint8_t *misoPins, uint8_t count);
+
+    SimMFRC522 &chip(uint8_t i) { return _chips[i]; }
+    uint8_t count() const { return _count; }
+
+    // Bus counters
+    unsigned long spiBytes() const { return _sckRises / 8; }
+    unsigned long spiTransactions() const { return _transactions; }
+    unsigned long transceives() const;
+    void resetCounters();
+
+    static void onPinWrite(uint8_t pin, uint8_t val);
+    static int onPinRead(uint8_t pin, int *handled);
+
+private:
+    SimMFRC522 _chips[SIM_MAX_CHIPS];
+    uint8_t _misoPins[SIM_MAX_CHIPS];
+    uint8_t _count;
+    uint8_t _sckPin, _mosiPin, _ssPin, _rstPin;
+    uint8_t _sck, _ss, _rst;
+    unsigned long _sckRises;
+    unsigned long _transactions;
+};
+
+extern SimMFRC522Bank simBank;
+
+#endif // MFRC522_SIM_H
@@ -0,0 +1,156 @@
+/**
+ * Soft-SPI Benchmark
+ *
+ * Compares the runtime-pin SOFTSPI transport (digitalWrite/digitalRead)
+ * with the compile-time FastSOFTSPI transport (direct PORTx/PINx access).
+ * Timer1 runs at the full 16 MHz clock, so the results are CPU cycles.
+ *
+ * Measured:
+ * - one byte written (writeByte) and one byte exchanged (SPI_RW)
+ * - one register read on all six readers at once (transferMulti)
+ * - one request() (REQA through toCard) on reader 1, with and without a tag
+ *
+ * Wiring: the normal board wiring. Put a tag on reader 1 for the
+ * "tag present" numbers, the rest works with an empty board.
+ */
+
+#include <Arduino.h>
+#include "BoardConfig.h"
+#include "RFID1/rfid1.h"
+#include "RFID1/rfid1_fast.h"
+
+#define BYTE_RUNS 64
+#define REQUEST_RUNS 16
+
+static const uchar misoPins[NUM_READERS] = {
+  MISO_PIN1, MISO_PIN2, MISO_PIN3, MISO_PIN4, MISO_PIN5, MISO_PIN6
+};
+
+SOFTSPI slowSpi;
+typedef FastSOFTSPI<COMMON_SCK_PIN, COMMON_MOSI_PIN,
+                    MISO_PIN1, MISO_PIN2, MISO_PIN3, MISO_PIN4, MISO_PIN5, MISO_PIN6> FastSpi;
+
+RFID1 slowReader;
+RFID1Fast<COMMON_SS_PIN, COMMON_SCK_PIN, COMMON_MOSI_PIN, MISO_PIN1> fastReader;
+
+// Timer1 free-running at clk/1, one tick per CPU cycle
+void startCycleCounter() {
+  TCCR1A = 0;
+  TCCR1B = _BV(CS10);
+}
+
+void printResult(const __FlashStringHelper* name, unsigned long slowCycles, unsigned long fastCycles) {
+  Serial.print(name);
+  Serial.print(F(": SOFTSPI "));
+  Serial.print(slowCycles);
+  Serial.print(F(" cycles, FastSOFTSPI "));
+  Serial.print(fastCycles);
+  Serial.print(F(" cycles ("));
+  Serial.print((float)slowCycles / (fastCycles ? fastCycles : 1), 1);
+  Serial.println(F("x)"));
+}
+
+unsigned long cyclesWriteByteSlow() {
+  uint16_t start = TCNT1;
+  slowSpi.writeByte(0xA5);
+  return (uint16_t)(TCNT1 - start);
+}
+
+unsigned long cyclesWriteByteFast() {
+  uint16_t start = TCNT1;
+  FastSpi::writeByte(0xA5);
+  return (uint16_t)(TCNT1 - start);
+}
+
+unsigned long cyclesRwSlow() {
+  uint16_t start = TCNT1;
+  slowSpi.SPI_RW(0x5A);
+  return (uint16_t)(TCNT1 - start);
+}
+
+unsigned long cyclesRwFast() {
+  uint16_t start = TCNT1;
+  FastSpi::SPI_RW(0x5A);
+  return (uint16_t)(TCNT1 - start);
+}
+
+unsigned long cyclesMultiSlow() {
+  uchar vals[NUM_READERS];
+  uint16_t start = TCNT1;
+  slowSpi.transferMulti(0x00, vals);
+  return (uint16_t)(TCNT1 - start);
+}
+
+unsigned long cyclesMultiFast() {
+  uchar vals[NUM_READERS];
+  uint16_t start = TCNT1;
+  FastSpi::transferMulti(0x00, vals);
+  return (uint16_t)(TCNT1 - start);
+}
+
+// Average over BYTE_RUNS calls; interrupts off so millis() does not skew it
+unsigned long averageCycles(unsigned long (*run)()) {
+  unsigned long total = 0;
+  noInterrupts();
+  for (int i = 0; i < BYTE_RUNS; i++) {
+    total += run();
+  }
+  interrupts();
+  return total / BYTE_RUNS;
+}
+
+// request() includes the chip's answer time, so this uses micros()
+unsigned long requestCycles(RFID1& reader, uchar* okCount) {
+  uchar str[MAX_LEN];
+  unsigned long total = 0;
+  *okCount = 0;
+  for (int i = 0; i < REQUEST_RUNS; i++) {
+    unsigned long start = micros();
+    if (reader.request(PICC_REQALL, str) == MI_OK) (*okCount)++;
+    total += micros() - start;
+  }
+  return total / REQUEST_RUNS * (F_CPU / 1000000UL);
+}
+
+void setup() {
+  Serial.begin(9600);
+  while (!Serial && millis() < 3000);
+
+  Serial.println(F("Soft-SPI Benchmark"));
+
+  slowSpi.beginMulti(COMMON_SS_PIN, COMMON_SCK_PIN, COMMON_MOSI_PIN, misoPins, NUM_READERS);
+  FastSpi::begin();
+
+  slowReader.begin(COMMON_SS_PIN, COMMON_SCK_PIN, COMMON_MOSI_PIN, MISO_PIN1, COMMON_SS_PIN, COMMON_RST_PIN);
+  fastReader.begin(COMMON_SS_PIN, COMMON_SCK_PIN, COMMON_MOSI_PIN, MISO_PIN1, COMMON_SS_PIN, COMMON_RST_PIN);
+  slowReader.init();
+  delay(50);
+
+  startCycleCounter();
+
+  Serial.println(F("\nPer byte (average cycles):"));
+  printResult(F("writeByte"), averageCycles(cyclesWriteByteSlow), averageCycles(cyclesWriteByteFast));
+  printResult(F("SPI_RW"), averageCycles(cyclesRwSlow), averageCycles(cyclesRwFast));
+  printResult(F("transferMulti (6 MISO)"), averageCycles(cyclesMultiSlow), averageCycles(cyclesMultiFast));
+
+  uchar slowOk, fastOk;
+  unsigned long slowReq = requestCycles(slowReader, &slowOk);
+  unsigned long fastReq = requestCycles(fastReader, &fastOk);
+
+  Serial.print(F("\nPer request()/toCard on reader 1 ("));
+  Serial.print(slowOk);
+  Serial.print(F("/"));
+  Serial.print(fastOk);
+  Serial.print(F(" of "));
+  Serial.print(REQUEST_RUNS);
+  Serial.println(F(" answered):"));
+  printResult(F("request"), slowReq, fastReq);
+  if (slowOk == 0 && fastOk == 0) {
+    Serial.println(F("No tag on reader 1 - both numbers include the chip's timeout"));
+  }
+
+  Serial.println(F("\n=== Benchmark Complete ==="));
+}
+
+void loop() {
+}
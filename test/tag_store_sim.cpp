@@ -0,0 +1,203 @@
+/**
+ * EEPROM Tag Store Test (host)
+ *
+ * Runs TagStore on the simulated 1 KB EEPROM of the Uno:
+ * - a new chip is formatted, a damaged header formats the store again
+ * - a full store of TAG_STORE_MAX_TAGS tags survives a reset
+ * - lookups of stored and of unknown UIDs, in EEPROM reads per lookup
+ * - a record torn by a reset, anywhere in a chain, hides no other tag,
+ *   and registering its tag again reuses the torn slot
+ * - re-registering a tag rewrites only the bytes that change, and
+ *   registering never touches the header
+ * - registered tags override the built-in ones in PlantDatabase
+ * - wear: 200 provisioning rounds (clear, then 40 new tags), with the
+ *   most written cell against the rounds
+ *
+ * Build and run with: pio run -e tag_store_sim && .pio/build/tag_store_sim/program
+ */
+
+#include <stdio.h>
+#include "Arduino.h"
+#include "EEPROM.h"
+#include "PlantDatabase.h"
+#include "TagStore.h"
+
+#define WEAR_ROUNDS 200
+#define WEAR_TAGS 40
+
+static int failures = 0;
+
+static void check(bool ok, const char *what) {
+    if (!ok) {
+        printf("  FAIL %s\n", what);
+        failures++;
+    }
+}
+
+// Distinct UIDs that look like NTAG ones (04 xx xx xx); 'set' picks another
+// batch of tags
+static void makeUid(uint16_t n, uint8_t set, uint8_t *uid) {
+    uint32_t x = (n + 1) * 2654435761UL ^ (uint32_t)set * 0x9E3779B9UL;
+    uid[0] = 0x04;
+    uid[1] = x >> 8;
+    uid[2] = x >> 16;
+    uid[3] = (x >> 24) | 0x01;   // never one of the built-in tags (xx 3B)
+    if (uid[3] == 0x3B) uid[3] = 0x3D;
+}
+
+static uint8_t plantFor(uint16_t n) {
+    return 1 + n % (NUM_PLANTS - 1);
+}
+
+static bool allFound(uint8_t set, uint16_t count) {
+    uint8_t uid[4];
+    uint8_t plantId;
+    for (uint16_t n = 0; n < count; n++) {
+        makeUid(n, set, uid);
+        if (!TagStore::lookup(uid, &plantId) || plantId != plantFor(n)) return false;
+    }
+    return true;
+}
+
+static uint16_t countFound(uint8_t set, uint16_t count) {
+    uint8_t uid[4];
+    uint8_t plantId;
+    uint16_t found = 0;
+    for (uint16_t n = 0; n < count; n++) {
+        makeUid(n, set, uid);
+        if (TagStore::lookup(uid, &plantId) && plantId == plantFor(n)) found++;
+    }
+    return found;
+}
+
+// Slots holding a record, torn or not (erased slots read 0xFF)
+static uint16_t recordSlots() {
+    uint16_t records = 0;
+    for (uint8_t slot = 0; slot < TAG_STORE_SLOTS; slot++) {
+        if (EEPROM.read(TAG_STORE_HEADER_SIZE + slot * TAG_STORE_RECORD_SIZE + 5) != 0xFF) records++;
+    }
+    return records;
+}
+
+int main() {
+    uint8_t uid[4];
+    uint8_t plantId;
+
+    // A new chip
+    Serial.setMuted(true);
+    TagStore::begin();
+    check(TagStore::count() == 0, "new store is empty");
+    check(EEPROM.read(0) == 'T' && EEPROM.read(1) == 'G', "new chip formatted");
+
+    // A full store
+    for (uint16_t n = 0; n < TAG_STORE_MAX_TAGS; n++) {
+        makeUid(n, 0, uid);
+        if (!TagStore::store(uid, plantFor(n))) {
+            printf("  FAIL tag %u did not fit\n", n);
+            failures++;
+        }
+    }
+    makeUid(TAG_STORE_MAX_TAGS, 0, uid);
+    check(!TagStore::store(uid, 1), "a tag beyond TAG_STORE_MAX_TAGS is refused");
+    check(TagStore::count() == TAG_STORE_MAX_TAGS, "count of a full store");
+
+    // Lookups in the full store
+    unsigned long readsBefore = EEPROM.totalReads();
+    check(allFound(0, TAG_STORE_MAX_TAGS), "every stored tag found with its plant");
+    double hitReads = (double)(EEPROM.totalReads() - readsBefore) / TAG_STORE_MAX_TAGS;
+
+    readsBefore = EEPROM.totalReads();
+    unsigned long falseHits = 0;
+    for (uint16_t n = 0; n < 1000; n++) {
+        makeUid(n, 99, uid);
+        if (TagStore::lookup(uid, &plantId)) falseHits++;
+    }
+    double missReads = (EEPROM.totalReads() - readsBefore) / 1000.0;
+    check(falseHits == 0, "unknown tags not found");
+    printf("%d tags in %d slots: %.1f EEPROM reads per found tag, %.1f per unknown tag\n",
+           TAG_STORE_MAX_TAGS, TAG_STORE_SLOTS, hitReads, missReads);
+
+    // Reset
+    TagStore::begin();
+    check(TagStore::count() == TAG_STORE_MAX_TAGS && allFound(0, TAG_STORE_MAX_TAGS), "store survives a reset");
+
+    // Tear each record in turn (its CRC never written), reset, and register
+    // all tags again, latest first: the tags behind the torn record in its
+    // chain come before the torn tag
+    unsigned long hidden = 0;
+    unsigned long notReused = 0;
+    for (uint8_t slot = 0; slot < TAG_STORE_SLOTS; slot++) {
+        int crcAddress = TAG_STORE_HEADER_SIZE + slot * TAG_STORE_RECORD_SIZE + TAG_STORE_RECORD_SIZE - 1;
+        if (EEPROM.read(crcAddress - 1) == 0xFF) continue;
+        uint8_t crc = EEPROM.read(crcAddress);
+        EEPROM.corrupt(crcAddress, crc ^ 0x5A);
+        TagStore::begin();
+        if (countFound(0, TAG_STORE_MAX_TAGS) != TAG_STORE_MAX_TAGS - 1) hidden++;
+        for (uint16_t n = TAG_STORE_MAX_TAGS; n-- > 0;) {
+            makeUid(n, 0, uid);
+            TagStore::store(uid, plantFor(n));
+        }
+        if (EEPROM.read(crcAddress) != crc || recordSlots() != TAG_STORE_MAX_TAGS) notReused++;
+    }
+    check(hidden == 0, "a torn record hides other tags of its chain");
+    check(notReused == 0, "registering a torn tag again writes a second copy");
+    check(TagStore::count() == TAG_STORE_MAX_TAGS && allFound(0, TAG_STORE_MAX_TAGS), "store whole after the torn records");
+
+    // Re-registering writes only the plant and the CRC; the header is left alone
+    unsigned long headerWrites = EEPROM.cellWrites(4) + EEPROM.cellWrites(5);
+    unsigned long writesBefore = EEPROM.totalWrites();
+    makeUid(7, 0, uid);
+    check(TagStore::store(uid, plantFor(7) + 1) && TagStore::lookup(uid, &plantId) && plantId == plantFor(7) + 1,
+          "re-registered tag has its new plant");
+    printf("re-registering a tag: %lu bytes written\n", EEPROM.totalWrites() - writesBefore);
+    check(EEPROM.totalWrites() - writesBefore <= 2, "re-registering rewrites at most plant and CRC");
+    TagStore::store(uid, plantFor(7));
+    check(EEPROM.cellWrites(4) + EEPROM.cellWrites(5) == headerWrites, "registering does not write the header");
+
+    // A damaged header formats the store
+    EEPROM.corrupt(5, EEPROM.read(5) ^ 0x10);
+    TagStore::begin();
+    check(TagStore::count() == 0, "damaged header formats the store");
+    makeUid(0, 0, uid);
+    check(!TagStore::lookup(uid, &plantId), "formatted store has no tags");
+
+    // Through PlantDatabase: a registered tag overrides a built-in one
+    uint8_t tomatoTag[4] = {0x04, 0x53, 0x45, 0x3B};
+    PlantID builtin = PlantDatabase::identifyPlantByTag(tomatoTag);
+    check(PlantDatabase::registerTag(tomatoTag, CUCUMBER) && PlantDatabase::identifyPlantByTag(tomatoTag) == CUCUMBER,
+          "registered tag overrides the built-in one");
+    check(!PlantDatabase::registerTag(tomatoTag, NUM_PLANTS), "plant ID out of range refused");
+    TagStore::clear();
+    check(PlantDatabase::identifyPlantByTag(tomatoTag) == builtin, "built-in tag back after clear");
+
+    // Wear over many provisioning rounds
+    EEPROM.erase();
+    TagStore::begin();
+    for (uint8_t round = 0; round < WEAR_ROUNDS; round++) {
+        TagStore::clear();
+        for (uint16_t n = 0; n < WEAR_TAGS; n++) {
+            makeUid(n, round, uid);
+            TagStore::store(uid, plantFor(n));
+        }
+        if (!allFound(round, WEAR_TAGS)) {
+            printf("  FAIL round %d: tags missing\n", round);
+            failures++;
+            break;
+        }
+    }
+    unsigned long hottestRecord = 0;
+    for (int i = TAG_STORE_HEADER_SIZE; i < TAG_STORE_HEADER_SIZE + TAG_STORE_SLOTS * TAG_STORE_RECORD_SIZE; i++) {
+        if (EEPROM.cellWrites(i) > hottestRecord) hottestRecord = EEPROM.cellWrites(i);
+    }
+    unsigned long hottestHeader = 0;
+    for (int i = 0; i < TAG_STORE_HEADER_SIZE; i++) {
+        if (EEPROM.cellWrites(i) > hottestHeader) hottestHeader = EEPROM.cellWrites(i);
+    }
+    printf("%d rounds of %d tags: %lu bytes written, most written record cell %lu, header cell %lu\n",
+           WEAR_ROUNDS, WEAR_TAGS, EEPROM.totalWrites(), hottestRecord, hottestHeader);
+    check(hottestRecord < WEAR_ROUNDS / 2, "record cells wear less than once every other round");
+    check(hottestHeader <= WEAR_ROUNDS + 1, "header written once per round at most");
+
+    printf(failures ? "FAILED (%d)\n" : "OK\n", failures);
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,176 @@
+/**
+ * Binary Telemetry Simulation (host)
+ *
+ * Runs the real BoardController at SERIAL_BAUD with telemetry switched on,
+ * captures everything written to the serial port and feeds it through the
+ * same TelemetryDecoder the host tool uses. Six registered tags are placed
+ * one after the other in neighbors mode, then taken off again. Checks that:
+ * - the stream starts with a HELLO frame and has no bad frames
+ * - every placement arrives as TAG_PLACED with its UID and plant
+ * - every placement produces VERDICT frames
+ * - every removal arrives as TAG_REMOVED
+ * - LOOP_STATS and ERRORS come once per second
+ * - ERRORS counters past 65535 arrive as 65535, not wrapped
+ * - no frame is dropped and the board never waits for the port
+ * It also reports the frame bytes against the log text per placement.
+ *
+ * Build and run with: pio run -e telemetry_sim && .pio/build/telemetry_sim/program
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "Arduino.h"
+#include "BoardConfig.h"
+#include "BoardController.h"
+#include "PlantDatabase.h"
+#include "Telemetry.h"
+#include "mfrc522_sim.h"
+
+static const uint8_t misoPins[NUM_READERS] = {
+    MISO_PIN1, MISO_PIN2, MISO_PIN3, MISO_PIN4, MISO_PIN5, MISO_PIN6
+};
+
+// Tags registered in PlantDatabase (tomato, cucumber, potato, carrot, onion, pea)
+static const uint8_t cardUids[NUM_READERS][4] = {
+    {0x04, 0x53, 0x45, 0x3B}, {0x04, 0x5B, 0x2B, 0x3B}, {0x04, 0xDA, 0x41, 0x3B},
+    {0x04, 0xFF, 0x33, 0x3B}, {0x04, 0xCC, 0x25, 0x3B}, {0x04, 0xBD, 0x1B, 0x3B}
+};
+
+static BoardController garden;
+static TelemetryDecoder decoder;
+static int failures = 0;
+
+// What the decoder saw
+static unsigned long frameCount[NUM_TELEMETRY_TYPES];
+static unsigned long frameBytes;
+static unsigned long textBytes;
+static bool helloFirst;
+static bool placedSeen[NUM_READERS];
+static bool removedSeen[NUM_READERS];
+static unsigned long lastUpdatesPerSecond;
+static unsigned long longestUpdateMicros;
+static uint16_t lastReinits;
+static uint16_t lastLogDropped;
+
+static void check(bool ok, const char *what) {
+    if (!ok) {
+        printf("  FAIL %s\n", what);
+        failures++;
+    }
+}
+
+static void onFrame() {
+    const uint8_t *p = decoder.payload;
+    if (decoder.frames == 1) {
+        helloFirst = decoder.type == TELEMETRY_HELLO && p[0] == TELEMETRY_VERSION && p[1] == NUM_READERS;
+    }
+    if (decoder.type < NUM_TELEMETRY_TYPES) frameCount[decoder.type]++;
+    frameBytes += decoder.length + TELEMETRY_FRAME_OVERHEAD;
+
+    switch (decoder.type) {
+        case TELEMETRY_TAG_PLACED: {
+            uint8_t reader = p[0] - 1;
+            if (reader >= NUM_READERS) break;
+            PlantID expected = PlantDatabase::identifyPlantByTag((byte *)cardUids[reader]);
+            if (memcmp(&p[1], cardUids[reader], 4) == 0 && p[5] == expected) {
+                placedSeen[reader] = true;
+            }
+            break;
+        }
+        case TELEMETRY_TAG_REMOVED:
+            if (p[0] >= 1 && p[0] <= NUM_READERS) removedSeen[p[0] - 1] = true;
+            break;
+        case TELEMETRY_LOOP_STATS: {
+            lastUpdatesPerSecond = telemetryU16(&p[0]);
+            uint32_t maxMicros = telemetryU32(&p[2]);
+            if (maxMicros > longestUpdateMicros) longestUpdateMicros = maxMicros;
+            break;
+        }
+        case TELEMETRY_ERRORS:
+            lastReinits = telemetryU16(&p[0]);
+            lastLogDropped = telemetryU16(&p[2]);
+            break;
+    }
+}
+
+static void onTx(uint8_t c) {
+    switch (decoder.feed(c)) {
+        case TelemetryDecoder::FRAME: onFrame(); break;
+        case TelemetryDecoder::TEXT: textBytes++; break;
+        default: break;
+    }
+}
+
+static void runFor(unsigned long ms) {
+    unsigned long end = millis() + ms;
+    while (millis() < end) {
+        garden.update();
+        delay(10);
+    }
+}
+
+int main() {
+    simBank.attach(COMMON_SCK_PIN, COMMON_MOSI_PIN, COMMON_SS_PIN, COMMON_RST_PIN, misoPins, NUM_READERS);
+    Serial.setMuted(true);
+    Serial.begin(SERIAL_BAUD);
+
+    garden.begin();
+    garden.changeGameMode();    // neighbors mode
+    runFor(2000);               // let the startup output go out
+
+    Serial.setTxHook(onTx);
+    Telemetry::setEnabled(true);
+    uint64_t waitBefore = Serial.txWaitNs();
+
+    printf("Telemetry at %lu baud, six tags placed 500 ms apart\n", (unsigned long)SERIAL_BAUD);
+    for (uint8_t i = 0; i < NUM_READERS; i++) {
+        simBank.chip(i).placeCard(cardUids[i]);
+        runFor(500);
+    }
+    runFor(2000);
+    unsigned long placeFrameBytes = frameBytes;
+    unsigned long placeTextBytes = textBytes;
+
+    for (uint8_t i = 0; i < NUM_READERS; i++) {
+        simBank.chip(i).removeCard();
+    }
+    runFor(3000);
+    double waitMs = (Serial.txWaitNs() - waitBefore) / 1e6;
+
+    printf("%lu frames (%lu bad), per type:", decoder.frames, decoder.badFrames);
+    for (uint8_t t = 0; t < NUM_TELEMETRY_TYPES; t++) printf(" %lu", frameCount[t]);
+    printf("\n");
+    printf("per placement: %lu frame bytes, %lu log text bytes\n",
+           placeFrameBytes / NUM_READERS, placeTextBytes / NUM_READERS);
+    printf("updates/s %lu, longest update() %lu us, frames dropped %lu, waited for serial %.1f ms\n",
+           lastUpdatesPerSecond, longestUpdateMicros, Telemetry::getDropped(), waitMs);
+
+    check(helloFirst, "stream does not start with HELLO");
+    check(decoder.badFrames == 0, "bad frames in the stream");
+    for (uint8_t i = 0; i < NUM_READERS; i++) {
+        if (!placedSeen[i]) {
+            printf("  FAIL reader %d: no TAG_PLACED with its UID and plant\n", i + 1);
+            failures++;
+        }
+        if (!removedSeen[i]) {
+            printf("  FAIL reader %d: no TAG_REMOVED\n", i + 1);
+            failures++;
+        }
+    }
+    check(frameCount[TELEMETRY_VERDICT] >= NUM_READERS, "fewer VERDICT frames than placements");
+    // 8 s of capture: one LOOP_STATS and ERRORS frame per second
+    check(frameCount[TELEMETRY_LOOP_STATS] >= 7 && frameCount[TELEMETRY_LOOP_STATS] <= 9,
+          "LOOP_STATS not once per second");
+    check(frameCount[TELEMETRY_ERRORS] == frameCount[TELEMETRY_LOOP_STATS], "ERRORS not sent with LOOP_STATS");
+    check(lastUpdatesPerSecond > 0, "LOOP_STATS without updates");
+    check(Telemetry::getDropped() == 0, "frames dropped");
+    check(waitMs == 0, "the board waited for the serial port");
+
+    // Counters too big for their 16-bit fields
+    Telemetry::errors(70000UL, 0x10001UL);
+    runFor(100);
+    check(lastReinits == 0xFFFF && lastLogDropped == 0xFFFF, "ERRORS counters wrapped instead of stopping at 65535");
+
+    printf(failures ? "FAILED (%d)\n" : "OK\n", failures);
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,159 @@
+/**
+ * Telemetry decoder (host)
+ *
+ * Prints the binary telemetry frames of the board (lib/TelemetryProtocol.h),
+ * one event per line, either live from the serial port or from a capture:
+ *
+ *   telemetry_decode /dev/ttyACM0          live, port set to 115200 8N1 raw
+ *   telemetry_decode capture.bin           a file, e.g. cat /dev/ttyACM0 > capture.bin
+ *   telemetry_decode --text /dev/ttyACM0   also pass the log text through
+ *
+ * Send "telemetry on" to the board to start the frames. On exit (end of
+ * file or Ctrl+C) it prints the number of frames and of bad frames.
+ *
+ * Build with: pio run -e telemetry_decode
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <stdio.h>
+#include <string.h>
+#include <termios.h>
+#include <unistd.h>
+#include "TelemetryProtocol.h"
+
+static const char *const typeNames[NUM_TELEMETRY_TYPES] = {
+    "HELLO", "TAG_PLACED", "TAG_REMOVED", "VERDICT", "LOOP_STATS", "ERRORS"
+};
+
+// Same order as ReaderVerdict and GameMode in BoardController.h
+static const char *const verdictNames[] = {"none", "neutral", "likes", "dislikes"};
+static const char *const modeNames[] = {"environment", "neighbors", "combined"};
+
+static volatile sig_atomic_t stop = 0;
+
+static void onSignal(int) {
+    stop = 1;
+}
+
+static const char *nameOf(const char *const *names, size_t count, uint8_t value) {
+    return value < count ? names[value] : "?";
+}
+
+static void printFrame(const TelemetryDecoder &d) {
+    const uint8_t *p = d.payload;
+    const char *name = d.type < NUM_TELEMETRY_TYPES ? typeNames[d.type] : "UNKNOWN";
+    printf("%-11s ", name);
+
+    switch (d.type) {
+        case TELEMETRY_HELLO:
+            if (d.length < 2) break;
+            printf("version %u, %u readers", p[0], p[1]);
+            if (p[0] != TELEMETRY_VERSION) printf(" (decoder speaks version %u)", TELEMETRY_VERSION);
+            break;
+        case TELEMETRY_TAG_PLACED:
+            if (d.length < 6) break;
+            printf("reader %u, UID %02X %02X %02X %02X, plant %u", p[0], p[1], p[2], p[3], p[4], p[5]);
+            break;
+        case TELEMETRY_TAG_REMOVED:
+            if (d.length < 1) break;
+            printf("reader %u", p[0]);
+            break;
+        case TELEMETRY_VERDICT:
+            if (d.length < 3) break;
+            printf("reader %u, %s (%s mode)", p[0],
+                   nameOf(verdictNames, sizeof(verdictNames) / sizeof(verdictNames[0]), p[1]),
+                   nameOf(modeNames, sizeof(modeNames) / sizeof(modeNames[0]), p[2]));
+            break;
+        case TELEMETRY_LOOP_STATS:
+            if (d.length < 8) break;
+            printf("%u updates/s, longest %lu us, %u shows/s", telemetryU16(&p[0]),
+                   (unsigned long)telemetryU32(&p[2]), telemetryU16(&p[6]));
+            break;
+        case TELEMETRY_ERRORS:
+            if (d.length < 6) break;
+            printf("%u reader reinits, %u log lines dropped, %u frames dropped",
+                   telemetryU16(&p[0]), telemetryU16(&p[2]), telemetryU16(&p[4]));
+            break;
+        default:
+            for (uint8_t i = 0; i < d.length; i++) printf("%02X ", p[i]);
+            break;
+    }
+    printf("\n");
+}
+
+// Raw 115200 8N1, so no byte of a frame is translated or swallowed
+static bool setupPort(int fd) {
+    struct termios tio;
+    if (tcgetattr(fd, &tio) != 0) return false;
+    cfmakeraw(&tio);
+    cfsetispeed(&tio, B115200);
+    cfsetospeed(&tio, B115200);
+    tio.c_cflag |= CLOCAL | CREAD;
+    tio.c_cc[VMIN] = 1;
+    tio.c_cc[VTIME] = 0;
+    return tcsetattr(fd, TCSANOW, &tio) == 0;
+}
+
+int main(int argc, char **argv) {
+    bool showText = false;
+    const char *path = NULL;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--text") == 0) showText = true;
+        else path = argv[i];
+    }
+    if (!path) {
+        fprintf(stderr, "usage: %s [--text] <serial port | capture file>\n", argv[0]);
+        return 2;
+    }
+
+    int fd = open(path, O_RDONLY | O_NOCTTY);
+    if (fd < 0) {
+        fprintf(stderr, "%s: %s\n", path, strerror(errno));
+        return 1;
+    }
+    if (isatty(fd) && !setupPort(fd)) {
+        fprintf(stderr, "%s: cannot set up the port: %s\n", path, strerror(errno));
+        return 1;
+    }
+
+    // No SA_RESTART, so Ctrl+C also ends a read() waiting for the port
+    struct sigaction action;
+    memset(&action, 0, sizeof(action));
+    action.sa_handler = onSignal;
+    sigaction(SIGINT, &action, NULL);
+    setvbuf(stdout, NULL, _IOLBF, 0);
+
+    TelemetryDecoder decoder;
+    uint8_t buffer[256];
+    while (!stop) {
+        ssize_t n = read(fd, buffer, sizeof(buffer));
+        if (n == 0) break;
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            fprintf(stderr, "%s: %s\n", path, strerror(errno));
+            break;
+        }
+
+        for (ssize_t i = 0; i < n; i++) {
+            switch (decoder.feed(buffer[i])) {
+                case TelemetryDecoder::FRAME:
+                    printFrame(decoder);
+                    break;
+                case TelemetryDecoder::BAD_FRAME:
+                    printf("(bad frame)\n");
+                    break;
+                case TelemetryDecoder::TEXT:
+                    if (showText) putchar(buffer[i]);
+                    break;
+                default:
+                    break;
+            }
+        }
+    }
+
+    close(fd);
+    fprintf(stderr, "%lu frames, %lu bad\n", decoder.frames, decoder.badFrames);
+    return 0;
+}
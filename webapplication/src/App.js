@@ -4,9 +4,11 @@ import { plantDatabase } from './models/PlantDatabase';
 import { GAME_MODE, ENVIRONMENT } from './models/constants';
 import { 
   ESP_CONFIG, 
-  getLedSegmentForGrid, 
+  buildLedFrame, 
+  sendLedFrame, 
+  sendLedUpdate, 
+  sendCellEffect, 
   statusToColor, 
-  sendLedCommand, 
   clearAllLeds 
 } from './models/LedConfig';
 import './App.css';
@@ -33,10 +35,7 @@ function App() {
     if (newState) {
       setInfoContent(`<p>ESP LED control enabled. Connected to ${espIpAddress}</p>`);
       // Update all LEDs based on current evaluations
-      Object.entries(evaluations).forEach(([plantId, evaluation]) => {
-        const { row, col, status } = evaluation;
-        updateEspLed(row, col, status);
-      });
+      sendLedFrame(buildLedFrame(evaluations));
     } else {
       setInfoContent(`<p>ESP LED control disabled.</p>`);
       // Clear all LEDs when disabling
@@ -51,17 +50,6 @@ function App() {
     ESP_CONFIG.ipAddress = newIp;
   };
 
-  // Send LED update to ESP controller
-  const updateEspLed = (row, col, status) => {
-    if (!espEnabled) return;
-    
-    const segment = getLedSegmentForGrid(row, col);
-    const color = statusToColor(status);
-    
-    // Send command to ESP
-    sendLedCommand(segment, color);
-  };
-
   // Create a grid cell component
   const GridCell = ({ row, col }) => {
     const cell = boardController.getGridCell(row, col);
@@ -256,8 +244,11 @@ function App() {
     const evaluation = boardController.evaluatePlant(plantId);
     showPlantEvaluation(evaluation);
     
-    // Update ESP LED if enabled
-    updateEspLed(row, col, evaluation.status);
+    // Let the placed cell pulse three times in its status color, like the
+    // board does for a placed tag
+    if (espEnabled && evaluation.status !== 'error') {
+      sendCellEffect(row, col, 'pulse', statusToColor(evaluation.status), 3);
+    }
   };
 
   // Update evaluations for all plants on the grid
@@ -265,11 +256,9 @@ function App() {
     const newEvaluations = boardController.evaluateAllPlants();
     setEvaluations(newEvaluations);
     
-    // Update ESP LEDs for all plants
+    // Update the ESP LEDs of the cells that changed
     if (espEnabled) {
-      Object.entries(newEvaluations).forEach(([plantId, evaluation]) => {
-        updateEspLed(evaluation.row, evaluation.col, evaluation.status);
-      });
+      sendLedUpdate(buildLedFrame(newEvaluations));
     }
   };
 
@@ -7,7 +7,12 @@ export const ESP_CONFIG = {
   enabled: false,        // Whether to send LED control commands to ESP
   ipAddress: '192.168.4.1', // Default IP of the ESP access point
   port: 80,              // Default port
-  endpoint: '/api/led'   // LED control endpoint
+  endpoint: '/api/led',  // LED control endpoint
+  batchEndpoint: '/api/batch', // Several LED ranges, shown once
+  frameEndpoint: '/api/frame', // Full-frame endpoint (raw RGB bytes)
+  effectEndpoint: '/api/effect', // Effects rendered on the ESP
+  deltaEndpoint: '/api/delta', // Changed LEDs only, with a sequence number
+  numLeds: 72            // LEDs on the strip
 };
 
 // Maps each grid position [row, col] to a range of LEDs on the strip
@@ -124,10 +129,183 @@ export const sendLedCommand = async (segment, color) => {
   }
 };
 
+// Send several LED ranges ([{ start, end, color }], up to 36) in one
+// request; the ESP applies all of them or none and shows them once
+export const sendLedBatch = async (ranges) => {
+  if (!ESP_CONFIG.enabled) return;
+  
+  try {
+    const url = `http://${ESP_CONFIG.ipAddress}:${ESP_CONFIG.port}${ESP_CONFIG.batchEndpoint}`;
+    
+    const response = await fetch(url, {
+      method: 'POST',
+      headers: {
+        'Content-Type': 'application/json',
+      },
+      body: JSON.stringify(ranges),
+    });
+    
+    if (!response.ok) {
+      console.error('Error controlling LEDs:', await response.text());
+    }
+    
+    return await response.json();
+  } catch (error) {
+    console.error('Failed to send LED batch:', error);
+  }
+};
+
+// Build a full LED frame (3 bytes of RGB per LED) from the plant evaluations;
+// cells without a plant are off
+export const buildLedFrame = (evaluations) => {
+  const frame = new Uint8Array(ESP_CONFIG.numLeds * 3);
+  Object.values(evaluations).forEach(({ row, col, status }) => {
+    const segment = getLedSegmentForGrid(row, col);
+    const { r, g, b } = statusToColor(status);
+    for (let led = segment.start; led <= segment.end; led++) {
+      frame.set([r, g, b], led * 3);
+    }
+  });
+  return frame;
+};
+
+// The frame the ESP shows as far as the web app knows (null: unknown), the
+// newest frame sent, and the sequence number of the last delta
+let shownFrame = null;
+let latestFrame = null;
+let deltaSequence = 0;
+
+// Send a whole LED frame to the ESP in one request; offset is the first LED
+export const sendLedFrame = async (frame, offset = 0) => {
+  if (!ESP_CONFIG.enabled) return;
+  
+  if (offset === 0 && frame.length === ESP_CONFIG.numLeds * 3) {
+    shownFrame = frame.slice();
+    latestFrame = shownFrame;
+  } else {
+    shownFrame = null;
+  }
+  
+  try {
+    const url = `http://${ESP_CONFIG.ipAddress}:${ESP_CONFIG.port}${ESP_CONFIG.frameEndpoint}?offset=${offset}`;
+    
+    const response = await fetch(url, {
+      method: 'POST',
+      headers: {
+        'Content-Type': 'application/octet-stream',
+      },
+      body: frame,
+    });
+    
+    if (!response.ok) {
+      console.error('Error sending LED frame:', await response.text());
+    }
+    
+    return await response.json();
+  } catch (error) {
+    console.error('Failed to send LED frame:', error);
+    shownFrame = null;
+  }
+};
+
+// The LEDs that differ between two frames as runs of one color, 5 bytes
+// each: first LED, count, r, g, b
+export const buildLedRuns = (frame, shown) => {
+  const runs = [];
+  const numLeds = frame.length / 3;
+  let led = 0;
+  while (led < numLeds) {
+    const i = led * 3;
+    if (frame[i] === shown[i] && frame[i + 1] === shown[i + 1] && frame[i + 2] === shown[i + 2]) {
+      led++;
+      continue;
+    }
+    let count = 1;
+    while (led + count < numLeds && count < 255) {
+      const j = (led + count) * 3;
+      const changed = frame[j] !== shown[j] || frame[j + 1] !== shown[j + 1] || frame[j + 2] !== shown[j + 2];
+      if (!changed || frame[j] !== frame[i] || frame[j + 1] !== frame[i + 1] || frame[j + 2] !== frame[i + 2]) break;
+      count++;
+    }
+    runs.push(led, count, frame[i], frame[i + 1], frame[i + 2]);
+    led += count;
+  }
+  return runs;
+};
+
+// Bring the ESP's LEDs to a frame, sending only the runs that changed. A
+// full frame goes out when the ESP's LEDs are unknown, or when it reports
+// that updates were lost or came too late.
+export const sendLedUpdate = async (frame) => {
+  if (!ESP_CONFIG.enabled) return;
+  
+  if (!shownFrame) return sendLedFrame(frame);
+  const runs = buildLedRuns(frame, shownFrame);
+  if (runs.length === 0) return;
+  shownFrame = frame.slice();
+  latestFrame = shownFrame;
+  
+  deltaSequence = (deltaSequence + 1) & 0xFFFF;
+  const body = new Uint8Array(2 + runs.length);
+  body[0] = deltaSequence & 0xFF;
+  body[1] = deltaSequence >> 8;
+  body.set(runs, 2);
+  
+  try {
+    const url = `http://${ESP_CONFIG.ipAddress}:${ESP_CONFIG.port}${ESP_CONFIG.deltaEndpoint}`;
+    
+    const response = await fetch(url, {
+      method: 'POST',
+      headers: {
+        'Content-Type': 'application/octet-stream',
+      },
+      body,
+    });
+    
+    const result = response.ok ? await response.json() : null;
+    if (!result || result.resync) {
+      return sendLedFrame(latestFrame);
+    }
+    return result;
+  } catch (error) {
+    console.error('Failed to send LED update:', error);
+    shownFrame = null;
+  }
+};
+
+// Play an effect on one grid cell; the ESP renders it ('pulse', 'growth',
+// 'rainbow' or 'stop'). param: pulses, or rainbow frames
+export const sendCellEffect = async (row, col, effect, color, param = 0) => {
+  if (!ESP_CONFIG.enabled) return;
+  
+  try {
+    const url = `http://${ESP_CONFIG.ipAddress}:${ESP_CONFIG.port}${ESP_CONFIG.effectEndpoint}`;
+    
+    const response = await fetch(url, {
+      method: 'POST',
+      headers: {
+        'Content-Type': 'application/json',
+      },
+      body: JSON.stringify({ row, col, effect, color, param }),
+    });
+    
+    if (!response.ok) {
+      console.error('Error starting LED effect:', await response.text());
+    }
+    
+    return await response.json();
+  } catch (error) {
+    console.error('Failed to start LED effect:', error);
+  }
+};
+
 // Clear all LEDs
 export const clearAllLeds = async () => {
   if (!ESP_CONFIG.enabled) return;
   
+  shownFrame = new Uint8Array(ESP_CONFIG.numLeds * 3);
+  latestFrame = shownFrame;
+  
   try {
     const url = `http://${ESP_CONFIG.ipAddress}:${ESP_CONFIG.port}/api/clear`;
     